@@ -0,0 +1,169 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence benchmarks: Rate of accepted connections, one accept per wake-up vs batched accepts.
+ * A number of client threads connect to the server over TCP loopback as fast as they can,
+ * while a single thread runs the server loop that accepts and drops the connections.
+ * The `single` row is the one accept per wake-up path AsyncServer took before batched accepts,
+ * so one run reports the connection rate before and after: compare it with the row of the server's batch size (64).
+ * No reference figures are recorded here: rates depend on the machine and kernel, so run it on the target host.
+ * Usage: make benchmarks && ./accept_rate --clients 8 --duration 1000
+ * Note: short runs are advised as each connection leaves a socket in TIME_WAIT state behind.
+ *******************************************************************************/
+#include <cadence/async/acceptor.hpp>
+#include <cadence/async/streamsocket.hpp>
+#include <cadence/version.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include <clime/parser.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+void acceptOneByOne(Acceptor& acceptor, std::atomic<uint64>& accepted) {
+    acceptor.asyncAccept()
+            .then([&acceptor, &accepted](StreamSocket&&) {
+                accepted.fetch_add(1, std::memory_order_relaxed);
+
+                if (acceptor.isOpen()) {
+                    acceptOneByOne(acceptor, accepted);
+                }
+            });
+}
+
+
+void acceptBatches(Acceptor& acceptor, uint32 batchSize, std::atomic<uint64>& accepted) {
+    acceptor.asyncAcceptBatch(batchSize)
+            .then([&acceptor, batchSize, &accepted](std::vector<StreamSocket>&& sockets) {
+                accepted.fetch_add(sockets.size(), std::memory_order_relaxed);
+
+                if (acceptor.isOpen()) {
+                    acceptBatches(acceptor, batchSize, accepted);
+                }
+            });
+}
+
+
+/**
+ * Measure number of connections accepted per second.
+ * @param batchSize Maximum number of connections accepted per wake-up, 0 to accept connections one by one.
+ */
+double measureAcceptsPerSec(uint32 batchSize, uint32 nbClients, uint32 durationMs) {
+    std::atomic<uint64> accepted{0};
+    std::atomic<bool> running{true};
+
+    EventLoop loop;
+    Acceptor acceptor(loop);
+    ListenOptions options;
+    options.backlog = 4096;
+
+    auto openResult = acceptor.open(IPEndpoint{IPAddress::loopback(), 0}, options);
+    if (!openResult) {
+        std::cerr << "Failed to start server: " << openResult.getError().toString() << std::endl;
+        return 0;
+    }
+
+    if (batchSize == 0) {
+        acceptOneByOne(acceptor, accepted);
+    } else {
+        acceptBatches(acceptor, batchSize, accepted);
+    }
+
+    auto const serverEndpoint = acceptor.getLocalEndpoint();
+    std::vector<std::thread> clients;
+    for (uint32 i = 0; i < nbClients; ++i) {
+        clients.emplace_back([&serverEndpoint, &running]() {
+            EventLoop clientLoop;
+            while (running.load(std::memory_order_relaxed)) {
+                auto socket = createTCPSocket(clientLoop);
+                if (!socket.connect(serverEndpoint)) {
+                    break;
+                }
+
+                socket.close();
+            }
+        });
+    }
+
+    auto const startedAt = std::chrono::steady_clock::now();
+    loop.runFor(static_cast<int>(durationMs));
+    auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt);
+
+    running.store(false);
+    acceptor.close();
+    loop.stop();
+
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    return static_cast<double>(accepted.load()) / elapsed.count();
+}
+
+
+int main(int argc, const char **argv) {
+    uint32 nbClients = std::max(2U, std::thread::hardware_concurrency()) - 1;
+    uint32 maxBatchSize = 64;
+    uint32 durationMs = 1000;
+
+    auto res = clime::Parser("libcadence/accept_rate", {
+                            clime::Parser::printHelp(),
+                            clime::Parser::printVersion("accept_rate", cadence::getBuildVersion()),
+
+                            {{"c", "clients"}, "Number of client threads connecting concurrently", &nbClients},
+                            {{"b", "batch"}, "Maximum number of connections accepted per wake-up", &maxBatchSize},
+                            {{"d", "duration"}, "Duration of each run in milliseconds", &durationMs}
+                           })
+            .parse(argc, argv);
+
+    if (!res) {
+        auto const& e = res.getError();
+
+        if (e) {
+            std::cerr << "Error: " <<  e << std::endl;
+
+            return EXIT_FAILURE;
+        } else {
+            std::cerr << e << std::endl;
+
+            return EXIT_SUCCESS;
+        }
+    }
+
+    std::cout << "batch\taccepts/sec\tspeedup" << std::endl;
+
+    auto const baseline = measureAcceptsPerSec(0, nbClients, durationMs);
+    std::cout << "single\t"
+              << std::fixed << std::setprecision(0) << baseline << '\t'
+              << std::setprecision(2) << 1.0 << 'x'
+              << std::endl;
+
+    for (uint32 batchSize = 1; batchSize <= maxBatchSize; batchSize *= 4) {
+        auto const rate = measureAcceptsPerSec(batchSize, nbClients, durationMs);
+
+        std::cout << batchSize << '\t'
+                  << std::fixed << std::setprecision(0) << rate << '\t'
+                  << std::setprecision(2) << (baseline > 0 ? rate / baseline : 0) << 'x'
+                  << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
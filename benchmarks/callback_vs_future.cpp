@@ -0,0 +1,169 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence benchmarks: Throughput of future based vs callback based async operations.
+ * A single event loop writes a small message into a pipe and reads it back, round after round,
+ * either resolving a future per operation or invoking a callback.
+ *******************************************************************************/
+#include <cadence/async/pipe.hpp>
+#include <cadence/version.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include <clime/parser.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+/**
+ * Write a message into a pipe and read it back, for a given number of rounds.
+ */
+class RoundTrip {
+public:
+
+    RoundTrip(Pipe& pipe, uint32 messageSize)
+        : _pipe(pipe)
+        , _outBuffer(messageSize, 'x')
+        , _inBuffer(messageSize)
+    {}
+
+    /** Perform rounds resolving a future for every read and write. */
+    void withFutures(uint32 nbRounds) {
+        if (nbRounds == 0) {
+            return;
+        }
+
+        rewind();
+        _pipe.asyncWrite(_writer)
+                .onError([this](Error&& e) { fail("Write", e); });
+
+        _pipe.asyncRead(_reader)
+                .then([this, nbRounds]() {
+                    withFutures(nbRounds - 1);
+                })
+                .onError([this](Error&& e) { fail("Read", e); });
+    }
+
+    /** Perform rounds invoking a callback for every read and write. */
+    void withCallbacks(uint32 nbRounds) {
+        if (nbRounds == 0) {
+            return;
+        }
+
+        rewind();
+        _pipe.asyncWrite(_writer, _writer.remaining(), [this](Result<void, Error>&& result) {
+            if (!result) {
+                fail("Write", result.getError());
+            }
+        });
+
+        _pipe.asyncRead(_reader, _reader.remaining(), [this, nbRounds](Result<void, Error>&& result) {
+            if (!result) {
+                fail("Read", result.getError());
+                return;
+            }
+
+            withCallbacks(nbRounds - 1);
+        });
+    }
+
+    bool failed() const noexcept { return _failed; }
+
+private:
+
+    void rewind() {
+        _writer = ByteReader(wrapMemory(_outBuffer.data(), _outBuffer.size()));
+        _reader = ByteWriter(wrapMemory(_inBuffer.data(), _inBuffer.size()));
+    }
+
+    void fail(char const* operation, Error const& e) {
+        std::cerr << operation << " failed: " << e.toString() << std::endl;
+        _failed = true;
+    }
+
+private:
+    Pipe&               _pipe;
+    std::vector<byte>   _outBuffer;
+    std::vector<byte>   _inBuffer;
+    ByteReader          _writer;
+    ByteWriter          _reader;
+    bool                _failed{false};
+};
+
+
+/**
+ * Run the given number of rounds using the given style.
+ * @return Number of async operations completed per second.
+ */
+template<typename Start>
+double measure(uint32 nbRounds, uint32 messageSize, Start&& start) {
+    EventLoop loop;
+    Pipe pipe(loop);
+    RoundTrip roundTrip(pipe, messageSize);
+
+    auto const startedAt = std::chrono::steady_clock::now();
+    start(roundTrip, nbRounds);
+    loop.run();
+    auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt);
+
+    if (roundTrip.failed()) {
+        return 0;
+    }
+
+    // Each round is a write and a read
+    return (2.0 * nbRounds) / elapsed.count();
+}
+
+
+int main(int argc, const char **argv) {
+    uint32 nbRounds = 1000000;
+    uint32 messageSize = 64;
+
+    auto res = clime::Parser("libcadence/callback_vs_future", {
+                            clime::Parser::printHelp(),
+                            clime::Parser::printVersion("callback_vs_future", cadence::getBuildVersion()),
+
+                            {{"n", "count"}, "Number of write / read rounds for each run", &nbRounds},
+                            {{"s", "size"}, "Size of a message in bytes", &messageSize}
+                           })
+            .parse(argc, argv);
+
+    if (!res) {
+        auto const& e = res.getError();
+
+        if (e) {
+            std::cerr << "Error: " <<  e << std::endl;
+
+            return EXIT_FAILURE;
+        } else {
+            std::cerr << e << std::endl;
+
+            return EXIT_SUCCESS;
+        }
+    }
+
+    auto const futureOps = measure(nbRounds, messageSize, [](RoundTrip& r, uint32 n) { r.withFutures(n); });
+    auto const callbackOps = measure(nbRounds, messageSize, [](RoundTrip& r, uint32 n) { r.withCallbacks(n); });
+
+    std::cout << "style\tops/sec" << std::endl;
+    std::cout << "future\t" << static_cast<uint64>(futureOps) << std::endl;
+    std::cout << "callback\t" << static_cast<uint64>(callbackOps) << std::endl;
+    if (futureOps > 0) {
+        std::cout << "speedup\t" << (callbackOps / futureOps) << 'x' << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
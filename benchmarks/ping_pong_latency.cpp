@@ -0,0 +1,264 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence benchmarks: Ping-pong round-trip latency of blocking vs busy-polling event loop.
+ * Two event loops, each run by its own thread, bounce a small message back and forth
+ * over a pair of pipes or a TCP loopback connection.
+ * Note: busy-polling only pays off when each loop has a core to itself.
+ *******************************************************************************/
+#include <cadence/async/acceptor.hpp>
+#include <cadence/async/eventLoopStats.hpp>
+#include <cadence/async/pipe.hpp>
+#include <cadence/async/streamsocket.hpp>
+#include <cadence/version.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include <clime/parser.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+/**
+ * One side of a ping-pong: reads a message from one channel and writes a response into another.
+ * Writes are tiny and performed synchronously so that only the read wake-up latency is measured.
+ */
+class Player {
+public:
+
+    Player(Channel& in, Channel& out, uint32 messageSize)
+        : _in(in)
+        , _out(out)
+        , _outBuffer(messageSize, 'x')
+        , _inBuffer(messageSize)
+    {}
+
+    /** Keep responding to every message received. */
+    void pong() {
+        receive([this]() {
+            send();
+            pong();
+        });
+    }
+
+    /** Send a message and measure time until the response is received, for a given number of round-trips. */
+    void ping(uint32 nbRoundTrips, DurationHistogram::Buckets& latencies, EventLoop& peerLoop) {
+        if (nbRoundTrips == 0) {
+            _in.getIOContext().stop();
+            peerLoop.stop();
+            return;
+        }
+
+        auto const sentAt = std::chrono::steady_clock::now();
+        send();
+        receive([this, sentAt, nbRoundTrips, &latencies, &peerLoop]() {
+            auto const rtt = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - sentAt);
+
+            latencies[DurationHistogram::bucketIndex(rtt)] += 1;
+            _total += rtt;
+            _max = std::max(_max, rtt);
+
+            ping(nbRoundTrips - 1, latencies, peerLoop);
+        });
+    }
+
+    std::chrono::microseconds total() const noexcept { return _total; }
+    std::chrono::microseconds max() const noexcept { return _max; }
+
+private:
+
+    template<typename F>
+    void receive(F&& onReceived) {
+        _reader = ByteWriter(wrapMemory(_inBuffer.data(), _inBuffer.size()));
+        _in.asyncRead(_reader)
+                .then(std::forward<F>(onReceived))
+                .onError([](Error&& e) {
+                    std::cerr << "Read failed: " << e.toString() << std::endl;
+                });
+    }
+
+    void send() {
+        auto message = ByteReader(wrapMemory(_outBuffer.data(), _outBuffer.size()));
+        _out.write(message)
+                .orElse([](Error&& e) {
+                    std::cerr << "Write failed: " << e.toString() << std::endl;
+                });
+    }
+
+private:
+    Channel&                    _in;
+    Channel&                    _out;
+    std::vector<byte>           _outBuffer;
+    std::vector<byte>           _inBuffer;
+    ByteWriter                  _reader;
+
+    std::chrono::microseconds   _total{0};
+    std::chrono::microseconds   _max{0};
+};
+
+
+struct RunResult {
+    DurationHistogram   latency;
+    BusyPollStats       pingerStats;
+};
+
+
+BusyPollStats runLoop(EventLoop& loop, bool busyPoll, BusyPollOptions const& options) {
+    if (busyPoll) {
+        return loop.runBusyPoll(options);
+    }
+
+    loop.run();
+    return {};
+}
+
+
+/**
+ * Play ping-pong between `pingLoop` and `pongLoop` using the given channels.
+ */
+RunResult playPingPong(EventLoop& pingLoop, Channel& pingIn, Channel& pingOut,
+                       EventLoop& pongLoop, Channel& pongIn, Channel& pongOut,
+                       uint32 nbRoundTrips, uint32 messageSize,
+                       bool busyPoll, BusyPollOptions const& options) {
+    Player pinger(pingIn, pingOut, messageSize);
+    Player ponger(pongIn, pongOut, messageSize);
+
+    DurationHistogram::Buckets latencies{};
+    ponger.pong();
+    pinger.ping(nbRoundTrips, latencies, pongLoop);
+
+    std::thread pongThread([&]() { runLoop(pongLoop, busyPoll, options); });
+    auto const pingerStats = runLoop(pingLoop, busyPoll, options);
+    pongThread.join();
+
+    return {DurationHistogram{latencies, pinger.total(), pinger.max()}, pingerStats};
+}
+
+
+RunResult measurePipe(uint32 nbRoundTrips, uint32 messageSize, bool busyPoll, BusyPollOptions const& options) {
+    EventLoop pingLoop;
+    EventLoop pongLoop;
+
+    // Each side reads from a pipe bound to its own loop and writes into the pipe of the other side
+    Pipe pingPipe(pingLoop);
+    Pipe pongPipe(pongLoop);
+
+    return playPingPong(pingLoop, pingPipe, pongPipe,
+                        pongLoop, pongPipe, pingPipe,
+                        nbRoundTrips, messageSize, busyPoll, options);
+}
+
+
+RunResult measureTcp(uint32 nbRoundTrips, uint32 messageSize, bool busyPoll, BusyPollOptions const& options) {
+    EventLoop pingLoop;
+    EventLoop pongLoop;
+
+    Acceptor acceptor(pongLoop);
+    auto openResult = acceptor.open(IPEndpoint{IPAddress::loopback(), 0});
+    if (!openResult) {
+        std::cerr << "Failed to start server: " << openResult.getError().toString() << std::endl;
+        return {};
+    }
+
+    auto client = createTCPSocket(pingLoop);
+    auto connectResult = client.connect(acceptor.getLocalEndpoint());
+    if (!connectResult) {
+        std::cerr << "Failed to connect: " << connectResult.getError().toString() << std::endl;
+        return {};
+    }
+
+    auto acceptResult = acceptor.accept();
+    if (!acceptResult) {
+        std::cerr << "Failed to accept: " << acceptResult.getError().toString() << std::endl;
+        return {};
+    }
+
+    auto server = std::move(acceptResult.unwrap());
+
+    return playPingPong(pingLoop, client, client,
+                        pongLoop, server, server,
+                        nbRoundTrips, messageSize, busyPoll, options);
+}
+
+
+void report(char const* transport, char const* mode, RunResult const& result) {
+    auto const& latency = result.latency;
+    auto const& stats = result.pingerStats;
+
+    std::cout << transport << '\t' << mode << '\t'
+              << latency.mean().count() << '\t'
+              << latency.percentile(0.5).count() << '\t'
+              << latency.percentile(0.99).count() << '\t'
+              << latency.max().count() << '\t'
+              << stats.spinCycles << '\t'
+              << stats.sleepCycles << '\t'
+              << stats.handlersSpinning << '/' << stats.handlersSleeping
+              << std::endl;
+}
+
+
+int main(int argc, const char **argv) {
+    uint32 nbRoundTrips = 100000;
+    uint32 messageSize = 64;
+    uint32 spinBudgetUs = 50;
+    uint32 maxSleepMs = 10;
+
+    auto res = clime::Parser("libcadence/ping_pong_latency", {
+                            clime::Parser::printHelp(),
+                            clime::Parser::printVersion("ping_pong_latency", cadence::getBuildVersion()),
+
+                            {{"n", "count"}, "Number of round-trips for each run", &nbRoundTrips},
+                            {{"s", "size"}, "Size of a message in bytes", &messageSize},
+                            {{"b", "spin"}, "Busy-poll spin budget in microseconds", &spinBudgetUs},
+                            {{"w", "sleep"}, "Busy-poll maximum sleep in milliseconds", &maxSleepMs}
+                           })
+            .parse(argc, argv);
+
+    if (!res) {
+        auto const& e = res.getError();
+
+        if (e) {
+            std::cerr << "Error: " <<  e << std::endl;
+
+            return EXIT_FAILURE;
+        } else {
+            std::cerr << e << std::endl;
+
+            return EXIT_SUCCESS;
+        }
+    }
+
+    if (std::thread::hardware_concurrency() < 2) {
+        std::cerr << "Warning: less than 2 cores available, busy-polling loops will compete for CPU" << std::endl;
+    }
+
+    BusyPollOptions options;
+    options.spinBudget = std::chrono::microseconds(spinBudgetUs);
+    options.maxSleep = std::chrono::milliseconds(maxSleepMs);
+
+    std::cout << "transport\tmode\tmean(us)\tp50(us)\tp99(us)\tmax(us)\tspins\tsleeps\thandlers(spin/sleep)"
+              << std::endl;
+
+    report("pipe", "blocking", measurePipe(nbRoundTrips, messageSize, false, options));
+    report("pipe", "busy-poll", measurePipe(nbRoundTrips, messageSize, true, options));
+    report("tcp", "blocking", measureTcp(nbRoundTrips, messageSize, false, options));
+    report("tcp", "busy-poll", measureTcp(nbRoundTrips, messageSize, true, options));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence benchmarks: TCP echo round-trip throughput vs number of event loop threads.
+ * Each run starts an echo server and a number of clients on the same event loop,
+ * and counts completed round-trips while the loop is driven by 1..N threads.
+ *******************************************************************************/
+#include <cadence/async/acceptor.hpp>
+#include <cadence/async/streamsocket.hpp>
+#include <cadence/version.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include <clime/parser.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+class EchoSession
+        : public std::enable_shared_from_this<EchoSession> {
+public:
+
+    EchoSession(StreamSocket&& socket, uint32 messageSize)
+        : _socket(std::move(socket))
+        , _buffer(messageSize)
+    {}
+
+    void doRead() {
+        _writer = ByteWriter(wrapMemory(_buffer.data(), _buffer.size()));
+        _socket.asyncRead(_writer)
+                .then([self = shared_from_this()]() {
+                    self->doWrite();
+                });
+    }
+
+    void doWrite() {
+        _reader = ByteReader(_writer.viewWritten());
+        _socket.asyncWrite(_reader)
+                .then([self = shared_from_this()]() {
+                    self->doRead();
+                });
+    }
+
+private:
+    StreamSocket        _socket;
+    std::vector<byte>   _buffer;
+    ByteWriter          _writer;
+    ByteReader          _reader;
+};
+
+
+class EchoClient
+        : public std::enable_shared_from_this<EchoClient> {
+public:
+
+    EchoClient(EventLoop& loop, uint32 messageSize, std::atomic<uint64>& roundTrips, std::atomic<bool>& running)
+        : _socket(createTCPSocket(loop))
+        , _outBuffer(messageSize, 'x')
+        , _inBuffer(messageSize)
+        , _roundTrips(roundTrips)
+        , _running(running)
+    {}
+
+    void start(NetworkEndpoint const& serverEndpoint) {
+        _socket.asyncConnect(serverEndpoint)
+                .then([self = shared_from_this()]() {
+                    self->doWrite();
+                })
+                .onError([](Error&& e) {
+                    std::cerr << "Failed to connect: " << e.toString() << std::endl;
+                });
+    }
+
+    void doWrite() {
+        _reader = ByteReader(wrapMemory(_outBuffer.data(), _outBuffer.size()));
+        _socket.asyncWrite(_reader)
+                .then([self = shared_from_this()]() {
+                    self->doRead();
+                });
+    }
+
+    void doRead() {
+        _writer = ByteWriter(wrapMemory(_inBuffer.data(), _inBuffer.size()));
+        _socket.asyncRead(_writer)
+                .then([self = shared_from_this()]() {
+                    self->_roundTrips.fetch_add(1, std::memory_order_relaxed);
+
+                    if (self->_running.load(std::memory_order_relaxed)) {
+                        self->doWrite();
+                    }
+                });
+    }
+
+private:
+    StreamSocket            _socket;
+    std::vector<byte>       _outBuffer;
+    std::vector<byte>       _inBuffer;
+    ByteReader              _reader;
+    ByteWriter              _writer;
+
+    std::atomic<uint64>&    _roundTrips;
+    std::atomic<bool>&      _running;
+};
+
+
+void acceptSessions(Acceptor& acceptor, uint32 messageSize) {
+    acceptor.asyncAccept()
+            .then([&acceptor, messageSize](StreamSocket&& socket) {
+                std::make_shared<EchoSession>(std::move(socket), messageSize)->doRead();
+
+                if (acceptor.isOpen()) {
+                    acceptSessions(acceptor, messageSize);
+                }
+            });
+}
+
+
+double measureRoundTripsPerSec(uint32 nbThreads, uint32 nbConnections, uint32 messageSize, uint32 durationMs) {
+    std::atomic<uint64> roundTrips{0};
+    std::atomic<bool> running{true};
+
+    EventLoop loop;
+    Acceptor acceptor(loop);
+    auto openResult = acceptor.open(IPEndpoint{IPAddress::loopback(), 0});
+    if (!openResult) {
+        std::cerr << "Failed to start server: " << openResult.getError().toString() << std::endl;
+        return 0;
+    }
+
+    acceptSessions(acceptor, messageSize);
+
+    auto const serverEndpoint = acceptor.getLocalEndpoint();
+    for (uint32 i = 0; i < nbConnections; ++i) {
+        std::make_shared<EchoClient>(loop, messageSize, roundTrips, running)->start(serverEndpoint);
+    }
+
+    auto const startedAt = std::chrono::steady_clock::now();
+    loop.runFor(nbThreads, static_cast<int>(durationMs));
+    auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt);
+
+    running.store(false);
+    acceptor.close();
+    loop.stop();
+
+    return static_cast<double>(roundTrips.load()) / elapsed.count();
+}
+
+
+int main(int argc, const char **argv) {
+    uint32 maxThreads = std::max(1U, std::thread::hardware_concurrency());
+    uint32 nbConnections = 64;
+    uint32 messageSize = 64;
+    uint32 durationMs = 2000;
+
+    auto res = clime::Parser("libcadence/tcp_echo_throughput", {
+                            clime::Parser::printHelp(),
+                            clime::Parser::printVersion("tcp_echo_throughput", cadence::getBuildVersion()),
+
+                            {{"t", "threads"}, "Maximum number of threads to run event loop with", &maxThreads},
+                            {{"c", "connections"}, "Number of concurrent client connections", &nbConnections},
+                            {{"s", "size"}, "Size of echo message in bytes", &messageSize},
+                            {{"d", "duration"}, "Duration of each run in milliseconds", &durationMs}
+                           })
+            .parse(argc, argv);
+
+    if (!res) {
+        auto const& e = res.getError();
+
+        if (e) {
+            std::cerr << "Error: " <<  e << std::endl;
+
+            return EXIT_FAILURE;
+        } else {
+            std::cerr << e << std::endl;
+
+            return EXIT_SUCCESS;
+        }
+    }
+
+    std::cout << "threads\tround-trips/sec\tscaling" << std::endl;
+
+    double baseline = 0;
+    for (uint32 nbThreads = 1; nbThreads <= maxThreads; ++nbThreads) {
+        auto const rate = measureRoundTripsPerSec(nbThreads, nbConnections, messageSize, durationMs);
+        if (nbThreads == 1) {
+            baseline = rate;
+        }
+
+        std::cout << nbThreads << '\t'
+                  << std::fixed << std::setprecision(0) << rate << '\t'
+                  << std::setprecision(2) << (baseline > 0 ? rate / baseline : 0) << 'x'
+                  << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -19,6 +19,7 @@
 
 #include <clime/parser.hpp>
 
+#include <chrono>
 #include <iostream>
 #include <csignal>
 
@@ -48,9 +49,10 @@ public:
         --NbSessions;
     }
 
-    Session(async::StreamSocket&& c)
+    Session(async::StreamSocket&& c, AsyncServer::SessionTicket&& t)
         : channel(std::move(c))
         , remoteEndpoint(channel.getRemoteEndpoint())
+        , ticket(std::move(t))
     {
         ++NbSessions;
     }
@@ -62,6 +64,7 @@ public:
         , outBuffer{}
         , reader{wrapMemory(outBuffer)}
         , writer{wrapMemory(inBuffer)}
+        , ticket(std::move(rhs.ticket))
     {
         std::cout << "Moving Session" << NbSessions << std::endl;
         ++NbSessions;
@@ -69,7 +72,8 @@ public:
 
 
     void doRead() {
-        if (channel.isClosed() || channel.getIOContext().isStopped()) {
+        // Server is shutting down: close the session between requests
+        if (channel.isClosed() || channel.getIOContext().isStopped() || ticket.isDraining()) {
             return;
         }
 
@@ -106,13 +110,16 @@ private:
     byte outBuffer[21];
     ByteReader reader{wrapMemory(outBuffer)};
     ByteWriter writer{wrapMemory(inBuffer)};
+
+    // Declared last to be released before the channel is closed
+    AsyncServer::SessionTicket ticket;
 };
 
 
-void onNewConnection(async::StreamSocket&& channel) {
+void onNewConnection(async::StreamSocket&& channel, AsyncServer::SessionTicket&& ticket) {
     std::cout << "New connection from " << channel.getRemoteEndpoint() << std::endl;
 
-    auto session = std::make_shared<Session>(std::move(channel));
+    auto session = std::make_shared<Session>(std::move(channel), std::move(ticket));
     session->doRead();
 }
 
@@ -167,11 +174,15 @@ int main(int argc, const char **argv) {
     auto sigs = SignalSet{loop, {SIGINT, SIGTERM}};
     sigs.asyncWait()
         .then([&server, &loop](int sig) {
-            std::cout << "Signal: " << sig << ", stopping server" << std::endl;
-            server.stop();
-            loop.stop();
-
-            std::cout << "Dangling sessions: " << Session::NbSessions << std::endl;
+            std::cout << "Signal: " << sig << ", draining server" << std::endl;
+
+            // Let sessions finish requests in progress, cancel the rest after a grace period
+            server.drain(async::deadlineAfter(std::chrono::seconds(5)))
+                .then([&server, &loop]() {
+                    auto const counters = server.getSessionCounters();
+                    std::cout << "Sessions served: " << counters.accepted << std::endl;
+                    loop.stop();
+                });
         });
 
     // Run event loop
@@ -16,13 +16,59 @@
 
 #include "cadence/networkEndpoint.hpp"
 #include "cadence/async/streamsocket.hpp"
+#include "cadence/async/socketOptions.hpp"
 
 #include <solace/result.hpp>
 #include <solace/future.hpp>
 
+#include <optional>
+#include <vector>
+
 
 namespace cadence { namespace async {
 
+/**
+ * Completion record of an async accept operation.
+ * On success the newly accepted connection is stored in the record.
+ */
+class AcceptCompletion :
+        public AsyncCompletion {
+public:
+    using AsyncCompletion::AsyncCompletion;
+
+    /// Newly accepted connection, set if operation was successful.
+    std::optional<StreamSocket> socket;
+};
+
+
+/**
+ * Completion record of an async accept of a batch of connections.
+ * On success the connections accepted are stored in the record and the value of the record is their number.
+ */
+class AcceptBatchCompletion :
+        public AsyncCompletion {
+public:
+    using AsyncCompletion::AsyncCompletion;
+
+    /// Newly accepted connections, replaced by each operation.
+    std::vector<StreamSocket> sockets;
+};
+
+
+/**
+ * Options of a listening socket.
+ */
+struct ListenOptions {
+    /// Maximum length of the queue of connections not yet accepted. Zero selects the system maximum.
+    /// Note: the kernel caps the backlog by net.core.somaxconn.
+    Solace::int32   backlog{0};
+
+    /// Allow multiple acceptors to bind the same TCP endpoint (SO_REUSEPORT).
+    /// The kernel balances incoming connections between all the acceptors bound to the endpoint.
+    bool            reusePort{false};
+};
+
+
 /**
  * Acceptor class for stream-oriented sockets.
  * The class of NetworkAddress used to open the acceptor determines which actual acceptor will be used.
@@ -30,6 +76,8 @@ namespace cadence { namespace async {
 class Acceptor {
 public:
 
+    using size_type = std::size_t;
+
     ~Acceptor() = default;
 
     Acceptor(EventLoop& loop);
@@ -55,6 +103,15 @@ public:
     Solace::Result<void, Solace::Error>
     open(NetworkEndpoint const& endpoint);
 
+    /**
+     * Open the acceptor on the given end-point with the given options and start listenning for incomming connections.
+     * @param endpoint Local endpoint to bind to.
+     * @param options Options of the listening socket.
+     * @return Result of the binding / listenning operation.
+     */
+    Solace::Result<void, Solace::Error>
+    open(NetworkEndpoint const& endpoint, ListenOptions const& options);
+
     /**
      * Determine whether the acceptor is open.
      * @return True is the acceptor is opened and accepts connections.
@@ -86,6 +143,93 @@ public:
     Solace::Future<StreamSocket>
     asyncAccept();
 
+    /** Start an asynchronous accept of a connection to be served by the given event loop.
+     * This function is used to distribute new connections between loops of an EventLoopGroup.
+     * @param sessionLoop Event loop the newly accepted socket will be bound to.
+     * @return Future of the newly accepted socket or an error.
+     */
+    Solace::Future<StreamSocket>
+    asyncAccept(EventLoop& sessionLoop);
+
+    /** Start an asynchronous accept reporting the outcome into the caller owned completion record.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    void asyncAccept(AcceptCompletion& completion);
+
+    /** Start an asynchronous accept of a connection to be served by the given event loop,
+     * reporting the outcome into the caller owned completion record.
+     * @param sessionLoop Event loop the newly accepted socket will be bound to.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    void asyncAccept(EventLoop& sessionLoop, AcceptCompletion& completion);
+
+    /** Start an asynchronous accept that must complete by the given deadline.
+     * If no connection has been accepted by then, only this accept is cancelled and it fails with ETIMEDOUT.
+     * @param deadline Point in time by which a connection must be accepted.
+     * @return Future of the newly accepted socket or an error.
+     */
+    Solace::Future<StreamSocket>
+    asyncAccept(Deadline deadline);
+
+    /** Start an asynchronous accept of a connection to be served by the given event loop, with a deadline.
+     * @see asyncAccept(Deadline)
+     * @param sessionLoop Event loop the newly accepted socket will be bound to.
+     * @param deadline Point in time by which a connection must be accepted.
+     * @return Future of the newly accepted socket or an error.
+     */
+    Solace::Future<StreamSocket>
+    asyncAccept(EventLoop& sessionLoop, Deadline deadline);
+
+    /** Start an asynchronous accept with a deadline reporting the outcome into the caller owned completion record.
+     * @see asyncAccept(Deadline)
+     * @param deadline Point in time by which a connection must be accepted.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    void asyncAccept(Deadline deadline, AcceptCompletion& completion);
+
+    /** Start an asynchronous accept of a connection to be served by the given event loop, with a deadline,
+     * reporting the outcome into the caller owned completion record.
+     * @see asyncAccept(Deadline)
+     * @param sessionLoop Event loop the newly accepted socket will be bound to.
+     * @param deadline Point in time by which a connection must be accepted.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    void asyncAccept(EventLoop& sessionLoop, Deadline deadline, AcceptCompletion& completion);
+
+    /** Start an asynchronous accept of a batch of connections.
+     * Once the acceptor becomes ready, all the connections pending in the listen queue are accepted in one go,
+     * up to the given batch size, instead of one connection per readiness notification.
+     * @param maxBatchSize Maximum number of connections to accept. Zero is treated as one.
+     * @return Future of the newly accepted sockets or an error.
+     */
+    Solace::Future<std::vector<StreamSocket>>
+    asyncAcceptBatch(size_type maxBatchSize);
+
+    /** Start an asynchronous accept of a batch of connections to be served by loops of the given group.
+     * @see asyncAcceptBatch(size_type)
+     * @param sessionLoops Group of event loops to bind the newly accepted sockets to, one loop per socket in turn.
+     * @param maxBatchSize Maximum number of connections to accept.
+     * @return Future of the newly accepted sockets or an error.
+     */
+    Solace::Future<std::vector<StreamSocket>>
+    asyncAcceptBatch(EventLoopGroup& sessionLoops, size_type maxBatchSize);
+
+    /** Start an asynchronous accept of a batch of connections reporting the outcome into the caller owned record.
+     * @see asyncAcceptBatch(size_type)
+     * @param maxBatchSize Maximum number of connections to accept.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    void asyncAcceptBatch(size_type maxBatchSize, AcceptBatchCompletion& completion);
+
+    /** Start an asynchronous accept of a batch of connections to be served by loops of the given group,
+     * reporting the outcome into the caller owned record.
+     * @see asyncAcceptBatch(size_type)
+     * @param sessionLoops Group of event loops to bind the newly accepted sockets to, one loop per socket in turn.
+     * @param maxBatchSize Maximum number of connections to accept.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    void asyncAcceptBatch(EventLoopGroup& sessionLoops, size_type maxBatchSize, AcceptBatchCompletion& completion);
+
     /**
      * Gets the non-blocking mode of the acceptor.
      * @return True if acceptor is in non blocking mode.
@@ -119,6 +263,35 @@ public:
      */
     NetworkEndpoint getLocalEndpoint() const;
 
+    /**
+     * Set value of a socket option.
+     * @param option Option to set.
+     * @param value New value of the option.
+     * @return Result of the operation. Options not applicable to the socket protocol fail with an error.
+     * @note Options are set on the listening socket and, on Linux, inherited by accepted sockets.
+     * The acceptor must be open.
+     */
+    Solace::Result<void, Solace::Error> setOption(SocketOptionName option, Solace::int32 value);
+
+    /**
+     * Get value of a socket option.
+     * @param option Option to get.
+     * @return Current value of the option or an error.
+     */
+    Solace::Result<Solace::int32, Solace::Error> getOption(SocketOptionName option);
+
+    /** Set value of a typed socket option, i.e. `setOption(NoDelay{}, true)`. */
+    template<typename Option>
+    Solace::Result<void, Solace::Error> setOption(Option, typename Option::value_type value) {
+        return setOption(Option::name, static_cast<Solace::int32>(value));
+    }
+
+    /** Get value of a typed socket option, i.e. `getOption(ReceiveBufferSize{})`. */
+    template<typename Option>
+    Solace::Result<typename Option::value_type, Solace::Error> getOption(Option) {
+        return toOptionValue<Option>(getOption(Option::name));
+    }
+
 public:
 
     class AcceptorImpl {
@@ -128,7 +301,7 @@ public:
 
         /** @see Acceptor::open */
         virtual Solace::Result<void, Solace::Error>
-        open(NetworkEndpoint const& endpoint) = 0;
+        open(NetworkEndpoint const& endpoint, ListenOptions const& options) = 0;
 
         /** @see Acceptor::isOpen */
         virtual bool isOpen() = 0;
@@ -143,7 +316,17 @@ public:
         accept() = 0;
 
         virtual Solace::Future<StreamSocket>
-        asyncAccept() = 0;
+        asyncAccept(EventLoop& sessionLoop) = 0;
+
+        virtual void
+        asyncAccept(EventLoop& sessionLoop, AcceptCompletion& completion) = 0;
+
+        virtual void
+        asyncAccept(EventLoop& sessionLoop, Deadline deadline, AcceptCompletion& completion) = 0;
+
+        /** @see Acceptor::asyncAcceptBatch. Accepted sockets are bound to the acceptor loop if no group is given. */
+        virtual void
+        asyncAcceptBatch(EventLoopGroup* sessionLoops, size_type maxBatchSize, AcceptBatchCompletion& completion) = 0;
 
         /** @see Acceptor::nonBlocking */
         virtual bool nonBlocking() = 0;
@@ -162,6 +345,14 @@ public:
 
         /** @see Acceptor::getLocalEndpoint */
         virtual NetworkEndpoint getLocalEndpoint() const = 0;
+
+        /** @see Acceptor::setOption */
+        virtual Solace::Result<void, Solace::Error>
+        setOption(SocketOptionName option, Solace::int32 value) = 0;
+
+        /** @see Acceptor::getOption */
+        virtual Solace::Result<Solace::int32, Solace::Error>
+        getOption(SocketOptionName option) = 0;
     };
 
 private:
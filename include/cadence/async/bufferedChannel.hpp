@@ -0,0 +1,160 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Buffered reading from a channel
+ *	@file		cadence/async/bufferedChannel.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_BUFFEREDCHANNEL_HPP
+#define CADENCE_ASYNC_BUFFEREDCHANNEL_HPP
+
+#include "cadence/async/channel.hpp"
+
+#include <solace/stringView.hpp>
+
+#include <memory>  // std::unique_ptr<>
+
+
+namespace cadence::async {
+
+/**
+ * Read-ahead buffer in front of a channel.
+ *
+ * Data is read from the channel with as large partial reads as the buffer allows,
+ * so that parsing a stream of small messages (i.e. lines of a text protocol) costs one system call
+ * per buffer-full rather than one per message. Buffered data is examined in place via `peek()`
+ * and released with `consume()` once processed.
+ *
+ * Consumed space at the front of the buffer is reclaimed before each refill by moving unread data
+ * to the beginning, so buffered data is always available as a single contiguous view.
+ *
+ * Only one read operation may be pending at a time. Writes are not buffered: use `getChannel()`.
+ * The object may be destroyed with a read pending: the buffer is then released once the read of the channel completes.
+ * @note The wrapped channel must outlive this object.
+ */
+class BufferedChannel {
+public:
+
+    using size_type = Channel::size_type;
+
+    static constexpr size_type kDefaultCapacity = 8 * 1024;
+
+public:
+
+    ~BufferedChannel();
+
+    BufferedChannel(BufferedChannel const&) = delete;
+    BufferedChannel& operator= (BufferedChannel const&) = delete;
+
+    /**
+     * Construct a new read-ahead buffer for the given channel.
+     * @param channel Channel to read data from.
+     * @param capacity Size of the buffer in bytes. Limits the longest message that can be found with `asyncReadUntil`.
+     */
+    explicit BufferedChannel(Channel& channel, size_type capacity = kDefaultCapacity);
+
+    Channel& getChannel() noexcept {
+        return _channel;
+    }
+
+    /** Get maximum number of bytes the buffer can hold. */
+    size_type capacity() const noexcept {
+        return _capacity;
+    }
+
+    /** Get number of bytes buffered and not yet consumed. */
+    size_type size() const noexcept {
+        return _end - _begin;
+    }
+
+    /**
+     * Get a view of the buffered data. The view is valid until the next call to `consume()` or a read operation.
+     * @return Memory view of the data read from the channel but not yet consumed.
+     */
+    Solace::MemoryView peek() const noexcept;
+
+    /**
+     * Release the given number of bytes from the front of the buffer.
+     * @param bytes Number of bytes to consume. Values greater than `size()` consume all the buffered data.
+     */
+    void consume(size_type bytes) noexcept;
+
+    /**
+     * Post an async request to have at least the given number of bytes buffered.
+     * Resolves immediately if enough data is buffered already.
+     *
+     * @param minBytes Minimum number of bytes to have in the buffer. Must not exceed capacity of the buffer.
+     * @return A future that will be resolved with the number of bytes buffered.
+     */
+    Solace::Future<size_type> asyncPeek(size_type minBytes = 1);
+
+    /**
+     * Post an async request to buffer data until it contains the given delimiter.
+     * Data stays in the buffer: examine it with `peek()` and `consume()` it once processed.
+     *
+     * @param delimiter Sequence of bytes to look for. Must stay alive until the operation completes.
+     * @return A future that will be resolved with the number of bytes up to and including the delimiter.
+     * The operation fails with ENOBUFS if the buffer is full and the delimiter is not found.
+     */
+    Solace::Future<size_type> asyncReadUntil(Solace::StringView delimiter);
+
+    /**
+     * Post an async request to read the specified amount of data into the given buffer.
+     * Buffered data is used first. Requests larger than the capacity are read directly from the channel.
+     *
+     * @param dest The provided destination buffer to read data into.
+     * @param bytesToRead Amount of data (in bytes) to read.
+     * @return A future that will be resolved once the specified number of bytes has been read.
+     */
+    Solace::Future<void> asyncRead(Solace::ByteWriter& dest, size_type bytesToRead);
+
+    /** @see asyncRead(Solace::ByteWriter&, size_type) */
+    Solace::Future<void> asyncRead(Solace::ByteWriter& dest) {
+        return asyncRead(dest, dest.remaining());
+    }
+
+private:
+
+    enum class Pending {
+        None,
+        Peek,
+        Until
+    };
+
+    /** Buffer and completion record of reads from the channel. Outlives the object destroyed with a read pending. */
+    struct RefillState;
+
+    static void onRefill(AsyncCompletion& self);
+
+    Solace::byte* buffer() const noexcept;
+
+    Solace::Future<size_type> startPending(Pending pending);
+    bool tryComplete();
+    void resume();
+    void refill();
+    void compact() noexcept;
+    void fail(Solace::Error&& error);
+
+private:
+
+    Channel&                        _channel;
+    size_type                       _capacity;
+    std::unique_ptr<RefillState>    _refill;
+    size_type                       _begin{0};
+    size_type                       _end{0};
+
+    Pending                         _pending{Pending::None};
+    size_type                       _minBytes{0};
+    Solace::StringView              _delimiter;
+    size_type                       _scanned{0};  //!< Number of buffered bytes searched for delimiter already.
+    Solace::Promise<size_type>      _promise;
+};
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_BUFFEREDCHANNEL_HPP
@@ -19,15 +19,20 @@
 
 
 #include "cadence/async/eventloop.hpp"
+#include "cadence/async/completion.hpp"
+#include "cadence/async/deadline.hpp"
 
 
 #include <solace/byteReader.hpp>
 #include <solace/byteWriter.hpp>
+#include <solace/arrayView.hpp>
 #include <solace/future.hpp>
 
 
 namespace cadence { namespace async {
 
+class Strand;
+
 
 /**
  * Channel is the base of the io objects.
@@ -38,6 +43,12 @@ public:
 
     using size_type = Solace::ByteWriter::size_type;
 
+    //!< Array of buffers to scatter data read into, filled in order.
+    using ReadBuffers = Solace::ArrayView<Solace::ByteWriter>;
+
+    //!< Array of buffers to gather data to write from, in order.
+    using WriteBuffers = Solace::ArrayView<Solace::ByteReader>;
+
 public:
 
     virtual ~Channel();
@@ -47,7 +58,9 @@ public:
 
     Channel(EventLoop& ioContext) :
         _ioContext(&ioContext)
-    {}
+    {
+        _ioContext->attachChannel();
+    }
 
     Channel(Channel&& rhs) :
         _ioContext(std::exchange(rhs._ioContext, nullptr))
@@ -115,6 +128,199 @@ public:
      */
     virtual Solace::Future<void> asyncWrite(Solace::ByteReader& src, size_type bytesToWrite) = 0;
 
+    /**
+     * Post an async read request that reports its outcome into the caller owned completion record.
+     * Unlike the future based version no state is allocated to track the operation.
+     *
+     * @param dest The provided destination buffer to read data into.
+     * @param bytesToRead Amount of data (in bytes) to read from this IO object.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    virtual void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) = 0;
+
+    /**
+     * Post an async write request that reports its outcome into the caller owned completion record.
+     * Unlike the future based version no state is allocated to track the operation.
+     *
+     * @param src The provided source buffer to read data from.
+     * @param bytesToWrite Amount of data (in bytes) to write from the buffer into this IO object.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    virtual void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) = 0;
+
+    /**
+     * Post an async read request that must complete by the given deadline.
+     * If the data has not been read by then, only this operation is cancelled and it fails with ETIMEDOUT.
+     * Deadlines use timers of the event loop, so no extra timer object is required.
+     *
+     * @note If the event loop is run on multiple threads, the channel must be bound to a strand with `bindTo()`:
+     * otherwise the deadline may expire on one thread while the operation completes on another.
+     *
+     * @param dest The provided destination buffer to read data into.
+     * @param bytesToRead Amount of data (in bytes) to read from this IO object.
+     * @param deadline Point in time by which the operation must complete.
+     * @return A future that will be resolved once the scpecified number of bytes has been read.
+     */
+    Solace::Future<void> asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, Deadline deadline);
+
+    /**
+     * Post an async write request that must complete by the given deadline.
+     * @see asyncRead(Solace::ByteWriter&, size_type, Deadline)
+     *
+     * @param src The provided source buffer to read data from.
+     * @param bytesToWrite Amount of data (in bytes) to write from the buffer into this IO object.
+     * @param deadline Point in time by which the operation must complete.
+     * @return A future that will be resolved once the data has been written into the IO object.
+     */
+    Solace::Future<void> asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, Deadline deadline);
+
+    /**
+     * Post an async read request with a deadline that reports its outcome into the caller owned completion record.
+     * @see asyncRead(Solace::ByteWriter&, size_type, Deadline)
+     *
+     * @param dest The provided destination buffer to read data into.
+     * @param bytesToRead Amount of data (in bytes) to read from this IO object.
+     * @param deadline Point in time by which the operation must complete.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    virtual void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, Deadline deadline,
+                           AsyncCompletion& completion) = 0;
+
+    /**
+     * Post an async write request with a deadline that reports its outcome into the caller owned completion record.
+     * @see asyncWrite(Solace::ByteReader&, size_type, Deadline)
+     *
+     * @param src The provided source buffer to read data from.
+     * @param bytesToWrite Amount of data (in bytes) to write from the buffer into this IO object.
+     * @param deadline Point in time by which the operation must complete.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    virtual void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, Deadline deadline,
+                            AsyncCompletion& completion) = 0;
+
+    /**
+     * Post an async read request to read whatever data is available from this IO object, up to the size of the buffer.
+     * Unlike `asyncRead` the operation completes as soon as any data has been read, which is what a streaming parser
+     * needs to process data with the lowest latency.
+     *
+     * @param dest The provided destination buffer to read data into.
+     * @return A future that will be resolved with the number of bytes read.
+     */
+    Solace::Future<size_type> asyncReadSome(Solace::ByteWriter& dest) {
+        return asyncReadSome(dest, dest.remaining());
+    }
+
+    /**
+     * Post an async read request to read whatever data is available from this IO object, up to the given number of bytes.
+     * @see asyncReadSome(Solace::ByteWriter&)
+     *
+     * @param dest The provided destination buffer to read data into.
+     * @param maxBytesToRead Maximum amount of data (in bytes) to read from this IO object.
+     * @return A future that will be resolved with the number of bytes read.
+     */
+    Solace::Future<size_type> asyncReadSome(Solace::ByteWriter& dest, size_type maxBytesToRead);
+
+    /**
+     * Post an async partial read request that reports its outcome into the caller owned completion record.
+     * Number of bytes read is reported as the completion value.
+     * @see asyncReadSome(Solace::ByteWriter&)
+     *
+     * @param dest The provided destination buffer to read data into.
+     * @param maxBytesToRead Maximum amount of data (in bytes) to read from this IO object.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    virtual void asyncReadSome(Solace::ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) = 0;
+
+    /**
+     * Post an async read request to scatter data from this IO object into the given buffers.
+     * Buffers are filled in order and the operation is performed with as few system calls as possible, ideally one.
+     * Note: For message oriented channels a single message is read.
+     *
+     * @param dests Destination buffers to read data into. Buffers must stay alive until the operation completes.
+     * @return A future that will be resolved once the data has been read.
+     */
+    Solace::Future<void> asyncReadv(ReadBuffers dests);
+
+    /**
+     * Post an async scatter read request that reports its outcome into the caller owned completion record.
+     * @see asyncReadv(ReadBuffers)
+     *
+     * @param dests Destination buffers to read data into.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    virtual void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) = 0;
+
+    /**
+     * Post an async write request to gather remaining data of all of the given buffers into this IO object.
+     * Unlike a write per buffer, or copying buffers into one, buffers are written with as few system calls
+     * as possible, ideally one. For message oriented channels all buffers are sent as a single message.
+     *
+     * @param srcs Source buffers to write data from. Buffers must stay alive until the operation completes.
+     * @return A future that will be resolved once the data has been written into the IO object.
+     */
+    Solace::Future<void> asyncWritev(WriteBuffers srcs);
+
+    /**
+     * Post an async gather write request that reports its outcome into the caller owned completion record.
+     * @see asyncWritev(WriteBuffers)
+     *
+     * @param srcs Source buffers to write data from.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    virtual void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) = 0;
+
+    /**
+     * Post an async read request that invokes the given callable once the destination buffer is full.
+     * Unlike the future based version no promise / future pair is created:
+     * the callable is stored in a completion record recycled by the channel, @see getCompletionMemory.
+     *
+     * @param dest The provided destination buffer to read data into.
+     * @param callback Callable invoked with `Solace::Result<void, Solace::Error>` of the operation.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncRead(Solace::ByteWriter& dest, F&& callback) {
+        asyncRead(dest, dest.remaining(), makeCallbackCompletion(getCompletionMemory(), std::forward<F>(callback)));
+    }
+
+    /**
+     * Post an async read request that invokes the given callable once the specified amount of data has been read.
+     * @see asyncRead(Solace::ByteWriter&, F&&)
+     *
+     * @param dest The provided destination buffer to read data into.
+     * @param bytesToRead Amount of data (in bytes) to read from this IO object.
+     * @param callback Callable invoked with `Solace::Result<void, Solace::Error>` of the operation.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, F&& callback) {
+        asyncRead(dest, bytesToRead, makeCallbackCompletion(getCompletionMemory(), std::forward<F>(callback)));
+    }
+
+    /**
+     * Post an async write request that invokes the given callable once whole content of the buffer is written.
+     * Unlike the future based version no promise / future pair is created:
+     * the callable is stored in a completion record recycled by the channel, @see getCompletionMemory.
+     *
+     * @param src The provided source buffer to read data from.
+     * @param callback Callable invoked with `Solace::Result<void, Solace::Error>` of the operation.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncWrite(Solace::ByteReader& src, F&& callback) {
+        asyncWrite(src, src.remaining(), makeCallbackCompletion(getCompletionMemory(), std::forward<F>(callback)));
+    }
+
+    /**
+     * Post an async write request that invokes the given callable once the specified amount of data is written.
+     * @see asyncWrite(Solace::ByteReader&, F&&)
+     *
+     * @param src The provided source buffer to read data from.
+     * @param bytesToWrite Amount of data (in bytes) to write from the buffer into this IO object.
+     * @param callback Callable invoked with `Solace::Result<void, Solace::Error>` of the operation.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, F&& callback) {
+        asyncWrite(src, bytesToWrite, makeCallbackCompletion(getCompletionMemory(), std::forward<F>(callback)));
+    }
+
     /**
      * Read request synchroniously from this IO object into the given buffer.
      * This method reads the data until the provided destination buffer is full.
@@ -161,6 +367,54 @@ public:
     virtual Solace::Result<void, Solace::Error> write(Solace::ByteReader& src, size_type bytesToWrite) = 0;
 
 
+    /**
+     * Read whatever data is available from this IO object, blocking only if there is none, up to the size of the buffer.
+     *
+     * @param dest The provided destination buffer to read data into.
+     * @return Number of bytes read or an error.
+     */
+    Solace::Result<size_type, Solace::Error> readSome(Solace::ByteWriter& dest) {
+        return readSome(dest, dest.remaining());
+    }
+
+    /**
+     * Read whatever data is available from this IO object, blocking only if there is none, up to the given size.
+     *
+     * @param dest The provided destination buffer to read data into.
+     * @param maxBytesToRead Maximum amount of data (in bytes) to read from this IO object.
+     * @return Number of bytes read or an error.
+     */
+    virtual Solace::Result<size_type, Solace::Error> readSome(Solace::ByteWriter& dest, size_type maxBytesToRead) = 0;
+
+    /**
+     * Read data synchroniously from this IO object, scattering it into the given buffers in order.
+     * @see asyncReadv(ReadBuffers)
+     *
+     * @param dests Destination buffers to read data into.
+     * @return A operation result or an error.
+     */
+    virtual Solace::Result<void, Solace::Error> readv(ReadBuffers dests) = 0;
+
+    /**
+     * Write data synchroniously into this IO object, gathering it from the given buffers in order.
+     * @see asyncWritev(WriteBuffers)
+     *
+     * @param srcs Source buffers to write data from.
+     * @return A operation result or an error.
+     */
+    virtual Solace::Result<void, Solace::Error> writev(WriteBuffers srcs) = 0;
+
+    /**
+     * Bind this channel to a strand so that completions of all of its async operations are executed
+     * through the strand and never run concurrently with other handlers of the same strand.
+     * This makes it safe to run the event loop on multiple threads without guarding channel state by a mutex.
+     * Channels driven by a loop run on multiple threads must be bound to a strand, in particular to use deadlines.
+     * Only operations started after this call are affected.
+     *
+     * @param strand A strand of the same event loop as this channel. Must outlive the channel.
+     */
+    virtual void bindTo(Strand& strand) = 0;
+
     /**
      * Cancel all asynchronous operations associated with the channel.
      */
@@ -184,6 +438,28 @@ public:
      */
     virtual bool isClosed() const = 0;
 
+    /**
+     * Native descriptors of a channel.
+     * Bidirectional channels, like sockets, read from and write to the same descriptor.
+     */
+    struct NativeHandles {
+        int readHandle;     //!< Descriptor data is read from.
+        int writeHandle;    //!< Descriptor data is written to.
+    };
+
+    /**
+     * Get native descriptors of the channel, i.e. to move data between channels without copying it via user space.
+     * Descriptors remain owned by the channel and must not be closed.
+     * @return Native descriptors of the channel.
+     */
+    virtual NativeHandles getNativeHandles() = 0;
+
+    /**
+     * Get memory that completion records of callback based operations of the channel are allocated from.
+     * @return Memory of the channel, or null to allocate completion records from the heap.
+     */
+    virtual CompletionMemory* getCompletionMemory() noexcept;
+
 private:
 
     EventLoop*   _ioContext;
@@ -0,0 +1,215 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Completion record of an async operation
+ *	@file		cadence/async/completion.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_COMPLETION_HPP
+#define CADENCE_ASYNC_COMPLETION_HPP
+
+#include <solace/error.hpp>
+#include <solace/result.hpp>
+
+#include <cstddef>  // std::size_t
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace cadence::async {
+
+/**
+ * Completion record of an async operation that reports its outcome via a plain callback rather than a future.
+ *
+ * The record is owned by the caller, i.e. lives in a coroutine frame or in a session object,
+ * and must stay alive until the callback is invoked. The library does not allocate any shared state
+ * for operations started with a completion record.
+ */
+class AsyncCompletion {
+public:
+    using Callback = void (*)(AsyncCompletion& self);
+
+public:
+
+    explicit AsyncCompletion(Callback callback) noexcept
+        : _callback(callback)
+    {}
+
+    AsyncCompletion(AsyncCompletion const&) = delete;
+    AsyncCompletion& operator= (AsyncCompletion const&) = delete;
+
+    /**
+     * Record the outcome of the operation and invoke the callback.
+     * Called by the library on a thread running the event loop.
+     *
+     * @param errorCode System error code of the operation, zero on success.
+     * @param value Result of the operation, i.e. number of bytes transferred.
+     * @param tag Name of the operation used to tag an error.
+     */
+    void complete(int errorCode, std::size_t value, Solace::StringLiteral tag) {
+        _errorCode = errorCode;
+        _value = value;
+        _tag = tag;
+
+        _callback(*this);
+    }
+
+    /** Test if the operation has failed. */
+    bool isError() const noexcept { return _errorCode != 0; }
+
+    /** Get the error the operation failed with. Only meaningful if `isError()`. */
+    Solace::Error getError() const noexcept;
+
+    /** Get the result value of a successful operation, i.e. number of bytes transferred. */
+    std::size_t getValue() const noexcept { return _value; }
+
+    /** Get system error code of the operation, zero on success. */
+    int getErrorCode() const noexcept { return _errorCode; }
+
+    /** Get name of the operation the outcome was reported by. */
+    Solace::StringLiteral getTag() const noexcept { return _tag; }
+
+    /** Convert outcome of the operation into a result. */
+    Solace::Result<void, Solace::Error> toResult() const {
+        if (isError()) {
+            return Solace::Err(getError());
+        }
+
+        return Solace::Ok();
+    }
+
+private:
+    Callback                _callback;
+    int                     _errorCode{0};
+    std::size_t             _value{0};
+    Solace::StringLiteral   _tag;
+};
+
+
+/**
+ * Memory of an io-object that completion records of its callback based operations are allocated from.
+ *
+ * Records are recycled along with the memory of pending operations of the io-object.
+ * A record which operation never completes, i.e. the event loop has been destroyed with the operation pending,
+ * is disposed of once neither the io-object nor any of its pending operations are left:
+ * its callable is destroyed without being invoked.
+ */
+class CompletionMemory {
+public:
+    using Dispose = void (*)(void* record) noexcept;
+
+    /**
+     * Allocate storage for a completion record.
+     * @param size Size of the record in bytes.
+     * @param dispose Function to destroy the record that has never been completed. It must not free the storage.
+     * @return Storage for the record.
+     */
+    virtual void* allocateRecord(std::size_t size, Dispose dispose) = 0;
+
+    /**
+     * Free storage of a completed record. The record must have been destroyed by the caller.
+     * @param record Storage of the record returned by `allocateRecord`.
+     */
+    virtual void deallocateRecord(void* record) noexcept = 0;
+
+protected:
+    ~CompletionMemory() = default;
+};
+
+
+/**
+ * Completion record that owns a callable and invokes it with the outcome of the operation.
+ *
+ * Backs callback based overloads of async operations: the record is allocated when the operation starts
+ * and released before the callable is invoked, so the callable is free to start the next operation.
+ * Unlike a future no shared state or synchronisation is involved.
+ * The record is allocated from the memory of the io-object when given, @see CompletionMemory,
+ * and from the heap otherwise.
+ */
+template<typename F>
+class CallbackCompletion :
+        public AsyncCompletion {
+public:
+
+    /**
+     * Create a new completion record that owns the given callable.
+     * @param memory Memory of the io-object to allocate the record from, or null to allocate from the heap.
+     * @param callback Callable to invoke with `Solace::Result<void, Solace::Error>` once the operation completes.
+     * @return Completion record that releases itself once notified.
+     */
+    template<typename Callback>
+    static AsyncCompletion& create(CompletionMemory* memory, Callback&& callback) {
+        if (!memory) {
+            return *new CallbackCompletion(nullptr, std::forward<Callback>(callback));
+        }
+
+        void* storage = memory->allocateRecord(sizeof(CallbackCompletion), &CallbackCompletion::dispose);
+        try {
+            return *::new (storage) CallbackCompletion(memory, std::forward<Callback>(callback));
+        } catch (...) {
+            memory->deallocateRecord(storage);
+            throw;
+        }
+    }
+
+private:
+
+    template<typename Callback>
+    CallbackCompletion(CompletionMemory* memory, Callback&& callback)
+        : AsyncCompletion(&CallbackCompletion::invoke)
+        , _memory(memory)
+        , _callback(std::forward<Callback>(callback))
+    {}
+
+    static void invoke(AsyncCompletion& self) {
+        auto* completion = static_cast<CallbackCompletion*>(&self);
+        auto callback = std::move(completion->_callback);
+        auto result = completion->toResult();
+        auto* memory = completion->_memory;
+        if (memory) {
+            completion->~CallbackCompletion();
+            memory->deallocateRecord(completion);
+        } else {
+            delete completion;
+        }
+
+        callback(std::move(result));
+    }
+
+    static void dispose(void* record) noexcept {
+        static_cast<CallbackCompletion*>(record)->~CallbackCompletion();
+    }
+
+    CompletionMemory*   _memory;
+    F                   _callback;
+};
+
+
+/** Allocate a completion record that invokes the given callable. @see CallbackCompletion */
+template<typename F>
+AsyncCompletion& makeCallbackCompletion(CompletionMemory* memory, F&& callback) {
+    return CallbackCompletion<std::decay_t<F>>::create(memory, std::forward<F>(callback));
+}
+
+/** Allocate a completion record that invokes the given callable from the heap. @see CallbackCompletion */
+template<typename F>
+AsyncCompletion& makeCallbackCompletion(F&& callback) {
+    return makeCallbackCompletion(nullptr, std::forward<F>(callback));
+}
+
+
+/** Enable an overload only for callables that accept the outcome of an async operation. */
+template<typename F>
+using EnableIfCompletionCallback = std::enable_if_t<
+    std::is_invocable_v<std::decay_t<F>&, Solace::Result<void, Solace::Error>&&>
+>;
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_COMPLETION_HPP
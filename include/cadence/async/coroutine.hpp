@@ -0,0 +1,216 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: C++20 coroutine support for async operations
+ *	@file		cadence/async/coroutine.hpp
+ *
+ * The library itself is built as C++17. This header is only active when included into
+ * a translation unit compiled with coroutine support and is empty otherwise.
+ * Test for CADENCE_ASYNC_HAS_COROUTINES to check if awaitables are available.
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_COROUTINE_HPP
+#define CADENCE_ASYNC_COROUTINE_HPP
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include "cadence/async/completion.hpp"
+#include "cadence/async/channel.hpp"
+#include "cadence/async/acceptor.hpp"
+#include "cadence/async/timer.hpp"
+#include "cadence/async/event.hpp"
+#include "cadence/async/signalSet.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+
+#define CADENCE_ASYNC_HAS_COROUTINES 1
+
+
+namespace cadence::async::coro {
+
+/**
+ * Completion record that resumes a suspended coroutine once the operation has completed.
+ */
+template<typename Completion>
+class ResumeCompletion :
+        public Completion {
+public:
+
+    ResumeCompletion() noexcept
+        : Completion(&ResumeCompletion::resume)
+    {}
+
+    void setContinuation(std::coroutine_handle<> continuation) noexcept {
+        _continuation = continuation;
+    }
+
+private:
+
+    static void resume(AsyncCompletion& self) {
+        static_cast<ResumeCompletion&>(self)._continuation.resume();
+    }
+
+    std::coroutine_handle<> _continuation;
+};
+
+
+/**
+ * Awaitable async operation.
+ * The completion record lives in the awaitable, that is in the frame of the awaiting coroutine,
+ * so awaiting an operation does not allocate a promise or any other shared state.
+ *
+ * @tparam T Type of the value the operation results in.
+ * @tparam Completion Type of the completion record used by the operation.
+ * @tparam Initiation Callable that starts the operation given a completion record.
+ */
+template<typename T, typename Completion, typename Initiation>
+class Operation {
+public:
+
+    explicit Operation(Initiation initiation) noexcept(std::is_nothrow_move_constructible_v<Initiation>)
+        : _initiation(std::move(initiation))
+    {}
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> continuation) {
+        _completion.setContinuation(continuation);
+        _initiation(_completion);
+    }
+
+    Solace::Result<T, Solace::Error> await_resume() {
+        if (_completion.isError()) {
+            return Solace::Err(_completion.getError());
+        }
+
+        if constexpr (std::is_void_v<T>) {
+            return Solace::Ok();
+        } else if constexpr (std::is_same_v<T, StreamSocket>) {
+            return Solace::Ok(std::move(*_completion.socket));
+        } else {
+            return Solace::Ok(static_cast<T>(_completion.getValue()));
+        }
+    }
+
+private:
+    Initiation                      _initiation;
+    ResumeCompletion<Completion>    _completion;
+};
+
+
+template<typename T, typename Completion, typename Initiation>
+Operation<T, Completion, Initiation> makeOperation(Initiation&& initiation) {
+    return Operation<T, Completion, Initiation>{std::forward<Initiation>(initiation)};
+}
+
+
+/**
+ * Await until specified amount of data has been read from the channel into the given buffer.
+ * @see Channel::asyncRead
+ */
+inline auto asyncRead(Channel& channel, Solace::ByteWriter& dest, Channel::size_type bytesToRead) {
+    return makeOperation<void, AsyncCompletion>([&channel, &dest, bytesToRead](AsyncCompletion& completion) {
+        channel.asyncRead(dest, bytesToRead, completion);
+    });
+}
+
+inline auto asyncRead(Channel& channel, Solace::ByteWriter& dest) {
+    return asyncRead(channel, dest, dest.remaining());
+}
+
+
+/**
+ * Await until specified amount of data has been written from the given buffer into the channel.
+ * @see Channel::asyncWrite
+ */
+inline auto asyncWrite(Channel& channel, Solace::ByteReader& src, Channel::size_type bytesToWrite) {
+    return makeOperation<void, AsyncCompletion>([&channel, &src, bytesToWrite](AsyncCompletion& completion) {
+        channel.asyncWrite(src, bytesToWrite, completion);
+    });
+}
+
+inline auto asyncWrite(Channel& channel, Solace::ByteReader& src) {
+    return asyncWrite(channel, src, src.remaining());
+}
+
+
+/**
+ * Await a new connection.
+ * @see Acceptor::asyncAccept
+ */
+inline auto asyncAccept(Acceptor& acceptor) {
+    return makeOperation<StreamSocket, AcceptCompletion>([&acceptor](AcceptCompletion& completion) {
+        acceptor.asyncAccept(completion);
+    });
+}
+
+/**
+ * Await a new connection to be served by the given event loop.
+ * @see Acceptor::asyncAccept
+ */
+inline auto asyncAccept(Acceptor& acceptor, EventLoop& sessionLoop) {
+    return makeOperation<StreamSocket, AcceptCompletion>([&acceptor, &sessionLoop](AcceptCompletion& completion) {
+        acceptor.asyncAccept(sessionLoop, completion);
+    });
+}
+
+
+/**
+ * Await expiry of the timer.
+ * @see Timer::asyncWait
+ */
+inline auto asyncWait(Timer& timer) {
+    return makeOperation<Solace::int64, AsyncCompletion>([&timer](AsyncCompletion& completion) {
+        timer.asyncWait(completion);
+    });
+}
+
+/**
+ * Await notification of the event.
+ * @see Event::asyncWait
+ */
+inline auto asyncWait(Event& event) {
+    return makeOperation<void, AsyncCompletion>([&event](AsyncCompletion& completion) {
+        event.asyncWait(completion);
+    });
+}
+
+/**
+ * Await delivery of a signal. Results in the signal number.
+ * @see SignalSet::asyncWait
+ */
+inline auto asyncWait(SignalSet& signalSet) {
+    return makeOperation<int, AsyncCompletion>([&signalSet](AsyncCompletion& completion) {
+        signalSet.asyncWait(completion);
+    });
+}
+
+
+/**
+ * Return type of a fire-and-forget coroutine.
+ * The coroutine starts eagerly and its frame is destroyed when it finishes.
+ */
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+}  // End of namespace cadence::async::coro
+
+#endif  // __cpp_impl_coroutine
+#endif  // CADENCE_ASYNC_COROUTINE_HPP
@@ -46,6 +46,10 @@ public:
 
     using Channel::asyncRead;
     using Channel::asyncWrite;
+    using Channel::asyncReadSome;
+    using Channel::readSome;
+    using Channel::asyncReadv;
+    using Channel::asyncWritev;
     using Channel::read;
     using Channel::write;
 
@@ -72,6 +76,60 @@ public:
      */
     Solace::Future<void> asyncWrite(Solace::ByteReader& src, size_type bytesToWrite) override;
 
+    /** @see Channel::asyncRead */
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncWrite */
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncRead */
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, Deadline deadline,
+                   AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncWrite */
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, Deadline deadline,
+                    AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncReadSome */
+    void asyncReadSome(Solace::ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) override;
+
+    /** @see Channel::readSome */
+    Solace::Result<size_type, Solace::Error> readSome(Solace::ByteWriter& dest, size_type maxBytesToRead) override;
+
+    /** @see Channel::asyncReadv */
+    void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncWritev */
+    void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) override;
+
+    /** @see Channel::readv */
+    Solace::Result<void, Solace::Error> readv(ReadBuffers dests) override;
+
+    /** @see Channel::writev */
+    Solace::Result<void, Solace::Error> writev(WriteBuffers srcs) override;
+
+    /**
+     * @see Channel::asyncRead
+     * Calls this class implementation directly, bypassing virtual dispatch.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, F&& callback) {
+        auto& completion = makeCallbackCompletion(DatagramDomainSocket::getCompletionMemory(),
+                                                  std::forward<F>(callback));
+        DatagramDomainSocket::asyncRead(dest, bytesToRead, completion);
+    }
+
+    /**
+     * @see Channel::asyncWrite
+     * Calls this class implementation directly, bypassing virtual dispatch.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, F&& callback) {
+        auto& completion = makeCallbackCompletion(DatagramDomainSocket::getCompletionMemory(),
+                                                  std::forward<F>(callback));
+        DatagramDomainSocket::asyncWrite(src, bytesToWrite, completion);
+    }
+
 
     /** @see Channel::read */
     Solace::Result<void, Solace::Error> read(Solace::ByteWriter& dest, size_type bytesToRead) override;
@@ -79,6 +137,9 @@ public:
     /** @see Channel::write */
     Solace::Result<void, Solace::Error> write(Solace::ByteReader& src, size_type bytesToWrite) override;
 
+    /** @see Channel::bindTo */
+    void bindTo(Strand& strand) override;
+
     /**
      * Cancel all asynchronous operations associated with the socket.
      */
@@ -101,6 +162,12 @@ public:
      */
     bool isClosed()const  override;
 
+    /** @see Channel::getNativeHandles */
+    NativeHandles getNativeHandles() override;
+
+    /** @see Channel::getCompletionMemory */
+    CompletionMemory* getCompletionMemory() noexcept override;
+
     /**
      * Get the local endpoint of the socket.
      * @return Local endpoint this socket is bound to.
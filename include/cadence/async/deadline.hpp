@@ -0,0 +1,41 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Deadline of an async operation
+ *	@file		cadence/async/deadline.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_DEADLINE_HPP
+#define CADENCE_ASYNC_DEADLINE_HPP
+
+#include <chrono>
+
+
+namespace cadence::async {
+
+/**
+ * Point in time by which an async operation must complete.
+ * An operation that is still pending once its deadline expires is cancelled and fails with ETIMEDOUT.
+ * Other operations of the same io object are not affected.
+ */
+using Deadline = std::chrono::steady_clock::time_point;
+
+
+/**
+ * Make a deadline that expires after the given time from now.
+ * @param timeout Time allowed for the operation to complete.
+ * @return Deadline of the operation.
+ */
+template<typename Rep, typename Period>
+Deadline deadlineAfter(std::chrono::duration<Rep, Period> timeout) {
+    return Deadline::clock::now() + std::chrono::duration_cast<Deadline::duration>(timeout);
+}
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_DEADLINE_HPP
@@ -46,6 +46,12 @@ public:
 
     Solace::Future<void> asyncWait();
 
+    /**
+     * Wait for the event to be notified reporting the outcome into the caller owned completion record.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    void asyncWait(AsyncCompletion& completion);
+
     void notify();
 
 private:
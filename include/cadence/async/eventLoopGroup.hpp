@@ -0,0 +1,125 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Group of event loops, one per thread
+ *	@file		cadence/async/eventLoopGroup.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_EVENTLOOPGROUP_HPP
+#define CADENCE_ASYNC_EVENTLOOPGROUP_HPP
+
+#include "cadence/async/eventloop.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+namespace cadence::async {
+
+/**
+ * A group of independent event loops each driven by its own thread.
+ *
+ * Unlike running a single EventLoop on multiple threads, loops in a group do not share a scheduler
+ * and thus don't contend on it. New channels are distributed between loops of the group using `next()`.
+ * All channels created on the same loop are served by the same thread.
+ */
+class EventLoopGroup {
+public:
+
+    using size_type = EventLoop::size_type;
+
+    /**
+     * Strategy to select a loop for the next channel.
+     */
+    enum class Selection {
+        RoundRobin,     //!< Loops are selected in turns.
+        LeastLoaded     //!< A loop with the smallest number of channels is selected.
+    };
+
+public:
+
+    ~EventLoopGroup();
+
+    /**
+     * Construct a new group of event loops.
+     *
+     * @param nbLoops Number of loops in the group. 0 means one loop per available CPU core.
+     * @param selection Strategy used by `next()` to select a loop.
+     * @param pinThreads If true, thread running loop N is pinned to CPU core N (modulo number of cores).
+     */
+    explicit EventLoopGroup(size_type nbLoops = 0,
+                            Selection selection = Selection::RoundRobin,
+                            bool pinThreads = true);
+
+    EventLoopGroup(EventLoopGroup const&) = delete;
+    EventLoopGroup& operator= (EventLoopGroup const&) = delete;
+
+    /**
+     * Get number of event loops in this group.
+     * @return Number of event loops in the group.
+     */
+    size_type size() const noexcept {
+        return static_cast<size_type>(_loops.size());
+    }
+
+    /**
+     * Get an event loop by its index in the group.
+     * @param index Index of the loop. Must be less than `size()`.
+     * @return Event loop.
+     */
+    EventLoop& operator[] (size_type index) {
+        return *_loops[index];
+    }
+
+    /**
+     * Select an event loop to assign a new channel to.
+     * This method is thread-safe.
+     *
+     * @return Event loop selected according to the selection strategy of the group.
+     */
+    EventLoop& next();
+
+    /**
+     * Start a thread for each loop in the group. This call does not block.
+     * Loops keep running even if there is no work queued until `stop()` is called.
+     */
+    void start();
+
+    /**
+     * Run all event loops of the group and block until `stop()` is called.
+     */
+    void run();
+
+    /**
+     * Stop all event loops in the group.
+     * This method is thread-safe and can be called from any thread, including event handlers.
+     */
+    void stop();
+
+    /**
+     * Block until all threads of the group have finished.
+     */
+    void join();
+
+private:
+
+    class KeepAlive;
+
+    std::vector<std::unique_ptr<EventLoop>>     _loops;
+    std::vector<std::unique_ptr<KeepAlive>>     _keepAlive;
+    std::vector<std::thread>                    _threads;
+
+    Selection                   _selection;
+    bool                        _pinThreads;
+    std::atomic<size_type>      _nextIndex{0};
+};
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_EVENTLOOPGROUP_HPP
@@ -0,0 +1,163 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Event loop instrumentation
+ *	@file		cadence/async/eventLoopStats.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_EVENTLOOPSTATS_HPP
+#define CADENCE_ASYNC_EVENTLOOPSTATS_HPP
+
+#include <solace/types.hpp>
+
+#include <algorithm>  // std::min
+#include <array>
+#include <chrono>
+#include <functional>
+
+
+namespace cadence::async {
+
+/**
+ * Histogram of durations with logarithmic buckets.
+ * Bucket 0 counts durations under 1us, bucket `i` counts durations in [2^(i-1), 2^i) microseconds.
+ * The last bucket also counts all durations that are longer than that.
+ */
+class DurationHistogram {
+public:
+    using size_type = Solace::uint32;
+    using duration_type = std::chrono::microseconds;
+
+    static constexpr size_type kNbBuckets = 32;
+
+    using Buckets = std::array<Solace::uint64, kNbBuckets>;
+
+public:
+
+    /**
+     * Get index of the bucket the given duration falls into.
+     */
+    static size_type bucketIndex(duration_type value) noexcept {
+        auto const us = static_cast<Solace::uint64>(value.count() > 0 ? value.count() : 0);
+        if (us == 0) {
+            return 0;
+        }
+
+        // Number of significant bits, i.e. floor(log2(us)) + 1
+        auto const index = static_cast<size_type>(64 - __builtin_clzll(us));
+
+        return (index < kNbBuckets) ? index : kNbBuckets - 1;
+    }
+
+    /**
+     * Get exclusive upper bound of durations counted by the given bucket.
+     */
+    static duration_type bucketUpperBound(size_type index) noexcept {
+        return duration_type{static_cast<duration_type::rep>(1) << index};
+    }
+
+public:
+
+    DurationHistogram() noexcept = default;
+
+    DurationHistogram(Buckets const& buckets, duration_type total, duration_type max) noexcept
+        : _buckets(buckets)
+        , _total(total)
+        , _max(max)
+    {
+        for (auto b : _buckets) {
+            _count += b;
+        }
+    }
+
+    /** Get number of durations recorded in the given bucket. */
+    Solace::uint64 operator[] (size_type index) const noexcept { return _buckets[index]; }
+
+    /** Get total number of recorded durations. */
+    Solace::uint64 count() const noexcept { return _count; }
+
+    /** Get sum of all recorded durations. */
+    duration_type total() const noexcept { return _total; }
+
+    /** Get longest recorded duration. */
+    duration_type max() const noexcept { return _max; }
+
+    /** Get average of recorded durations. */
+    duration_type mean() const noexcept {
+        return (_count == 0)
+                ? duration_type::zero()
+                : duration_type{_total.count() / static_cast<duration_type::rep>(_count)};
+    }
+
+    /**
+     * Estimate a percentile of recorded durations.
+     * @param p Percentile in range [0, 1], i.e. 0.99 for p99.
+     * @return Upper bound of the bucket that contains requested percentile, clamped to the max recorded value.
+     */
+    duration_type percentile(double p) const noexcept {
+        if (_count == 0) {
+            return duration_type::zero();
+        }
+
+        auto const rank = static_cast<Solace::uint64>(p * static_cast<double>(_count));
+        Solace::uint64 seen = 0;
+        for (size_type i = 0; i < kNbBuckets; ++i) {
+            seen += _buckets[i];
+            if (seen > rank) {
+                return std::min(bucketUpperBound(i), _max);
+            }
+        }
+
+        return _max;
+    }
+
+private:
+    Buckets             _buckets{};
+    Solace::uint64      _count{0};
+    duration_type       _total{0};
+    duration_type       _max{0};
+};
+
+
+/**
+ * Options of the event loop instrumentation.
+ * @see EventLoop::enableInstrumentation
+ */
+struct InstrumentationOptions {
+    //!< Execution time budget of a single handler. Zero disables the check.
+    std::chrono::microseconds handlerBudget{0};
+
+    //!< Called on the thread that executed a handler once it has run for longer than the budget.
+    std::function<void(std::chrono::microseconds)> onBudgetExceeded;
+
+    //!< Period of the loop lag probe. Zero disables the probe.
+    std::chrono::milliseconds lagProbeInterval{0};
+};
+
+
+/**
+ * Snapshot of the event loop instrumentation.
+ * @see EventLoop::getStats
+ */
+struct EventLoopStats {
+    //!< Execution time of handlers.
+    DurationHistogram   handlerTime;
+
+    //!< Scheduling delay measured by the lag probe: how late a timer handler is run after its expiry.
+    DurationHistogram   loopLag;
+
+    //!< Number of handlers that have exceeded execution time budget.
+    Solace::uint64      budgetExceeded{0};
+
+    //!< Number of tasks submitted to the loop that are yet to be executed.
+    Solace::uint64      tasksQueued{0};
+};
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_EVENTLOOPSTATS_HPP
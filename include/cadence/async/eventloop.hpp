@@ -17,12 +17,55 @@
 #ifndef CADENCE_ASYNC_EVENTLOOP_HPP
 #define CADENCE_ASYNC_EVENTLOOP_HPP
 
+#include "cadence/async/task.hpp"
+#include "cadence/async/eventLoopStats.hpp"
+
 #include <solace/types.hpp>
+
+#include <chrono>
 #include <memory>  // std::unique_ptr<>
 
 
 namespace cadence::async {
 
+/**
+ * Options of the busy-polling run mode.
+ * @see EventLoop::runBusyPoll
+ */
+struct BusyPollOptions {
+    //!< Time to spin polling for ready handlers before blocking to wait for events.
+    std::chrono::microseconds spinBudget{50};
+
+    //!< Adapt spin time: halve it each time spinning ends without finding any work and restore it when it does.
+    bool adaptive{true};
+
+    //!< Lower bound of the adaptive spin time.
+    std::chrono::microseconds minSpinBudget{2};
+
+    //!< Maximum time to block waiting for events before going back to spinning.
+    std::chrono::milliseconds maxSleep{10};
+};
+
+
+/**
+ * Statistics of a busy-polling run.
+ * @see EventLoop::runBusyPoll
+ */
+struct BusyPollStats {
+    //!< Number of poll cycles that found no ready handlers while spinning.
+    Solace::uint64 spinCycles{0};
+
+    //!< Number of times the loop blocked to wait for events once spin time was exhausted.
+    Solace::uint64 sleepCycles{0};
+
+    //!< Number of handlers executed while spinning.
+    Solace::uint64 handlersSpinning{0};
+
+    //!< Number of handlers executed after blocking wait.
+    Solace::uint64 handlersSleeping{0};
+};
+
+
 /**
  * Event loop.
  *
@@ -64,6 +107,20 @@ public:
      */
     void run();
 
+    /**
+     * Run event processing loop using a pool of threads until `stop()` is called or there is no more jobs queued.
+     * The calling thread is one of the threads of the pool: this call spawns `threadCount - 1` worker threads
+     * and blocks until all of them have been joined.
+     *
+     * @param threadCount Total number of threads, including the calling one, to drive the loop.
+     *
+     * @note Handlers may be executed concurrently. If a handler throws, the loop is stopped and the first
+     * exception is re-thrown from this call once all the workers have been joined.
+     * If a worker thread can not be started, the loop is stopped, workers started so far are joined
+     * and the error is re-thrown.
+     */
+    void run(size_type threadCount);
+
     /**
      * This call blocks until all work has finished and there are no more handlers to be dispatched,
      * until the event loop has been stopped, or until the specified duration has elapsed.
@@ -72,17 +129,148 @@ public:
      */
     void runFor(int msec);
 
+    /**
+     * Run event processing loop using a pool of threads for at most the specified duration.
+     * @see EventLoop::run(size_type) for details.
+     *
+     * @param threadCount Total number of threads, including the calling one, to drive the loop.
+     * @param msec The duration for which the call may block in milliseconds.
+     */
+    void runFor(size_type threadCount, int msec);
+
+    /**
+     * Run event processing loop on the calling thread in busy-polling mode until `stop()` is called
+     * or there is no more jobs queued.
+     * Instead of blocking in the OS to wait for events, the loop polls for ready handlers for up to
+     * `options.spinBudget` and only then blocks. This trades CPU time for lower wake-up latency.
+     *
+     * @param options Spinning options.
+     * @return Statistics of time spent spinning versus sleeping.
+     */
+    BusyPollStats runBusyPoll(BusyPollOptions const& options);
+
+    /**
+     * Run event processing loop on the calling thread in busy-polling mode for at most the specified duration.
+     * @see EventLoop::runBusyPoll for details.
+     *
+     * @param options Spinning options.
+     * @param msec The duration for which the call may run in milliseconds.
+     * @return Statistics of time spent spinning versus sleeping.
+     */
+    BusyPollStats runBusyPollFor(BusyPollOptions const& options, int msec);
+
+    /**
+     * Get the number of threads currently executing `run` or `runFor` of this loop.
+     * @return Number of threads driving this event loop.
+     */
+    size_type runningThreads() const noexcept;
+
+    /**
+     * Get the number of channels currently bound to this event loop.
+     * This is used as a measure of the loop load when distributing channels between loops.
+     * @return Number of live channels created on this event loop.
+     */
+    size_type channelCount() const noexcept;
+
     /**
      * Stop event processing loop.
+     * This method is thread-safe and can be called from any thread, including event handlers.
+     * All threads driving the loop return as soon as possible.
      */
     void stop();
 
+    /**
+     * Prepare stopped event loop to be run again.
+     * @note Must not be called while any thread is running the loop. The call is ignored in that case.
+     */
     void reset();
 
+    /**
+     * Submit a task to be executed by the event loop.
+     * The task is never executed inside this call, even if called from a thread running the loop.
+     * This method is thread-safe. Submissions from threads not running the loop are stored in a lock-free queue,
+     * and tasks that don't fit into the queue spill over into a list, keeping the order of submission.
+     * Note: Waking the loop up from another thread posts a handler, which may allocate memory;
+     * a burst of submissions costs a single wake-up.
+     *
+     * @param task A callable to execute. Callables with small captured state are stored without memory allocation.
+     */
+    void post(Task&& task);
+
+    /**
+     * Submit a task to be executed by the event loop.
+     * If called from a thread running the loop the task is executed immediately inside this call,
+     * otherwise it is posted as if by `post()`.
+     *
+     * @param task A callable to execute.
+     */
+    void dispatch(Task&& task);
+
+    /**
+     * Submit a task to be executed by the event loop once the current handler returns.
+     * If called from a thread running the loop the task is queued to a thread-local queue,
+     * avoiding synchronisation; use it for continuations of the current handler.
+     * Otherwise it is posted as if by `post()`.
+     *
+     * @param task A callable to execute.
+     */
+    void defer(Task&& task);
+
+    /**
+     * Test if the calling thread is running this event loop.
+     * @return True if this method is called from a handler executed by this loop.
+     */
+    bool isRunningInThisThread() const noexcept;
+
+    /**
+     * Enable collection of the event loop statistics.
+     * Once enabled, execution time of every handler is measured, and checked against the budget if one is set.
+     * If lag probe is configured, a periodic timer measures how late the loop is in executing ready handlers.
+     *
+     * @param options Instrumentation options.
+     *
+     * @note Must be called before the loop is run. The call is ignored while any thread is running the loop.
+     * @note A loop with the lag probe enabled always has pending work: `run()` only returns once the loop is stopped.
+     */
+    void enableInstrumentation(InstrumentationOptions options);
+
+    /**
+     * Enable collection of the event loop statistics with default options: no handler budget nor lag probe.
+     */
+    void enableInstrumentation() {
+        enableInstrumentation(InstrumentationOptions{});
+    }
+
+    /**
+     * Stop collection of the event loop statistics.
+     * Collected statistics remain available via `getStats()`.
+     * This method is thread-safe. Handlers that are running already may still be accounted for.
+     */
+    void disableInstrumentation() noexcept;
+
+    /**
+     * Test if instrumentation of this event loop is enabled.
+     * @return True if statistics are being collected.
+     */
+    bool isInstrumented() const noexcept;
+
+    /**
+     * Get a snapshot of the event loop statistics.
+     * This method is thread-safe and can be called while the loop is running.
+     *
+     * @return Statistics collected so far. All values are zero if instrumentation has never been enabled.
+     */
+    EventLoopStats getStats() const;
+
     void* getIOService() noexcept;
 
 private:
 
+    friend class Channel;
+
+    void attachChannel() noexcept;
+    void detachChannel() noexcept;
+
     class EventloopImpl;
     std::unique_ptr<EventloopImpl> _pimpl;
 };
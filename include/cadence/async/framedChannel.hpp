@@ -0,0 +1,156 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Length-prefixed message framing over a channel
+ *	@file		cadence/async/framedChannel.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_FRAMEDCHANNEL_HPP
+#define CADENCE_ASYNC_FRAMEDCHANNEL_HPP
+
+#include "cadence/async/bufferedChannel.hpp"
+
+
+namespace cadence::async {
+
+/**
+ * Encoding of the length header that precedes each frame.
+ */
+enum class FrameLengthEncoding {
+    Varint,     //!< Unsigned LEB128, 1 to 5 bytes.
+    Fixed16,    //!< 2 bytes, network byte order.
+    Fixed32     //!< 4 bytes, network byte order.
+};
+
+
+/**
+ * Channel adapter exchanging length-prefixed frames.
+ *
+ * Received frames are handed out as views into the receive buffer, without copying.
+ * Data is read ahead with as large reads as the buffer allows, and every complete frame already buffered
+ * is served without reading from the channel again.
+ *
+ * On the send side the length header is written together with the payload by a single gathered write.
+ * Stream sockets queue it as one write, so a frame never interleaves with other writes to the socket.
+ *
+ * Only one read and one write operation may be pending at a time.
+ * @note The wrapped channel must outlive this object.
+ */
+class FramedChannel {
+public:
+
+    using size_type = Channel::size_type;
+
+    static constexpr size_type kMaxHeaderSize = 5;
+    static constexpr size_type kDefaultMaxFrameSize = 64 * 1024;
+
+public:
+
+    ~FramedChannel();
+
+    FramedChannel(FramedChannel const&) = delete;
+    FramedChannel& operator= (FramedChannel const&) = delete;
+
+    /**
+     * Construct a new framing adapter for the given channel.
+     * @param channel Channel to exchange frames over.
+     * @param encoding Encoding of the frame length header.
+     * @param maxFrameSize Maximum size of a frame payload in bytes. Larger frames are rejected with EMSGSIZE.
+     */
+    explicit FramedChannel(Channel& channel,
+                           FrameLengthEncoding encoding = FrameLengthEncoding::Varint,
+                           size_type maxFrameSize = kDefaultMaxFrameSize);
+
+    Channel& getChannel() noexcept {
+        return _buffered.getChannel();
+    }
+
+    FrameLengthEncoding getEncoding() const noexcept {
+        return _encoding;
+    }
+
+    size_type getMaxFrameSize() const noexcept {
+        return _maxFrameSize;
+    }
+
+    /**
+     * Post an async request to read the next frame.
+     * Resolves immediately, without reading from the channel, if a complete frame is buffered already.
+     *
+     * @return A future that will be resolved with a view of the frame payload.
+     * The view is valid until the next read request.
+     * The operation fails with EMSGSIZE if the frame exceeds the maximum frame size
+     * and with EBADMSG if the length header is malformed.
+     */
+    Solace::Future<Solace::MemoryView> asyncReadFrame();
+
+    /**
+     * Post an async request to write a frame.
+     *
+     * @param payload Frame payload. Must stay alive until the operation completes.
+     * Advanced by the number of bytes written once the frame has been written.
+     * @param bytesToWrite Size of the frame payload.
+     * @return A future that will be resolved once the frame has been written.
+     * The operation fails with EMSGSIZE if the payload exceeds the maximum frame size.
+     */
+    Solace::Future<void> asyncWriteFrame(Solace::ByteReader& payload, size_type bytesToWrite);
+
+    /** @see asyncWriteFrame(Solace::ByteReader&, size_type) */
+    Solace::Future<void> asyncWriteFrame(Solace::ByteReader& payload) {
+        return asyncWriteFrame(payload, payload.remaining());
+    }
+
+    /**
+     * Write a frame synchronously.
+     * @see asyncWriteFrame(Solace::ByteReader&, size_type)
+     */
+    Solace::Result<void, Solace::Error> writeFrame(Solace::ByteReader& payload, size_type bytesToWrite);
+
+    /** @see writeFrame(Solace::ByteReader&, size_type) */
+    Solace::Result<void, Solace::Error> writeFrame(Solace::ByteReader& payload) {
+        return writeFrame(payload, payload.remaining());
+    }
+
+private:
+
+    struct WriteCompletion :
+            public AsyncCompletion {
+
+        explicit WriteCompletion(FramedChannel* self) noexcept;
+
+        FramedChannel*      owner;
+        Solace::ByteReader* payload{nullptr};
+        size_type           bytes{0};
+    };
+
+    static void onWrite(AsyncCompletion& self);
+
+    void resumeRead();
+    void failRead(Solace::Error&& error);
+    Channel::WriteBuffers prepareFrame(Solace::ByteReader& payload, size_type bytesToWrite);
+
+private:
+
+    FrameLengthEncoding                 _encoding;
+    size_type                           _maxFrameSize;
+    BufferedChannel                     _buffered;
+
+    bool                                _reading{false};
+    size_type                           _frameSize{0};  //!< Header and payload size of the frame handed out last.
+    Solace::Promise<Solace::MemoryView> _readPromise;
+
+    bool                                _writing{false};
+    Solace::byte                        _header[kMaxHeaderSize];
+    Solace::ByteReader                  _writeBuffers[2];
+    Solace::Promise<void>               _writePromise;
+    WriteCompletion                     _writeDone;
+};
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_FRAMEDCHANNEL_HPP
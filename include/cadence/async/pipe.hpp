@@ -46,6 +46,10 @@ public:
 
     using Channel::asyncRead;
     using Channel::asyncWrite;
+    using Channel::asyncReadSome;
+    using Channel::readSome;
+    using Channel::asyncReadv;
+    using Channel::asyncWritev;
 
 	/**
 	 * Post an async read request to read specified amount of data from this IO object into the given buffer.
@@ -69,6 +73,58 @@ public:
 	 */
     Solace::Future<void> asyncWrite(Solace::ByteReader& src, size_type bytesToWrite) override;
 
+    /** @see Channel::asyncRead */
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncWrite */
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncRead */
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, Deadline deadline,
+                   AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncWrite */
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, Deadline deadline,
+                    AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncReadSome */
+    void asyncReadSome(Solace::ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) override;
+
+    /** @see Channel::readSome */
+    Solace::Result<size_type, Solace::Error> readSome(Solace::ByteWriter& dest, size_type maxBytesToRead) override;
+
+    /** @see Channel::asyncReadv */
+    void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncWritev */
+    void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) override;
+
+    /** @see Channel::readv */
+    Solace::Result<void, Solace::Error> readv(ReadBuffers dests) override;
+
+    /** @see Channel::writev */
+    Solace::Result<void, Solace::Error> writev(WriteBuffers srcs) override;
+
+    /**
+     * @see Channel::asyncRead
+     * Calls this class implementation directly, bypassing virtual dispatch.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, F&& callback) {
+        auto& completion = makeCallbackCompletion(Pipe::getCompletionMemory(), std::forward<F>(callback));
+        Pipe::asyncRead(dest, bytesToRead, completion);
+    }
+
+    /**
+     * @see Channel::asyncWrite
+     * Calls this class implementation directly, bypassing virtual dispatch.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, F&& callback) {
+        auto& completion = makeCallbackCompletion(Pipe::getCompletionMemory(), std::forward<F>(callback));
+        Pipe::asyncWrite(src, bytesToWrite, completion);
+    }
+
     /** @see Channel::read */
     Solace::Result<void, Solace::Error> read(Solace::ByteWriter& dest, size_type bytesToRead) override;
 
@@ -76,6 +132,9 @@ public:
     Solace::Result<void, Solace::Error> write(Solace::ByteReader& src, size_type bytesToWrite) override;
 
 
+    /** @see Channel::bindTo */
+    void bindTo(Strand& strand) override;
+
     /** @see Channel::cancel */
     void cancel() override;
 
@@ -88,6 +147,12 @@ public:
     /** @see Channel::isClosed */
     bool isClosed() const override;
 
+    /** @see Channel::getNativeHandles */
+    NativeHandles getNativeHandles() override;
+
+    /** @see Channel::getCompletionMemory */
+    CompletionMemory* getCompletionMemory() noexcept override;
+
 
 private:
 
@@ -0,0 +1,92 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Relay of data between two channels
+ *	@file		cadence/async/relay.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_RELAY_HPP
+#define CADENCE_ASYNC_RELAY_HPP
+
+#include "cadence/async/channel.hpp"
+
+#include <memory>  // std::unique_ptr<>
+
+
+namespace cadence::async {
+
+/**
+ * Relay forwarding data between two stream channels in both directions, i.e. to implement a transparent proxy.
+ *
+ * Data is moved in the kernel with splice(2) through an internal pipe per direction, never copied into user space.
+ * Capacity of the pipes bounds the amount of data in flight in each direction.
+ * Channels that do not support splice, like terminals, fall back to copying data via a small buffer.
+ *
+ * When one channel reaches end of stream, writing to the other channel is shut down once all of the data
+ * has been forwarded, so half-closed connections are propagated through the relay.
+ * Channels that are not sockets, like pipes, can't be shut down: if such channel writes through a descriptor
+ * of its own, that descriptor is released instead, i.e. the write end of a pipe is closed and replaced with
+ * `/dev/null`. A channel reading and writing through a single descriptor, like a terminal, is left open.
+ *
+ * @note The relay puts descriptors of both channels into non-blocking mode.
+ * Channels must not be used for other IO while relayed and must outlive the relaying.
+ * Destroying a relay in progress stops it.
+ */
+class Relay {
+public:
+
+    using size_type = Channel::size_type;
+
+    static constexpr size_type kDefaultPipeCapacity = 64 * 1024;
+
+    /** Number of bytes forwarded in each direction. */
+    struct Counters {
+        Solace::uint64  aToB;
+        Solace::uint64  bToA;
+    };
+
+public:
+
+    ~Relay();
+
+    Relay(Relay const&) = delete;
+    Relay& operator= (Relay const&) = delete;
+
+    /**
+     * Construct a relay between two channels.
+     * @param loop Event loop to drive the relay.
+     * @param a First channel.
+     * @param b Second channel.
+     * @param pipeCapacity Maximum number of bytes in flight in each direction.
+     */
+    Relay(EventLoop& loop, Channel& a, Channel& b, size_type pipeCapacity = kDefaultPipeCapacity);
+
+    /**
+     * Start relaying data between the channels. A relay can only be run once.
+     * @return A future that will be resolved once both channels reached end of stream and all of the data
+     * has been forwarded, or with the first error that occurred in either direction.
+     */
+    Solace::Future<void> asyncRun();
+
+    /**
+     * Stop relaying. A relay in progress fails with operation aborted error.
+     */
+    void cancel();
+
+    /** Get number of bytes forwarded so far. */
+    Counters getCounters() const noexcept;
+
+private:
+
+    class RelayImpl;
+    std::unique_ptr<RelayImpl> _pimpl;
+};
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_RELAY_HPP
@@ -45,6 +45,13 @@ public:
 
     Solace::Future<int> asyncWait();
 
+    /**
+     * Wait for a signal reporting the outcome into the caller owned completion record.
+     * The number of the signal delivered is reported as the value of the completion.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    void asyncWait(AsyncCompletion& completion);
+
 private:
     class SignalSetImpl;
     std::unique_ptr<SignalSetImpl> _pimpl;
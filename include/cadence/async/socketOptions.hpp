@@ -0,0 +1,90 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Socket tuning options
+ *	@file		cadence/async/socketOptions.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_SOCKETOPTIONS_HPP
+#define CADENCE_ASYNC_SOCKETOPTIONS_HPP
+
+#include <solace/types.hpp>
+#include <solace/result.hpp>
+#include <solace/error.hpp>
+
+#include <type_traits>
+
+
+namespace cadence::async {
+
+/**
+ * Socket level and protocol level options supported by sockets and acceptors.
+ */
+enum class SocketOptionName {
+    NoDelay,                //!< TCP_NODELAY: disable Nagle's algorithm.
+    QuickAck,               //!< TCP_QUICKACK: send ACKs immediately. Reset by the kernel, re-apply as needed.
+    Cork,                   //!< TCP_CORK: hold partial frames until uncorked.
+    SendBufferSize,         //!< SO_SNDBUF: size of the kernel send buffer in bytes.
+    ReceiveBufferSize,      //!< SO_RCVBUF: size of the kernel receive buffer in bytes.
+    BusyPoll,               //!< SO_BUSY_POLL: time to busy poll the device queue on blocking receive, in microseconds.
+    Priority,               //!< SO_PRIORITY: protocol defined priority of the packets sent.
+    NotSentLowWatermark,    //!< TCP_NOTSENT_LOWAT: limit of unsent data before the socket reports writable, in bytes.
+    KeepAlive,              //!< SO_KEEPALIVE: send keep-alive probes on idle connections.
+    ReusePort               //!< SO_REUSEPORT: allow sockets to bind the same port, must be set before binding.
+};
+
+
+/**
+ * Typed socket option.
+ * Used to select option and its value type when setting or getting option values:
+ * @code
+ *  socket.setOption(NoDelay{}, true);
+ *  auto bufferSize = socket.getOption(ReceiveBufferSize{});
+ * @endcode
+ */
+template<SocketOptionName Name, typename T>
+struct SocketOption {
+    using value_type = T;
+
+    static constexpr SocketOptionName name = Name;
+};
+
+using NoDelay               = SocketOption<SocketOptionName::NoDelay, bool>;
+using QuickAck              = SocketOption<SocketOptionName::QuickAck, bool>;
+using Cork                  = SocketOption<SocketOptionName::Cork, bool>;
+using SendBufferSize        = SocketOption<SocketOptionName::SendBufferSize, Solace::int32>;
+using ReceiveBufferSize     = SocketOption<SocketOptionName::ReceiveBufferSize, Solace::int32>;
+using BusyPoll              = SocketOption<SocketOptionName::BusyPoll, Solace::int32>;
+using Priority              = SocketOption<SocketOptionName::Priority, Solace::int32>;
+using NotSentLowWatermark   = SocketOption<SocketOptionName::NotSentLowWatermark, Solace::int32>;
+using KeepAlive             = SocketOption<SocketOptionName::KeepAlive, bool>;
+using ReusePort             = SocketOption<SocketOptionName::ReusePort, bool>;
+
+
+/**
+ * Convert raw value of a socket option into the option value type.
+ */
+template<typename Option>
+Solace::Result<typename Option::value_type, Solace::Error>
+toOptionValue(Solace::Result<Solace::int32, Solace::Error>&& rawValue) {
+    using value_type = typename Option::value_type;
+
+    if (!rawValue) {
+        return Solace::Err(rawValue.getError());
+    }
+
+    if constexpr (std::is_same_v<value_type, bool>) {
+        return Solace::Ok(rawValue.unwrap() != 0);
+    } else {
+        return Solace::Ok(static_cast<value_type>(rawValue.unwrap()));
+    }
+}
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_SOCKETOPTIONS_HPP
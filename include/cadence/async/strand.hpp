@@ -0,0 +1,101 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Strand - serialised execution of handlers
+ *	@file		cadence/async/strand.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_STRAND_HPP
+#define CADENCE_ASYNC_STRAND_HPP
+
+#include "cadence/async/eventloop.hpp"
+
+
+namespace cadence::async {
+
+/**
+ * Strand guarantees that none of the handlers submitted through it are executed concurrently,
+ * even if the event loop is run by multiple threads.
+ *
+ * Bind a channel to a strand (@see Channel::bindTo) to have completions of all of its async operations
+ * serialised without the need for a mutex. A strand is cheap when uncontended: a completion delivered
+ * while no other handler of the strand is executing runs immediately on the thread that received it.
+ *
+ * @note A strand must outlive all the channels bound to it.
+ */
+class Strand {
+public:
+
+    ~Strand();
+
+    Strand(Strand const& rhs) = delete;
+    Strand& operator= (Strand const& rhs) = delete;
+
+    Strand(Strand&& rhs) noexcept;
+
+    Strand& operator= (Strand&& rhs) noexcept {
+        return swap(rhs);
+    }
+
+    /**
+     * Construct a new strand to execute handlers on the given event loop.
+     * @param ioContext Event loop to execute handlers on.
+     */
+    Strand(EventLoop& ioContext);
+
+    Strand& swap(Strand& rhs) noexcept;
+
+    EventLoop& getIOContext() noexcept {
+        return *_ioContext;
+    }
+
+    EventLoop const& getIOContext() const noexcept {
+        return *_ioContext;
+    }
+
+    /**
+     * Submit a task to be executed by the strand.
+     * The task is never executed inside this call. This method is thread-safe.
+     *
+     * @param task A callable to execute.
+     */
+    void post(Task&& task);
+
+    /**
+     * Submit a task to be executed by the strand.
+     * If called from a handler already executing in this strand the task is executed immediately,
+     * otherwise it is posted as if by `post()`.
+     *
+     * @param task A callable to execute.
+     */
+    void dispatch(Task&& task);
+
+    /**
+     * Test if the calling thread is executing a handler of this strand.
+     * @return True if this method is called from a handler executed by this strand.
+     */
+    bool isRunningInThisThread() const noexcept;
+
+    void* getExecutor() noexcept;
+
+private:
+
+    EventLoop*  _ioContext;
+
+    class StrandImpl;
+    std::unique_ptr<StrandImpl> _pimpl;
+};
+
+
+inline void swap(Strand& lhs, Strand& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_STRAND_HPP
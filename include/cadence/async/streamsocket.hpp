@@ -18,32 +18,82 @@
 #define CADENCE_ASYNC_STREAMSOCKET_HPP
 
 #include "cadence/async/channel.hpp"
+#include "cadence/async/socketOptions.hpp"
 #include "cadence/networkEndpoint.hpp"
+#include "cadence/io/selectable.hpp"
+
+#include <functional>
+#include <memory>
 
 
 
 namespace cadence { namespace async {
 
+class EventLoopGroup;
+
 /**
  * Base class for stream-oriented sockets
+ *
+ * Async writes may be posted while previous ones are still in progress: such writes are queued
+ * and written out together by a single gathered write once the socket is ready for more data.
+ * Data is sent in the order writes were posted and each write is notified individually.
+ * A gather write by `asyncWritev` is queued as a single write: its buffers are sent back to back.
+ * Closing or destroying the socket fails writes still queued or in flight with ECANCELED.
  */
 class StreamSocket :
         public Channel {
+private:
+    struct ShutdownState;
+
 public:
 
     using Channel::size_type;
 
+    /** Callback notified of the total number of bytes sent so far by a file transfer. */
+    using SendFileProgress = std::function<void(Solace::uint64 bytesSent)>;
+
+    /** Counters of zero-copy sends made by a socket. */
+    struct ZeroCopyStats {
+        Solace::uint64  sends{0};       //!< Number of send calls made without copying.
+        Solace::uint64  released{0};    //!< Number of those sends the kernel has released memory of.
+        Solace::uint64  copied{0};      //!< Number of released sends the kernel had to copy anyway, i.e. over loopback.
+    };
+
+    /**
+     * Handle to shut a socket down from elsewhere, i.e. by a server cancelling sessions it handed sockets to.
+     * The handle is disarmed once the socket is closed, destroyed or assigned over,
+     * so it never reaches a descriptor reused since.
+     */
+    class ShutdownHandle {
+    public:
+
+        ShutdownHandle() noexcept = default;
+
+        /** Shut the socket down in both directions, failing its IO in progress. Safe to call from any thread. */
+        void shutdown() const;
+
+    private:
+        friend class StreamSocket;
+
+        explicit ShutdownHandle(std::shared_ptr<ShutdownState> state) noexcept
+            : _state(std::move(state))
+        {}
+
+        std::shared_ptr<ShutdownState>  _state;
+    };
+
     ~StreamSocket() override;
 
     StreamSocket(StreamSocket const &) = delete;
     StreamSocket& operator= (StreamSocket const& ) = delete;
 
     StreamSocket(StreamSocket&& rhs) = default;
-    StreamSocket& operator= (StreamSocket&& rhs) noexcept = default;
+    StreamSocket& operator= (StreamSocket&& rhs) noexcept;
 
     StreamSocket& swap(StreamSocket& rhs) noexcept {
         using std::swap;
         swap(_pimpl, rhs._pimpl);
+        swap(_shutdown, rhs._shutdown);
 
         return *this;
     }
@@ -51,6 +101,10 @@ public:
 
     using Channel::asyncRead;
     using Channel::asyncWrite;
+    using Channel::asyncReadSome;
+    using Channel::readSome;
+    using Channel::asyncReadv;
+    using Channel::asyncWritev;
     using Channel::read;
     using Channel::write;
 
@@ -74,9 +128,70 @@ public:
      * @return A future that will be resolved one the scpecified number of bytes has been written into the IO object.
      *
      * @note If the provided source buffer does not have requested amount of data - an exception is raised.
+     * @note Writes posted before this one completes are queued, @see StreamSocket.
+     * Gather writes by `asyncWritev` are queued too, each as a single write.
      */
     Solace::Future<void> asyncWrite(Solace::ByteReader& src, size_type bytesToWrite) override;
 
+    /** @see Channel::asyncRead */
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncWrite */
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncRead */
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, Deadline deadline,
+                   AsyncCompletion& completion) override;
+
+    /**
+     * @see Channel::asyncWrite
+     * @note A queued write that expires is removed from the queue. A write that expires while being sent
+     * aborts the send, failing writes coalesced with it, as a stream can not be resumed part way through.
+     */
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, Deadline deadline,
+                    AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncReadSome */
+    void asyncReadSome(Solace::ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) override;
+
+    /** @see Channel::readSome */
+    Solace::Result<size_type, Solace::Error> readSome(Solace::ByteWriter& dest, size_type maxBytesToRead) override;
+
+    /** @see Channel::asyncReadv */
+    void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncWritev */
+    void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) override;
+
+    /** @see Channel::readv */
+    Solace::Result<void, Solace::Error> readv(ReadBuffers dests) override;
+
+    /** @see Channel::writev */
+    Solace::Result<void, Solace::Error> writev(WriteBuffers srcs) override;
+
+    /**
+     * @see Channel::asyncRead
+     * Calls this class implementation directly, bypassing virtual dispatch.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, F&& callback) {
+        auto& completion = makeCallbackCompletion(StreamSocket::getCompletionMemory(), std::forward<F>(callback));
+        StreamSocket::asyncRead(dest, bytesToRead, completion);
+    }
+
+    /**
+     * @see Channel::asyncWrite
+     * Calls this class implementation directly, bypassing virtual dispatch.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, F&& callback) {
+        auto& completion = makeCallbackCompletion(StreamSocket::getCompletionMemory(), std::forward<F>(callback));
+        StreamSocket::asyncWrite(src, bytesToWrite, completion);
+    }
+
+    /** @see Channel::bindTo */
+    void bindTo(Strand& strand) override;
+
     /** @see Channel::cancel */
     void cancel() override;
 
@@ -89,6 +204,12 @@ public:
     /** @see Channel::isClosed */
     bool isClosed() const override;
 
+    /** @see Channel::getNativeHandles */
+    NativeHandles getNativeHandles() override;
+
+    /** @see Channel::getCompletionMemory */
+    CompletionMemory* getCompletionMemory() noexcept override;
+
 
     /** @see Channel::read */
     Solace::Result<void, Solace::Error> read(Solace::ByteWriter& dest, size_type bytesToRead) override;
@@ -113,6 +234,77 @@ public:
      */
     void shutdown();
 
+    /**
+     * Get a handle to shut the open socket down from elsewhere.
+     * @see ShutdownHandle
+     */
+    ShutdownHandle getShutdownHandle();
+
+    /**
+     * Set value of a socket option.
+     * @param option Option to set.
+     * @param value New value of the option.
+     * @return Result of the operation. Options not applicable to the socket protocol fail with an error.
+     */
+    Solace::Result<void, Solace::Error> setOption(SocketOptionName option, Solace::int32 value);
+
+    /**
+     * Get value of a socket option.
+     * @param option Option to get.
+     * @return Current value of the option or an error.
+     */
+    Solace::Result<Solace::int32, Solace::Error> getOption(SocketOptionName option);
+
+    /** Set value of a typed socket option, i.e. `setOption(NoDelay{}, true)`. */
+    template<typename Option>
+    Solace::Result<void, Solace::Error> setOption(Option, typename Option::value_type value) {
+        return setOption(Option::name, static_cast<Solace::int32>(value));
+    }
+
+    /** Get value of a typed socket option, i.e. `getOption(ReceiveBufferSize{})`. */
+    template<typename Option>
+    Solace::Result<typename Option::value_type, Solace::Error> getOption(Option) {
+        return toOptionValue<Option>(getOption(Option::name));
+    }
+
+    /**
+     * Send large writes without copying data into the kernel, using MSG_ZEROCOPY.
+     * Queued writes totalling at least the threshold are sent from the caller's buffers directly,
+     * and writes complete only once the kernel has released the buffers, i.e. when the peer acknowledged the data.
+     * Writes queued meanwhile are sent without waiting for that, so throughput is not bound by the round trip.
+     * Smaller writes are copied as usual, as pinning pages costs more than copying a few kilobytes.
+     *
+     * @note Closing the socket disables zero-copy sends.
+     *
+     * @param threshold Minimum size of a write in bytes to send without copying. Zero disables zero-copy sends.
+     * @return Result of the operation. Fails if the socket or the platform does not support zero-copy sends.
+     */
+    Solace::Result<void, Solace::Error> setZeroCopyThreshold(size_type threshold);
+
+    /**
+     * Get counters of zero-copy sends, i.e. to check if data is actually sent without copying.
+     * If most sends are copied by the kernel anyway, zero-copy only adds overhead and is better disabled.
+     */
+    ZeroCopyStats getZeroCopyStats() const;
+
+    /**
+     * Post an async request to send content of a file into this socket.
+     * Data is moved from the file into the socket by the kernel with sendfile(2), without copying into user space.
+     * The transfer proceeds each time the socket becomes writable.
+     *
+     * @param source File or shared memory segment to send data from. Must stay open until the transfer completes.
+     * @param offset Offset in the source to start sending from.
+     * @param length Number of bytes to send.
+     * @param progress Optional callback notified with the number of bytes sent so far as the transfer progresses.
+     * @return A future that will be resolved with the number of bytes sent.
+     * Less than requested is sent only if the source is shorter than offset + length.
+     *
+     * @note The transfer must not overlap with other writes to the socket.
+     */
+    Solace::Future<Solace::uint64>
+    asyncSendFile(ISelectable const& source, Solace::uint64 offset, Solace::uint64 length,
+                  SendFileProgress progress = {});
+
 
     /**
      * Start an syncronous connection to the given endpoint.
@@ -129,6 +321,15 @@ public:
      */
     Solace::Future<void> asyncConnect(NetworkEndpoint const& endpoint);
 
+    /**
+     * Start an asynchronous connection to the given endpoint that must complete by the given deadline.
+     * If the connection has not been established by then, the attempt is cancelled and fails with ETIMEDOUT.
+     * @param endpoint An endpoint to connect to.
+     * @param deadline Point in time by which the connection must be established.
+     * @return Future that is resolved when connection is establised or an error occured.
+     */
+    Solace::Future<void> asyncConnect(NetworkEndpoint const& endpoint, Deadline deadline);
+
 
 public:
 
@@ -145,6 +346,41 @@ public:
         Solace::Future<void>
         asyncWrite(Solace::ByteReader& src, size_type bytesToWrite) = 0;
 
+        virtual
+        void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) = 0;
+
+        virtual
+        void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) = 0;
+
+        virtual
+        void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, Deadline deadline,
+                       AsyncCompletion& completion) = 0;
+
+        virtual
+        void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, Deadline deadline,
+                        AsyncCompletion& completion) = 0;
+
+        virtual
+        void asyncReadSome(Solace::ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) = 0;
+
+        virtual
+        Solace::Result<size_type, Solace::Error>
+        readSome(Solace::ByteWriter& dest, size_type maxBytesToRead) = 0;
+
+        virtual
+        void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) = 0;
+
+        virtual
+        void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) = 0;
+
+        virtual
+        Solace::Result<void, Solace::Error>
+        readv(ReadBuffers dests) = 0;
+
+        virtual
+        Solace::Result<void, Solace::Error>
+        writev(WriteBuffers srcs) = 0;
+
         virtual
         Solace::Result<void, Solace::Error>
         read(Solace::ByteWriter& dest, size_type bytesToRead) = 0;
@@ -153,6 +389,9 @@ public:
         Solace::Result<void, Solace::Error>
         write(Solace::ByteReader& src, size_type bytesToWrite) = 0;
 
+        virtual
+        void bindTo(Strand& strand) = 0;
+
         virtual
         void cancel() = 0;
 
@@ -165,18 +404,47 @@ public:
         virtual
         bool isClosed() const = 0;
 
+        virtual
+        int nativeHandle() = 0;
+
+        virtual
+        CompletionMemory* getCompletionMemory() noexcept = 0;
+
         virtual
         NetworkEndpoint getLocalEndpoint() const = 0;
 
         virtual
         NetworkEndpoint getRemoteEndpoint() const = 0;
 
+        virtual
+        Solace::Result<void, Solace::Error>
+        setOption(SocketOptionName option, Solace::int32 value) = 0;
+
+        virtual
+        Solace::Result<Solace::int32, Solace::Error>
+        getOption(SocketOptionName option) = 0;
+
+        virtual
+        Solace::Result<void, Solace::Error>
+        setZeroCopyThreshold(size_type threshold) = 0;
+
+        virtual
+        ZeroCopyStats getZeroCopyStats() const = 0;
+
+        virtual
+        Solace::Future<Solace::uint64>
+        asyncSendFile(ISelectable::poll_id fileFd, Solace::uint64 offset, Solace::uint64 length,
+                      SendFileProgress&& progress) = 0;
+
         virtual
         void shutdown() = 0;
 
         virtual Solace::Future<void>
         asyncConnect(NetworkEndpoint const& endpoint) = 0;
 
+        virtual Solace::Future<void>
+        asyncConnect(NetworkEndpoint const& endpoint, Deadline deadline) = 0;
+
         virtual Solace::Result<void, Solace::Error>
         connect(NetworkEndpoint const& endpoint) = 0;
 
@@ -185,7 +453,12 @@ public:
     StreamSocket(EventLoop& ioContext, std::unique_ptr<StreamSocketImpl> impl);
 
 private:
+
+    /** Disarm shutdown handles, before the descriptor is closed. */
+    void disarmShutdown() noexcept;
+
     std::unique_ptr<StreamSocketImpl> _pimpl;
+    std::shared_ptr<ShutdownState>    _shutdown;  //!< Shared with shutdown handles while the socket is open.
 
 };
 
@@ -198,6 +471,18 @@ inline void swap(StreamSocket& lhs, StreamSocket& rhs) noexcept {
 StreamSocket createTCPSocket(EventLoop& loop);
 StreamSocket createUnixSocket(EventLoop& loop);
 
+/**
+ * Create a new socket bound to an event loop selected from the group.
+ * @see EventLoopGroup::next
+ */
+StreamSocket createTCPSocket(EventLoopGroup& group);
+
+/**
+ * Create a new socket bound to an event loop selected from the group.
+ * @see EventLoopGroup::next
+ */
+StreamSocket createUnixSocket(EventLoopGroup& group);
+
 
 }  // End of namespace async
 }  // End of namespace cadence
@@ -0,0 +1,167 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Type-erased callable with small buffer storage
+ *	@file		cadence/async/task.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_TASK_HPP
+#define CADENCE_ASYNC_TASK_HPP
+
+#include <cstddef>      // std::max_align_t
+#include <new>          // placement new
+#include <type_traits>
+#include <utility>      // std::move, std::exchange
+
+
+namespace cadence::async {
+
+/**
+ * A move-only type-erased `void()` callable.
+ *
+ * Unlike std::function, Task can hold move-only callables, such as lambdas capturing a Promise.
+ * Callables that fit into `kInlineSize` bytes and are no-throw movable are stored in-place,
+ * without any memory allocation. Bigger callables are stored on the heap.
+ */
+class Task {
+public:
+
+    //!< Size of in-place storage for captured state.
+    static constexpr std::size_t kInlineSize = 6 * sizeof(void*);
+
+    //!< Test if a callable of type F can be stored without memory allocation.
+    template<typename F>
+    static constexpr bool isStoredInline = (sizeof(F) <= kInlineSize) &&
+            (alignof(F) <= alignof(std::max_align_t)) &&
+            std::is_nothrow_move_constructible_v<F>;
+
+public:
+
+    ~Task() {
+        reset();
+    }
+
+    Task() noexcept = default;
+
+    Task(Task const&) = delete;
+    Task& operator= (Task const&) = delete;
+
+    Task(Task&& rhs) noexcept
+        : _ops(std::exchange(rhs._ops, nullptr))
+    {
+        if (_ops) {
+            _ops->move(_storage, rhs._storage);
+        }
+    }
+
+    template<typename F,
+             typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F&& f)  // NOLINT(runtime/explicit): Task is implicitly constructible from a callable
+        : _ops(&OpsFor<std::decay_t<F>>::ops)
+    {
+        OpsFor<std::decay_t<F>>::construct(_storage, std::forward<F>(f));
+    }
+
+    Task& operator= (Task&& rhs) noexcept {
+        if (this != &rhs) {
+            reset();
+            _ops = std::exchange(rhs._ops, nullptr);
+            if (_ops) {
+                _ops->move(_storage, rhs._storage);
+            }
+        }
+
+        return *this;
+    }
+
+    /**
+     * Test if this task holds a callable.
+     */
+    explicit operator bool() const noexcept {
+        return (_ops != nullptr);
+    }
+
+    /**
+     * Invoke stored callable.
+     * @note Calling an empty task is undefined behaviour.
+     */
+    void operator() () {
+        _ops->invoke(_storage);
+    }
+
+    /**
+     * Destroy stored callable if any.
+     */
+    void reset() noexcept {
+        if (_ops) {
+            std::exchange(_ops, nullptr)->destroy(_storage);
+        }
+    }
+
+private:
+
+    struct Ops {
+        void (*invoke)(void* self);
+        void (*move)(void* dest, void* src) noexcept;
+        void (*destroy)(void* self) noexcept;
+    };
+
+    template<typename F, bool Inline = isStoredInline<F>>
+    struct OpsFor {
+        template<typename A>
+        static void construct(void* storage, A&& f) {
+            new (storage) F(std::forward<A>(f));
+        }
+
+        static void invoke(void* self) {
+            (*static_cast<F*>(self))();
+        }
+
+        static void move(void* dest, void* src) noexcept {
+            new (dest) F(std::move(*static_cast<F*>(src)));
+            static_cast<F*>(src)->~F();
+        }
+
+        static void destroy(void* self) noexcept {
+            static_cast<F*>(self)->~F();
+        }
+
+        static constexpr Ops ops{&invoke, &move, &destroy};
+    };
+
+    template<typename F>
+    struct OpsFor<F, false> {
+        template<typename A>
+        static void construct(void* storage, A&& f) {
+            new (storage) F*(new F(std::forward<A>(f)));
+        }
+
+        static void invoke(void* self) {
+            (**static_cast<F**>(self))();
+        }
+
+        static void move(void* dest, void* src) noexcept {
+            new (dest) F*(*static_cast<F**>(src));
+        }
+
+        static void destroy(void* self) noexcept {
+            delete *static_cast<F**>(self);
+        }
+
+        static constexpr Ops ops{&invoke, &move, &destroy};
+    };
+
+private:
+
+    alignas(std::max_align_t) unsigned char     _storage[kInlineSize];
+    Ops const*                                  _ops{nullptr};
+};
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_TASK_HPP
@@ -56,6 +56,12 @@ public:
 
     Solace::Future<Solace::int64> asyncWait();
 
+    /**
+     * Wait for the timer to expire reporting the outcome into the caller owned completion record.
+     * @param completion Completion record to notify. Must stay alive until notified.
+     */
+    void asyncWait(AsyncCompletion& completion);
+
     Timer& setTimeout(duration_type timeoutDuration);
 
     time_type getTimeout() const;
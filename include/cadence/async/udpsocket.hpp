@@ -18,6 +18,7 @@
 #define CADENCE_ASYNC_UDPSOCKET_HPP
 
 #include "cadence/async/channel.hpp"
+#include "cadence/async/socketOptions.hpp"
 #include "cadence/ipendpoint.hpp"
 
 
@@ -49,6 +50,10 @@ public:
 
     using Channel::asyncRead;
     using Channel::asyncWrite;
+    using Channel::asyncReadSome;
+    using Channel::readSome;
+    using Channel::asyncReadv;
+    using Channel::asyncWritev;
     using Channel::read;
     using Channel::write;
 
@@ -96,6 +101,58 @@ public:
      */
     Solace::Future<void> asyncWrite(Solace::ByteReader& src, size_type bytesToWrite) override;
 
+    /** @see Channel::asyncRead */
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncWrite */
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncRead */
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, Deadline deadline,
+                   AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncWrite */
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, Deadline deadline,
+                    AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncReadSome */
+    void asyncReadSome(Solace::ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) override;
+
+    /** @see Channel::readSome */
+    Solace::Result<size_type, Solace::Error> readSome(Solace::ByteWriter& dest, size_type maxBytesToRead) override;
+
+    /** @see Channel::asyncReadv */
+    void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) override;
+
+    /** @see Channel::asyncWritev */
+    void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) override;
+
+    /** @see Channel::readv */
+    Solace::Result<void, Solace::Error> readv(ReadBuffers dests) override;
+
+    /** @see Channel::writev */
+    Solace::Result<void, Solace::Error> writev(WriteBuffers srcs) override;
+
+    /**
+     * @see Channel::asyncRead
+     * Calls this class implementation directly, bypassing virtual dispatch.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncRead(Solace::ByteWriter& dest, size_type bytesToRead, F&& callback) {
+        auto& completion = makeCallbackCompletion(UdpSocket::getCompletionMemory(), std::forward<F>(callback));
+        UdpSocket::asyncRead(dest, bytesToRead, completion);
+    }
+
+    /**
+     * @see Channel::asyncWrite
+     * Calls this class implementation directly, bypassing virtual dispatch.
+     */
+    template<typename F, typename = EnableIfCompletionCallback<F>>
+    void asyncWrite(Solace::ByteReader& src, size_type bytesToWrite, F&& callback) {
+        auto& completion = makeCallbackCompletion(UdpSocket::getCompletionMemory(), std::forward<F>(callback));
+        UdpSocket::asyncWrite(src, bytesToWrite, completion);
+    }
+
     /**
      * Post an async write request to write specified amount of data into this IO object.
      * This method writes whole content of the provided buffer into the IO objec.
@@ -116,6 +173,9 @@ public:
      */
     Solace::Future<void> asyncWriteTo(IPEndpoint const& dest, Solace::ByteReader& data, size_type bytesToWrite);
 
+    /** @see Channel::bindTo */
+    void bindTo(Strand& strand) override;
+
     /**
      * Cancel all asynchronous operations associated with the socket.
      */
@@ -150,6 +210,12 @@ public:
      */
     bool isClosed() const override;
 
+    /** @see Channel::getNativeHandles */
+    NativeHandles getNativeHandles() override;
+
+    /** @see Channel::getCompletionMemory */
+    CompletionMemory* getCompletionMemory() noexcept override;
+
     /**
      * Get the local endpoint of the socket.
      * @return Local endpoint this socket is bound to.
@@ -167,6 +233,33 @@ public:
      */
     void shutdown();
 
+    /**
+     * Set value of a socket option.
+     * @param option Option to set.
+     * @param value New value of the option.
+     * @return Result of the operation. Options not applicable to the socket protocol fail with an error.
+     */
+    Solace::Result<void, Solace::Error> setOption(SocketOptionName option, Solace::int32 value);
+
+    /**
+     * Get value of a socket option.
+     * @param option Option to get.
+     * @return Current value of the option or an error.
+     */
+    Solace::Result<Solace::int32, Solace::Error> getOption(SocketOptionName option);
+
+    /** Set value of a typed socket option, i.e. `setOption(NoDelay{}, true)`. */
+    template<typename Option>
+    Solace::Result<void, Solace::Error> setOption(Option, typename Option::value_type value) {
+        return setOption(Option::name, static_cast<Solace::int32>(value));
+    }
+
+    /** Get value of a typed socket option, i.e. `getOption(ReceiveBufferSize{})`. */
+    template<typename Option>
+    Solace::Result<typename Option::value_type, Solace::Error> getOption(Option) {
+        return toOptionValue<Option>(getOption(Option::name));
+    }
+
     /**
      * Open the socket if it was not opened alread.
      * @return Open result or an error.
@@ -19,12 +19,18 @@
 
 
 #include "async/eventloop.hpp"
+#include "async/eventLoopGroup.hpp"
 #include "async/streamsocket.hpp"
 #include "async/acceptor.hpp"
+#include "async/deadline.hpp"
 
 #include <solace/result.hpp>
+#include <solace/future.hpp>
 
 #include <functional>  // std::function
+#include <memory>
+#include <type_traits>
+#include <utility>  // std::exchange
 
 
 namespace cadence {
@@ -33,31 +39,231 @@ namespace cadence {
  * Asynchronious data server that server.
  */
 class AsyncServer {
+private:
+    struct AdmissionControl;
+    struct SessionRecord;
+
 public:
+    using size_type = Solace::uint32;
+
+    /** Counters of sessions served by the server. */
+    struct SessionCounters {
+        Solace::uint64  accepted;   //!< Number of sessions accepted.
+        Solace::uint64  closed;     //!< Number of sessions that released their ticket.
+        size_type       active;     //!< Number of sessions that hold a ticket.
+    };
+
+    /**
+     * Admission of an accepted session to the server.
+     * A session counts towards the limit of concurrent sessions for as long as its ticket lives,
+     * so the ticket should be kept with the session and destroyed, or released, once the session is closed.
+     *
+     * The ticket also registers the session with the server, so the server can cancel it when draining
+     * by shutting the socket of the session down. Once the socket is closed the server leaves it alone.
+     */
+    class SessionTicket {
+    public:
+
+        ~SessionTicket() {
+            release();
+        }
+
+        SessionTicket() noexcept = default;
+
+        SessionTicket(SessionTicket const&) = delete;
+        SessionTicket& operator= (SessionTicket const&) = delete;
+
+        SessionTicket(SessionTicket&& rhs) noexcept
+            : _admission(std::move(rhs._admission))
+            , _record(std::exchange(rhs._record, nullptr))
+        {}
+
+        SessionTicket& operator= (SessionTicket&& rhs) noexcept {
+            if (this != &rhs) {
+                release();
+                _admission = std::move(rhs._admission);
+                _record = std::exchange(rhs._record, nullptr);
+            }
+
+            return *this;
+        }
+
+        /**
+         * Give the session slot back to the server. The server resumes accepting if it has been paused at the limit.
+         */
+        void release();
+
+        /**
+         * Check if the server is draining: the session should finish the request in progress and close.
+         */
+        bool isDraining() const noexcept;
+
+    private:
+        friend class AsyncServer;
+
+        SessionTicket(std::shared_ptr<AdmissionControl> admission, SessionRecord* record) noexcept
+            : _admission(std::move(admission))
+            , _record(record)
+        {}
+
+        std::shared_ptr<AdmissionControl>   _admission;
+        SessionRecord*                      _record{nullptr};
+    };
+
     using AcceptHandler = std::function<void(async::StreamSocket&&)>;
+    using SessionHandler = std::function<void(async::StreamSocket&&, SessionTicket&&)>;
+
+    /// Default maximum number of connections accepted per wake-up of an acceptor.
+    static constexpr async::Acceptor::size_type kDefaultAcceptBatchSize = 64;
+
+    /**
+     * Destroy the server: it stops accepting. Sessions keep their tickets and may outlive the server.
+     */
+    ~AsyncServer();
 
     // Non-copible
     AsyncServer(AsyncServer const&) = delete;
     AsyncServer& operator= (AsyncServer const&) = delete;
 
-    // Movable:
+    // Movable: acceptors are owned by the accept loops, not by the server object
     AsyncServer(AsyncServer&&) noexcept = default;
-    AsyncServer& operator= (AsyncServer&&) = default;
 
+    /**
+     * Take over the other server. This server is stopped first, as if by `stop()`.
+     */
+    AsyncServer& operator= (AsyncServer&& rhs) noexcept;
+
+    /**
+     * Construct a server calling the given handler for each new connection.
+     * The handler is either an AcceptHandler, or a SessionHandler that also takes the session ticket.
+     * Only sessions of handlers that keep the ticket are counted towards the limit of concurrent sessions
+     * after the handler returns.
+     *
+     * @param eventLoop Event loop to accept and serve connections.
+     * @param cb Handler of new connections.
+     */
     template<typename CB>
     AsyncServer(async::EventLoop& eventLoop, CB&& cb) :
-        _acceptor(eventLoop),
-        _connectionHandler(std::forward<CB>(cb))
+        _loop(eventLoop),
+        _connectionHandler(toSessionHandler(std::forward<CB>(cb)))
+    {}
+
+    /**
+     * Construct a server that distributes accepted connections between loops of the group.
+     * The acceptor itself is served by the first loop of the group and the handler is called on its thread.
+     * Accepted sockets are bound to the loop selected by the group, so all their completions run on that loop.
+     *
+     * @param loopGroup Group of event loops to assign new connections to.
+     * @param cb Handler of new connections.
+     */
+    template<typename CB>
+    AsyncServer(async::EventLoopGroup& loopGroup, CB&& cb) :
+        _loop(loopGroup[0]),
+        _sessionLoops(&loopGroup),
+        _connectionHandler(toSessionHandler(std::forward<CB>(cb)))
     {}
 
     Solace::Result<void, Solace::Error> startListen(NetworkEndpoint const& endpoint);
 
+    /**
+     * Start listening for connections on the given endpoint with the given options of the listening socket.
+     *
+     * If the server has been constructed with a group of event loops and `options.reusePort` is set,
+     * a listening socket is opened per loop of the group, all bound to the same endpoint via SO_REUSEPORT.
+     * The kernel then spreads incoming connections between the loops, rather than one acceptor serialising them,
+     * and each connection is accepted and served by the same loop.
+     * @note In this mode the handler is called concurrently from threads of all the loops.
+     *
+     * @param endpoint Endpoint to listen on.
+     * @param options Options of the listening sockets.
+     * @return Result of the operation.
+     */
+    Solace::Result<void, Solace::Error>
+    startListen(NetworkEndpoint const& endpoint, async::ListenOptions const& options);
+
+    /**
+     * Stop accepting new connections. Sessions already accepted are not affected.
+     * Acceptors are closed by their event loops: inside this call if made from a thread running the loop,
+     * otherwise once the loop runs again. Connections accepted meanwhile are dropped.
+     */
     void stop();
 
+    /**
+     * Gracefully shut the server down.
+     * The server stops accepting and sessions are let finish requests in progress: tickets report draining,
+     * so sessions can close once idle. Sessions still open by the deadline are cancelled by shutting down
+     * their sockets, which fails IO in progress so the sessions unwind and release their tickets.
+     *
+     * @param deadline Point in time by which sessions should have closed.
+     * @return Future resolved once all of the sessions have released their tickets.
+     * Fails with EALREADY if the server has been drained already.
+     */
+    Solace::Future<void> drain(async::Deadline deadline);
+
+    /**
+     * Set maximum number of pending connections accepted on each wake-up of an acceptor.
+     * All the connections of a batch are handed to the handler before the acceptor waits again,
+     * so larger batches reduce the number of reactor round-trips under a burst of connections.
+     * @note Takes effect when the server starts listening.
+     * @param batchSize Maximum number of connections to accept in one go.
+     */
+    void setAcceptBatchSize(async::Acceptor::size_type batchSize) noexcept {
+        _acceptBatchSize = batchSize;
+    }
+
+    /**
+     * Set maximum number of concurrent sessions.
+     * Once the limit is reached the server stops accepting, leaving new connections in the listen queue,
+     * and resumes when a session releases its ticket. This keeps latency of the sessions already being served
+     * bounded under overload.
+     * @note Takes effect when the server starts listening.
+     * @param maxSessions Maximum number of sessions, 0 for no limit.
+     */
+    void setMaxSessions(size_type maxSessions) noexcept {
+        _maxSessions = maxSessions;
+    }
+
+    /**
+     * Get number of sessions that hold a ticket.
+     */
+    size_type getActiveSessions() const noexcept;
+
+    /**
+     * Get counters of sessions accepted, closed and active.
+     */
+    SessionCounters getSessionCounters() const noexcept;
+
+    /**
+     * Get the local endpoint the server is listening on, i.e. to find out the port assigned by the system.
+     * @pre The server is listening.
+     * @return Local endpoint of the server.
+     */
+    NetworkEndpoint getLocalEndpoint() const;
+
+private:
+
+    template<typename CB>
+    static SessionHandler toSessionHandler(CB&& cb) {
+        if constexpr (std::is_invocable_v<std::decay_t<CB>&, async::StreamSocket&&, SessionTicket&&>) {
+            return SessionHandler{std::forward<CB>(cb)};
+        } else {
+            // Ticket is released as soon as the handler returns
+            return [handler = AcceptHandler{std::forward<CB>(cb)}](async::StreamSocket&& socket, SessionTicket&&) {
+                if (handler) {
+                    handler(std::move(socket));
+                }
+            };
+        }
+    }
+
 private:
 
-    async::Acceptor _acceptor;
-    AcceptHandler   _connectionHandler;
+    std::reference_wrapper<async::EventLoop>    _loop;
+    async::EventLoopGroup*          _sessionLoops{nullptr};
+    SessionHandler                  _connectionHandler;
+    async::Acceptor::size_type      _acceptBatchSize{kDefaultAcceptBatchSize};
+    size_type                       _maxSessions{0};
+    std::shared_ptr<AdmissionControl>   _admission;     //!< Acceptors, accept loops and sessions of the server.
 };
 
 }  // End of namespace cadence
@@ -0,0 +1,455 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Async server of typed sessions stored in place
+ *	@file		cadence/sessionServer.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_SESSIONSERVER_HPP
+#define CADENCE_SESSIONSERVER_HPP
+
+
+#include "async/eventloop.hpp"
+#include "async/eventLoopGroup.hpp"
+#include "async/streamsocket.hpp"
+#include "async/acceptor.hpp"
+#include "async/timer.hpp"
+
+#include <solace/result.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+
+namespace cadence {
+
+/**
+ * Async server that constructs an object of the given Session type for each accepted connection.
+ *
+ * Unlike AsyncServer, there is no type-erased handler and no reference counting on the accept path:
+ * session objects are constructed in place in nodes of a pool, allocated a slab at a time,
+ * and linked into an intrusive list of live sessions. Once a session closes its node is recycled,
+ * so churning short-lived connections does not allocate once the pool has grown to the working set.
+ *
+ * Session type requirements:
+ *  - Constructible from `(async::StreamSocket&&, SessionServer<Session>::Handle)`.
+ *    The constructor must not start any IO: it is started by `start()`.
+ *  - `void start()` is called once the session has been registered with the server.
+ *  - Once done, the session calls `close()` of its handle. The session object is destroyed by that call,
+ *    similar to `delete this`, so it must not be touched afterwards and must have no operations in flight.
+ *
+ * @code
+ *  class EchoSession {
+ *  public:
+ *      EchoSession(StreamSocket&& socket, SessionServer<EchoSession>::Handle handle);
+ *      void start();
+ *  };
+ *
+ *  SessionServer<EchoSession> server{loop};
+ *  server.startListen(endpoint);
+ * @endcode
+ */
+template<typename Session>
+class SessionServer {
+public:
+    using size_type = Solace::uint32;
+
+    /// Number of session nodes allocated at once when the pool runs out of free nodes.
+    static constexpr size_type kSlabSize = 64;
+
+    /// Default maximum number of connections accepted per wake-up of the acceptor.
+    static constexpr async::Acceptor::size_type kDefaultAcceptBatchSize = 64;
+
+    /// Delay before accepting again after an accept failure, i.e. when out of descriptors.
+    static constexpr async::Timer::duration_type kAcceptRetryDelay{100};
+
+private:
+
+    /** Pool node holding a session object and links of the list it is in. */
+    struct Node {
+        Node*   prev{nullptr};
+        Node*   next{nullptr};
+        std::aligned_storage_t<sizeof(Session), alignof(Session)>   storage;
+
+        Session& session() noexcept {
+            return *std::launder(reinterpret_cast<Session*>(&storage));
+        }
+    };
+
+    struct State;
+
+public:
+
+    /**
+     * Handle of a session given to the session on construction.
+     */
+    class Handle {
+    public:
+
+        /**
+         * Close the session: destroy the session object and recycle its memory.
+         * @note Must be the last thing the session does.
+         */
+        void close() const {
+            _state->closeSession(_node);
+        }
+
+    private:
+        friend class SessionServer;
+        friend struct State;
+
+        Handle(State* state, Node* node) noexcept
+            : _state(state)
+            , _node(node)
+        {}
+
+        State*  _state;
+        Node*   _node;
+    };
+
+public:
+
+    /**
+     * Destroy the server: it stops accepting, and accept or retry still pending complete without it.
+     * Sessions still open are not destroyed, as they may have IO in flight: they keep the pool alive
+     * and it is freed once the last of them closes. Sessions must therefore close on their own,
+     * i.e. once they notice the peer went away or have been cancelled via `forEachSession()`.
+     */
+    ~SessionServer() {
+        stop();
+        _state->disown();
+    }
+
+    // Non-copible, non-movable: sessions refer to the server via their handles
+    SessionServer(SessionServer const&) = delete;
+    SessionServer& operator= (SessionServer const&) = delete;
+
+    /**
+     * Construct a server accepting and serving connections by the given event loop.
+     * @param eventLoop Event loop to accept and serve connections.
+     */
+    explicit SessionServer(async::EventLoop& eventLoop)
+        : _state(std::make_shared<State>(eventLoop, nullptr))
+    {}
+
+    /**
+     * Construct a server that distributes accepted connections between loops of the group.
+     * The acceptor itself is served by the first loop of the group and sessions are constructed on its thread.
+     * @note Sessions served by other loops close from threads of those loops.
+     * @param loopGroup Group of event loops to assign new connections to.
+     */
+    explicit SessionServer(async::EventLoopGroup& loopGroup)
+        : _state(std::make_shared<State>(loopGroup[0], &loopGroup))
+    {}
+
+    /**
+     * Start listening for connections on the given endpoint.
+     * @param endpoint Endpoint to listen on.
+     * @param options Options of the listening socket.
+     * @return Result of the operation.
+     */
+    Solace::Result<void, Solace::Error>
+    startListen(NetworkEndpoint const& endpoint, async::ListenOptions const& options = {}) {
+        static_assert(std::is_constructible_v<Session, async::StreamSocket&&, Handle>,
+                      "Session must be constructible from a StreamSocket and a SessionServer<Session>::Handle");
+
+        auto result = _state->acceptor.open(endpoint, options);
+        if (!result) {
+            return result;
+        }
+
+        _state->listening = true;
+        _state->accept();
+
+        return result;
+    }
+
+    /**
+     * Stop accepting new connections. Sessions already open are not affected.
+     */
+    void stop() {
+        _state->stopped.store(true);
+
+        if (_state->listening) {
+            _state->acceptor.close();
+            _state->retryTimer.cancel();
+        }
+    }
+
+    /**
+     * Set maximum number of pending connections accepted on each wake-up of the acceptor.
+     * @note Takes effect with the next batch.
+     * @param batchSize Maximum number of connections to accept in one go.
+     */
+    void setAcceptBatchSize(async::Acceptor::size_type batchSize) noexcept {
+        _state->acceptBatchSize = batchSize;
+    }
+
+    /**
+     * Set maximum number of concurrent sessions.
+     * Once the limit is reached the server stops accepting and resumes when a session closes.
+     * @param maxSessions Maximum number of sessions, 0 for no limit.
+     */
+    void setMaxSessions(size_type maxSessions) noexcept {
+        _state->maxSessions = maxSessions;
+    }
+
+    /** Get number of open sessions. */
+    size_type getActiveSessions() const {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        return _state->activeSessions;
+    }
+
+    /** Get number of sessions the pool can hold without allocating. */
+    size_type getCapacity() const {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        return static_cast<size_type>(_state->slabs.size()) * kSlabSize;
+    }
+
+    /**
+     * Call the given function for each open session.
+     * @note Sessions are visited while holding the server lock: the function must not close sessions.
+     */
+    template<typename F>
+    void forEachSession(F&& f) {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        for (auto* node = _state->liveNodes; node; node = node->next) {
+            f(node->session());
+        }
+    }
+
+    /**
+     * Get the local endpoint the server is listening on, i.e. to find out the port assigned by the system.
+     * @return Local endpoint of the server.
+     */
+    NetworkEndpoint getLocalEndpoint() const {
+        return _state->acceptor.getLocalEndpoint();
+    }
+
+private:
+
+    /**
+     * Accept loop and pool of sessions.
+     * Owned by the server, by the accept, retry or resume pending, and once the server is gone by sessions still open.
+     */
+    struct State :
+            public async::AcceptBatchCompletion,
+            public std::enable_shared_from_this<State> {
+
+        State(async::EventLoop& eventLoop, async::EventLoopGroup* loopGroup)
+            : async::AcceptBatchCompletion(&State::onAccepted)
+            , loop(eventLoop)
+            , acceptor(eventLoop)
+            , sessionLoops(loopGroup)
+            , retryTimer(eventLoop)
+        {}
+
+        void accept() {
+            if (stopped.load()) {
+                return;
+            }
+
+            auto batch = acceptBatchSize;
+            if (maxSessions != 0) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (activeSessions >= maxSessions) {
+                    // Next session to close resumes accepting
+                    paused = true;
+                    return;
+                }
+
+                batch = std::min<async::Acceptor::size_type>(batch, maxSessions - activeSessions);
+            }
+
+            pending = this->shared_from_this();
+            if (sessionLoops) {
+                acceptor.asyncAcceptBatch(*sessionLoops, batch, *this);
+            } else {
+                acceptor.asyncAcceptBatch(batch, *this);
+            }
+        }
+
+        static void onAccepted(async::AsyncCompletion& completion) {
+            auto& state = static_cast<State&>(static_cast<async::AcceptBatchCompletion&>(completion));
+
+            // Accept is over: the state lives for as long as this call
+            auto const self = std::move(state.pending);
+            if (state.stopped.load()) {
+                // Connections accepted just as the server stopped are dropped
+                state.sockets.clear();
+                return;
+            }
+
+            if (state.isError()) {
+                state.onAcceptFailed();
+                return;
+            }
+
+            for (auto& socket : state.sockets) {
+                state.openSession(std::move(socket));
+            }
+            state.sockets.clear();
+
+            // Keep on accepting other sessions
+            state.accept();
+        }
+
+        void onAcceptFailed() {
+            if (!acceptor.isOpen()) {
+                return;
+            }
+
+            // Accepting right away would spin on the same error
+            retryTimer.setTimeout(kAcceptRetryDelay);
+            retryTimer.asyncWait()
+                    .then([self = this->shared_from_this()](Solace::int64) {
+                        self->accept();
+                    });
+        }
+
+        void openSession(async::StreamSocket&& socket) {
+            auto* node = acquireNode();
+
+            try {
+                ::new (&node->storage) Session(std::move(socket), Handle{this, node});
+            } catch (...) {
+                releaseNode(node);
+                throw;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                link(node);
+            }
+
+            node->session().start();
+        }
+
+        void closeSession(Node* node) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                unlink(node);
+            }
+
+            node->session().~Session();
+            releaseNode(node);
+        }
+
+        /** Server is being destroyed: sessions still open keep the state alive until the last one closes. */
+        void disown() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (activeSessions != 0) {
+                orphan = this->shared_from_this();
+            }
+        }
+
+        Node* acquireNode() {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (!freeNodes) {
+                auto slab = std::make_unique<Node[]>(kSlabSize);
+                for (size_type i = 0; i < kSlabSize; ++i) {
+                    slab[i].next = freeNodes;
+                    freeNodes = &slab[i];
+                }
+
+                slabs.emplace_back(std::move(slab));
+            }
+
+            auto* node = freeNodes;
+            freeNodes = node->next;
+            node->next = nullptr;
+            activeSessions += 1;
+
+            return node;
+        }
+
+        void releaseNode(Node* node) {
+            std::shared_ptr<State> last;  // Released once the lock is
+            bool resume = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                node->prev = nullptr;
+                node->next = freeNodes;
+                freeNodes = node;
+                activeSessions -= 1;
+
+                resume = paused && !stopped.load();
+                paused = false;
+
+                if (activeSessions == 0) {
+                    last = std::move(orphan);
+                }
+            }
+
+            if (resume) {
+                loop.post([self = this->shared_from_this()]() {
+                    self->accept();
+                });
+            }
+        }
+
+        /** Link node into the list of live sessions. Must be called with the lock held. */
+        void link(Node* node) noexcept {
+            node->prev = nullptr;
+            node->next = liveNodes;
+            if (liveNodes) {
+                liveNodes->prev = node;
+            }
+
+            liveNodes = node;
+        }
+
+        /** Unlink node from the list of live sessions. Must be called with the lock held. */
+        void unlink(Node* node) noexcept {
+            if (node->prev) {
+                node->prev->next = node->next;
+            } else {
+                liveNodes = node->next;
+            }
+
+            if (node->next) {
+                node->next->prev = node->prev;
+            }
+
+            node->prev = nullptr;
+            node->next = nullptr;
+        }
+
+        async::EventLoop&               loop;
+        async::Acceptor                 acceptor;
+        async::EventLoopGroup*          sessionLoops;
+        async::Timer                    retryTimer;
+        async::Acceptor::size_type      acceptBatchSize{kDefaultAcceptBatchSize};
+        size_type                       maxSessions{0};
+        bool                            listening{false};
+        std::atomic<bool>               stopped{false};
+        std::shared_ptr<State>          pending;            //!< Held by the accept in progress.
+
+        mutable std::mutex              mutex;              //!< Guards the pool, the list of sessions and the counters.
+        std::vector<std::unique_ptr<Node[]>>    slabs;
+        Node*                           freeNodes{nullptr}; //!< Free list of nodes, linked via `next`.
+        Node*                           liveNodes{nullptr}; //!< List of open sessions.
+        size_type                       activeSessions{0};
+        bool                            paused{false};      //!< Accepting stopped at the limit of sessions.
+        std::shared_ptr<State>          orphan;             //!< Held by sessions open when the server was destroyed.
+    };
+
+private:
+
+    std::shared_ptr<State>  _state;
+};
+
+}  // End of namespace cadence
+#endif  // CADENCE_SESSIONSERVER_HPP
@@ -0,0 +1,84 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/acceptPending.cpp
+ *******************************************************************************/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // accept4
+#endif
+
+#include "acceptPending.hpp"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+int acceptOne(int listenHandle) {
+#if defined(__linux__)
+    return ::accept4(listenHandle, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+    auto const handle = ::accept(listenHandle, nullptr, nullptr);
+    if (handle < 0) {
+        return handle;
+    }
+
+    auto const flags = ::fcntl(handle, F_GETFL);
+    if (flags < 0 ||
+        ::fcntl(handle, F_SETFL, flags | O_NONBLOCK) != 0 ||
+        ::fcntl(handle, F_SETFD, FD_CLOEXEC) != 0) {
+        auto const error = errno;
+        ::close(handle);
+        errno = error;
+        return -1;
+    }
+
+    return handle;
+#endif
+}
+
+}  // namespace
+
+
+int
+cadence::async::acceptPending(int listenHandle, std::size_t maxConnections, std::vector<int>& accepted) {
+    for (std::size_t i = 0; i < maxConnections; ) {
+        auto const handle = acceptOne(listenHandle);
+        if (handle >= 0) {
+            accepted.push_back(handle);
+            ++i;
+            continue;
+        }
+
+        switch (errno) {
+        case EINTR:
+        case ECONNABORTED:
+        case EPROTO:
+            // Connection reset before it was accepted: try the next one
+            continue;
+        case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+            return 0;
+        default:
+            return errno;
+        }
+    }
+
+    return 0;
+}
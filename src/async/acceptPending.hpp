@@ -0,0 +1,36 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Draining of pending connections of a listening socket
+ *	@file		async/acceptPending.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_ACCEPTPENDING_HPP
+#define CADENCE_ASYNC_ACCEPTPENDING_HPP
+
+#include <cstddef>
+#include <vector>
+
+
+namespace cadence::async {
+
+/**
+ * Accept connections already pending on a listening socket, without waiting for more to arrive.
+ * Accepted descriptors are non-blocking and close-on-exec.
+ * Connections aborted by the peer before they could be accepted are skipped.
+ *
+ * @param listenHandle Native handle of the listening socket. Must be in non-blocking mode.
+ * @param maxConnections Maximum number of connections to accept.
+ * @param accepted Vector to append native handles of the accepted connections to. The caller owns them.
+ * @return 0 if the queue has been drained or the limit reached, error code of the failed accept otherwise.
+ */
+int acceptPending(int listenHandle, std::size_t maxConnections, std::vector<int>& accepted);
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_ACCEPTPENDING_HPP
@@ -18,6 +18,74 @@ using namespace cadence;
 using namespace cadence::async;
 
 
+namespace {
+
+/**
+ * Accept completion record that resolves a promise and releases itself once notified.
+ */
+class AcceptPromiseCompletion :
+        public AcceptCompletion {
+public:
+
+    static AcceptCompletion& create(Promise<StreamSocket>&& promise) {
+        return *new AcceptPromiseCompletion(std::move(promise));
+    }
+
+private:
+
+    explicit AcceptPromiseCompletion(Promise<StreamSocket>&& promise)
+        : AcceptCompletion(&AcceptPromiseCompletion::resolve)
+        , _promise(std::move(promise))
+    {}
+
+    static void resolve(AsyncCompletion& self) {
+        std::unique_ptr<AcceptPromiseCompletion> completion{static_cast<AcceptPromiseCompletion*>(&self)};
+
+        if (completion->isError()) {
+            completion->_promise.setError(completion->getError());
+        } else {
+            completion->_promise.setValue(std::move(*completion->socket));
+        }
+    }
+
+    Promise<StreamSocket> _promise;
+};
+
+
+/**
+ * Batch accept completion record that resolves a promise and releases itself once notified.
+ */
+class AcceptBatchPromiseCompletion :
+        public AcceptBatchCompletion {
+public:
+
+    static AcceptBatchCompletion& create(Promise<std::vector<StreamSocket>>&& promise) {
+        return *new AcceptBatchPromiseCompletion(std::move(promise));
+    }
+
+private:
+
+    explicit AcceptBatchPromiseCompletion(Promise<std::vector<StreamSocket>>&& promise)
+        : AcceptBatchCompletion(&AcceptBatchPromiseCompletion::resolve)
+        , _promise(std::move(promise))
+    {}
+
+    static void resolve(AsyncCompletion& self) {
+        std::unique_ptr<AcceptBatchPromiseCompletion> completion{static_cast<AcceptBatchPromiseCompletion*>(&self)};
+
+        if (completion->isError()) {
+            completion->_promise.setError(completion->getError());
+        } else {
+            completion->_promise.setValue(std::move(completion->sockets));
+        }
+    }
+
+    Promise<std::vector<StreamSocket>> _promise;
+};
+
+}  // namespace
+
+
 
 std::unique_ptr<Acceptor::AcceptorImpl> createTCPAcceptor(EventLoop& loop);
 std::unique_ptr<Acceptor::AcceptorImpl> createUnixDomainAcceptor(EventLoop& loop);
@@ -32,6 +100,12 @@ Acceptor::Acceptor(EventLoop& ioContext)
 
 Result<void, Error>
 Acceptor::open(NetworkEndpoint const& endpoint) {
+    return open(endpoint, ListenOptions{});
+}
+
+
+Result<void, Error>
+Acceptor::open(NetworkEndpoint const& endpoint, ListenOptions const& options) {
     if (_pimpl) {
         return Err(makeError(SystemErrors::ISCONN, "Acceptor::open"));
     }
@@ -47,7 +121,7 @@ Acceptor::open(NetworkEndpoint const& endpoint) {
 
     }, endpoint);
 
-    return _pimpl->open(endpoint);
+    return _pimpl->open(endpoint, options);
 }
 
 
@@ -65,25 +139,48 @@ void Acceptor::nativeNonBlocking(bool mode) {
 
 
 void Acceptor::cancel() {
-    _pimpl->cancel();
+    if (_pimpl) {
+        _pimpl->cancel();
+    }
 }
 
 void Acceptor::close() {
-    _pimpl->close();
+    // Note: Acceptor that has never been opened has nothing to close
+    if (_pimpl) {
+        _pimpl->close();
+    }
 }
 
 bool Acceptor::isOpen() {
-    return _pimpl->isOpen();
+    return _pimpl && _pimpl->isOpen();
 }
 
 bool Acceptor::isClosed() {
-    return _pimpl->isClosed();
+    return !_pimpl || _pimpl->isClosed();
 }
 
 NetworkEndpoint Acceptor::getLocalEndpoint() const {
     return _pimpl->getLocalEndpoint();
 }
 
+Result<void, Error>
+Acceptor::setOption(SocketOptionName option, int32 value) {
+    if (!_pimpl) {
+        return Err(makeError(SystemErrors::BADF, "Acceptor::setOption"));
+    }
+
+    return _pimpl->setOption(option, value);
+}
+
+Result<int32, Error>
+Acceptor::getOption(SocketOptionName option) {
+    if (!_pimpl) {
+        return Err(makeError(SystemErrors::BADF, "Acceptor::getOption"));
+    }
+
+    return _pimpl->getOption(option);
+}
+
 
 Result<StreamSocket, Error>
 Acceptor::accept() {
@@ -92,6 +189,75 @@ Acceptor::accept() {
 
 Future<StreamSocket>
 Acceptor::asyncAccept() {
-    return _pimpl->asyncAccept();
+    return _pimpl->asyncAccept(_loop);
+}
+
+Future<StreamSocket>
+Acceptor::asyncAccept(EventLoop& sessionLoop) {
+    return _pimpl->asyncAccept(sessionLoop);
+}
+
+void
+Acceptor::asyncAccept(AcceptCompletion& completion) {
+    _pimpl->asyncAccept(_loop, completion);
+}
+
+void
+Acceptor::asyncAccept(EventLoop& sessionLoop, AcceptCompletion& completion) {
+    _pimpl->asyncAccept(sessionLoop, completion);
 }
 
+Future<StreamSocket>
+Acceptor::asyncAccept(Deadline deadline) {
+    return asyncAccept(_loop, deadline);
+}
+
+Future<StreamSocket>
+Acceptor::asyncAccept(EventLoop& sessionLoop, Deadline deadline) {
+    Promise<StreamSocket> promise;
+    auto f = promise.getFuture();
+
+    _pimpl->asyncAccept(sessionLoop, deadline, AcceptPromiseCompletion::create(std::move(promise)));
+
+    return f;
+}
+
+void
+Acceptor::asyncAccept(Deadline deadline, AcceptCompletion& completion) {
+    _pimpl->asyncAccept(_loop, deadline, completion);
+}
+
+void
+Acceptor::asyncAccept(EventLoop& sessionLoop, Deadline deadline, AcceptCompletion& completion) {
+    _pimpl->asyncAccept(sessionLoop, deadline, completion);
+}
+
+Future<std::vector<StreamSocket>>
+Acceptor::asyncAcceptBatch(size_type maxBatchSize) {
+    Promise<std::vector<StreamSocket>> promise;
+    auto f = promise.getFuture();
+
+    _pimpl->asyncAcceptBatch(nullptr, maxBatchSize, AcceptBatchPromiseCompletion::create(std::move(promise)));
+
+    return f;
+}
+
+Future<std::vector<StreamSocket>>
+Acceptor::asyncAcceptBatch(EventLoopGroup& sessionLoops, size_type maxBatchSize) {
+    Promise<std::vector<StreamSocket>> promise;
+    auto f = promise.getFuture();
+
+    _pimpl->asyncAcceptBatch(&sessionLoops, maxBatchSize, AcceptBatchPromiseCompletion::create(std::move(promise)));
+
+    return f;
+}
+
+void
+Acceptor::asyncAcceptBatch(size_type maxBatchSize, AcceptBatchCompletion& completion) {
+    _pimpl->asyncAcceptBatch(nullptr, maxBatchSize, completion);
+}
+
+void
+Acceptor::asyncAcceptBatch(EventLoopGroup& sessionLoops, size_type maxBatchSize, AcceptBatchCompletion& completion) {
+    _pimpl->asyncAcceptBatch(&sessionLoops, maxBatchSize, completion);
+}
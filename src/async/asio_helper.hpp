@@ -11,13 +11,24 @@
 #define CADENCE_ASIO_HELPER_HPP
 
 #include "asynErrorDomain.hpp"
+#include "loopInstrumentation.hpp"
+#include "handlerMemory.hpp"
+
+#include "cadence/async/strand.hpp"
+#include "cadence/async/completion.hpp"
 
 #include <solace/error.hpp>
 #include <solace/byteReader.hpp>
 #include <solace/byteWriter.hpp>
+#include <solace/arrayView.hpp>
 
 #include <asio/io_context.hpp>
 #include <asio/buffer.hpp>
+#include <asio/bind_executor.hpp>
+#include <asio/strand.hpp>
+
+#include <algorithm>
+#include <iterator>
 
 
 namespace cadence::async {
@@ -27,6 +38,87 @@ asio::io_context& asAsioService(void* ioservice) noexcept {
     return *static_cast<asio::io_context*>(ioservice);
 }
 
+using StrandExecutor = asio::strand<asio::io_context::executor_type>;
+
+inline constexpr
+StrandExecutor& asAsioStrand(void* strand) noexcept {
+    return *static_cast<StrandExecutor*>(strand);
+}
+
+/**
+ * Initiate an async operation which completion handler is executed through the given strand.
+ * If no strand is given the handler is executed directly by the event loop, as usual.
+ * Execution time of the handler is reported to the loop instrumentation.
+ * State of the operation is allocated from the given handler memory of the io-object.
+ *
+ * @param strand Strand to serialise completion through, may be null.
+ * @param memory Handler memory of the io-object that starts the operation.
+ * @param initiate Callable that starts an async operation with a completion handler passed to it.
+ * @param handler Completion handler of the operation.
+ */
+template<typename Initiation, typename Handler>
+void initiateOn(Strand* strand, HandlerMemoryRef const& memory, Initiation&& initiate, Handler&& handler) {
+    auto allocatingHandler = allocateFrom(memory, trackHandler(std::forward<Handler>(handler)));
+    if (strand) {
+        auto& executor = asAsioStrand(strand->getExecutor());
+        initiate(asio::bind_executor(executor, std::move(allocatingHandler)));
+    } else {
+        initiate(std::move(allocatingHandler));
+    }
+}
+
+
+/**
+ * Make a completion handler that reports outcome of a buffer transfer into the given completion record.
+ * On success the buffer is advanced by the number of bytes transferred.
+ * The handler only holds pointers and does not allocate.
+ */
+template<typename Buffer>
+auto completionHandler(AsyncCompletion& completion, Buffer& buffer, Solace::StringLiteral tag) noexcept {
+    return [c = &completion, b = &buffer, tag](asio::error_code const& error, std::size_t length) {
+        if (!error) {
+            b->advance(length);
+        }
+
+        c->complete(error.value(), length, tag);
+    };
+}
+
+
+/**
+ * Advance each buffer in turn by the number of bytes transferred by a scatter / gather operation.
+ */
+template<typename Buffer>
+void advanceBuffers(Solace::ArrayView<Buffer> buffers, std::size_t length) {
+    for (auto& buffer : buffers) {
+        if (length == 0) {
+            break;
+        }
+
+        auto const n = std::min<std::size_t>(length, buffer.remaining());
+        buffer.advance(n);
+        length -= n;
+    }
+}
+
+
+/**
+ * Make a completion handler that reports outcome of a scatter / gather transfer into the given completion record.
+ * On success buffers are advanced by the number of bytes transferred.
+ */
+template<typename Buffer>
+auto buffersCompletionHandler(AsyncCompletion& completion, Solace::ArrayView<Buffer> buffers,
+                              Solace::StringLiteral tag) noexcept {
+    return [c = &completion, buffers, tag](asio::error_code const& error, std::size_t length) {
+        if (!error) {
+            advanceBuffers(buffers, length);
+        }
+
+        c->complete(error.value(), length, tag);
+    };
+}
+
+
 inline
 Solace::Error fromAsioError(asio::error_code const& err, Solace::StringLiteral tag) noexcept {
     return makeError(AsyncError::AsyncSystemError, err.value(), tag);
@@ -43,5 +135,83 @@ asio::const_buffer asio_buffer(Solace::ByteReader& dest, Solace::ByteReader::siz
     return asio::buffer(dest.viewRemaining().slice(0, bytes).dataAddress(), bytes);
 }
 
+
+/**
+ * Asio buffer sequence over remaining data of an array of buffers.
+ * Asio transfers the whole sequence with a single scatter / gather system call (readv / writev / sendmsg)
+ * and buffer descriptors are produced on the fly, so no copy of the array is made.
+ */
+template<typename Buffer, typename AsioBuffer>
+class BufferSequence {
+public:
+
+    using value_type = AsioBuffer;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = AsioBuffer;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = AsioBuffer;
+
+        const_iterator() noexcept = default;
+
+        explicit const_iterator(Buffer* buffer) noexcept
+            : _buffer(buffer)
+        {}
+
+        AsioBuffer operator* () const {
+            return AsioBuffer(_buffer->viewRemaining().dataAddress(), _buffer->remaining());
+        }
+
+        const_iterator& operator++ () noexcept { ++_buffer; return *this; }
+        const_iterator& operator-- () noexcept { --_buffer; return *this; }
+
+        const_iterator operator++ (int) noexcept {
+            auto i = *this;
+            ++_buffer;
+            return i;
+        }
+
+        const_iterator operator-- (int) noexcept {
+            auto i = *this;
+            --_buffer;
+            return i;
+        }
+
+        bool operator== (const_iterator const& rhs) const noexcept { return _buffer == rhs._buffer; }
+        bool operator!= (const_iterator const& rhs) const noexcept { return _buffer != rhs._buffer; }
+
+    private:
+        Buffer* _buffer{nullptr};
+    };
+
+    explicit BufferSequence(Solace::ArrayView<Buffer> buffers) noexcept
+        : _begin(buffers.begin())
+        , _end(buffers.end())
+    {}
+
+    const_iterator begin() const noexcept { return const_iterator{_begin}; }
+    const_iterator end() const noexcept { return const_iterator{_end}; }
+
+private:
+    Buffer* _begin;
+    Buffer* _end;
+};
+
+
+inline
+BufferSequence<Solace::ByteWriter, asio::mutable_buffer>
+asio_buffers(Solace::ArrayView<Solace::ByteWriter> dest) noexcept {
+    return BufferSequence<Solace::ByteWriter, asio::mutable_buffer>{dest};
+}
+
+inline
+BufferSequence<Solace::ByteReader, asio::const_buffer>
+asio_buffers(Solace::ArrayView<Solace::ByteReader> src) noexcept {
+    return BufferSequence<Solace::ByteReader, asio::const_buffer>{src};
+}
+
 }  // end of namespace cadence::async
 #endif  // CADENCE_ASIO_HELPER_HPP
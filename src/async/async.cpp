@@ -12,6 +12,7 @@
 #include "cadence/async/acceptor.hpp"
 #include "cadence/async/channel.hpp"
 #include "asynErrorDomain.hpp"
+#include "promiseCompletion.hpp"
 
 
 using namespace Solace;
@@ -19,4 +20,68 @@ using namespace cadence;
 using namespace cadence::async;
 
 
-Channel::~Channel() = default;
+Error AsyncCompletion::getError() const noexcept {
+    return makeError(AsyncError::AsyncSystemError, _errorCode, _tag);
+}
+
+
+Channel::~Channel() {
+    if (_ioContext) {
+        _ioContext->detachChannel();
+    }
+}
+
+
+CompletionMemory* Channel::getCompletionMemory() noexcept {
+    return nullptr;
+}
+
+
+Future<void> Channel::asyncReadv(ReadBuffers dests) {
+    Promise<void> promise;
+    auto f = promise.getFuture();
+
+    asyncReadv(dests, PromiseCompletion<void>::create(std::move(promise)));
+
+    return f;
+}
+
+
+Future<void> Channel::asyncWritev(WriteBuffers srcs) {
+    Promise<void> promise;
+    auto f = promise.getFuture();
+
+    asyncWritev(srcs, PromiseCompletion<void>::create(std::move(promise)));
+
+    return f;
+}
+
+
+Future<void> Channel::asyncRead(ByteWriter& dest, size_type bytesToRead, Deadline deadline) {
+    Promise<void> promise;
+    auto f = promise.getFuture();
+
+    asyncRead(dest, bytesToRead, deadline, PromiseCompletion<void>::create(std::move(promise)));
+
+    return f;
+}
+
+
+Future<void> Channel::asyncWrite(ByteReader& src, size_type bytesToWrite, Deadline deadline) {
+    Promise<void> promise;
+    auto f = promise.getFuture();
+
+    asyncWrite(src, bytesToWrite, deadline, PromiseCompletion<void>::create(std::move(promise)));
+
+    return f;
+}
+
+
+Future<Channel::size_type> Channel::asyncReadSome(ByteWriter& dest, size_type maxBytesToRead) {
+    Promise<size_type> promise;
+    auto f = promise.getFuture();
+
+    asyncReadSome(dest, maxBytesToRead, PromiseCompletion<size_type>::create(std::move(promise)));
+
+    return f;
+}
@@ -0,0 +1,157 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Lock-free bounded queue
+ *	@file		async/boundedQueue.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_BOUNDEDQUEUE_HPP
+#define CADENCE_ASYNC_BOUNDEDQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+
+namespace cadence::async {
+
+/**
+ * Lock-free bounded multi-producer queue of pre-allocated slots.
+ * Based on D. Vyukov's bounded MPMC queue: each slot carries a sequence number
+ * that tells producers and consumers whether the slot is free or filled.
+ * Neither push nor pop allocate memory.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+
+    /**
+     * Construct a queue.
+     * @param capacity Maximum number of elements in the queue. Rounded up to the next power of 2.
+     */
+    explicit BoundedQueue(std::size_t capacity)
+        : _mask(roundUpToPowerOf2(capacity) - 1)
+        , _buffer(std::make_unique<Cell[]>(_mask + 1))
+    {
+        for (std::size_t i = 0; i <= _mask; ++i) {
+            _buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(BoundedQueue const&) = delete;
+    BoundedQueue& operator= (BoundedQueue const&) = delete;
+
+    /**
+     * Try to push an element into the queue. This method is safe to call from multiple threads.
+     * @param value Value to be moved into the queue. Left untouched if the queue is full.
+     * @return True if the value has been queued, false if the queue is full.
+     */
+    bool tryPush(T& value) {
+        auto pos = _enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        for (;;) {
+            cell = &_buffer[pos & _mask];
+            auto const seq = cell->sequence.load(std::memory_order_acquire);
+            auto const diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0) {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Queue is full
+            } else {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * Try to pop an element from the queue.
+     * @param value Destination to move a popped value into.
+     * @return True if a value has been popped, false if the queue is empty.
+     */
+    bool tryPop(T& value) {
+        auto pos = _dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        for (;;) {
+            cell = &_buffer[pos & _mask];
+            auto const seq = cell->sequence.load(std::memory_order_acquire);
+            auto const diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+            if (diff == 0) {
+                if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Queue is empty
+            } else {
+                pos = _dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->data);
+        cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * Test if the queue has no element ready to be popped.
+     * Note: An element being pushed concurrently may not be seen yet.
+     * @return True if the next pop would fail.
+     */
+    bool isEmpty() const noexcept {
+        auto const pos = _dequeuePos.load(std::memory_order_relaxed);
+        auto const seq = _buffer[pos & _mask].sequence.load(std::memory_order_acquire);
+
+        return static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1) < 0;
+    }
+
+    /**
+     * Get the capacity of the queue.
+     */
+    std::size_t capacity() const noexcept {
+        return _mask + 1;
+    }
+
+private:
+
+    static std::size_t roundUpToPowerOf2(std::size_t value) noexcept {
+        std::size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+
+        return result;
+    }
+
+    struct Cell {
+        std::atomic<std::size_t>    sequence;
+        T                           data;
+    };
+
+    static constexpr std::size_t kCacheLineSize = 64;
+
+    std::size_t const               _mask;
+    std::unique_ptr<Cell[]>         _buffer;
+
+    alignas(kCacheLineSize) std::atomic<std::size_t>    _enqueuePos{0};
+    alignas(kCacheLineSize) std::atomic<std::size_t>    _dequeuePos{0};
+};
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_BOUNDEDQUEUE_HPP
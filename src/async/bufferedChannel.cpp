@@ -0,0 +1,266 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/bufferedChannel.cpp
+ *******************************************************************************/
+#include "cadence/async/bufferedChannel.hpp"
+
+#include "asynErrorDomain.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+template<typename T>
+Future<T> failedFuture(int errorCode, StringLiteral tag) {
+    Promise<T> promise;
+    auto f = promise.getFuture();
+    promise.setError(makeError(AsyncError::AsyncSystemError, errorCode, tag));
+
+    return f;
+}
+
+}  // namespace
+
+
+struct BufferedChannel::RefillState :
+        public AsyncCompletion {
+
+    RefillState(BufferedChannel* self, size_type capacity)
+        : AsyncCompletion(&BufferedChannel::onRefill)
+        , owner(self)
+        , buffer(std::make_unique<byte[]>(capacity))
+    {}
+
+    BufferedChannel*            owner;          //!< Null once the channel is destroyed with a read pending.
+    bool                        pending{false};
+    std::unique_ptr<byte[]>     buffer;
+    ByteWriter                  writer;
+};
+
+
+BufferedChannel::~BufferedChannel() {
+    if (_refill->pending) {
+        // Read of the channel still refers to the buffer and the record: they are freed once it completes
+        _refill->owner = nullptr;
+        _refill.release();
+    }
+}
+
+
+BufferedChannel::BufferedChannel(Channel& channel, size_type capacity)
+    : _channel(channel)
+    , _capacity(capacity)
+    , _refill(std::make_unique<RefillState>(this, capacity))
+{}
+
+
+byte* BufferedChannel::buffer() const noexcept {
+    return _refill->buffer.get();
+}
+
+
+MemoryView BufferedChannel::peek() const noexcept {
+    return wrapMemory(static_cast<byte const*>(buffer() + _begin), size());
+}
+
+
+void BufferedChannel::consume(size_type bytes) noexcept {
+    _begin += std::min(bytes, size());
+    _scanned = 0;
+
+    if (_begin == _end) {
+        _begin = 0;
+        _end = 0;
+    }
+}
+
+
+Future<BufferedChannel::size_type>
+BufferedChannel::asyncPeek(size_type minBytes) {
+    if (minBytes > _capacity) {
+        return failedFuture<size_type>(ENOBUFS, "asyncPeek");
+    }
+
+    _minBytes = minBytes;
+    return startPending(Pending::Peek);
+}
+
+
+Future<BufferedChannel::size_type>
+BufferedChannel::asyncReadUntil(StringView delimiter) {
+    if (delimiter.empty() || delimiter.size() > _capacity) {
+        return failedFuture<size_type>(EINVAL, "asyncReadUntil");
+    }
+
+    _delimiter = delimiter;
+    _scanned = 0;
+    return startPending(Pending::Until);
+}
+
+
+Future<void>
+BufferedChannel::asyncRead(ByteWriter& dest, size_type bytesToRead) {
+    // Serve what we can from the buffer first
+    auto const buffered = std::min(bytesToRead, size());
+    dest.write(peek().slice(0, buffered));
+    consume(buffered);
+
+    auto const rest = bytesToRead - buffered;
+    if (rest == 0) {
+        Promise<void> promise;
+        auto f = promise.getFuture();
+        promise.setValue();
+
+        return f;
+    }
+
+    // No point copying large reads through the buffer
+    if (rest >= _capacity) {
+        return _channel.asyncRead(dest, rest);
+    }
+
+    return asyncPeek(rest)
+            .then([this, &dest, rest](size_type) {
+                dest.write(peek().slice(0, rest));
+                consume(rest);
+            });
+}
+
+
+Future<BufferedChannel::size_type>
+BufferedChannel::startPending(Pending pending) {
+    if (_pending != Pending::None) {
+        return failedFuture<size_type>(EALREADY, "BufferedChannel");
+    }
+
+    _pending = pending;
+    _promise = Promise<size_type>{};
+    auto f = _promise.getFuture();
+
+    resume();
+
+    return f;
+}
+
+
+bool BufferedChannel::tryComplete() {
+    size_type result = 0;
+
+    switch (_pending) {
+    case Pending::None:
+        return true;
+
+    case Pending::Peek:
+        if (size() < std::max<size_type>(_minBytes, 1)) {
+            return false;
+        }
+
+        result = size();
+        break;
+
+    case Pending::Until: {
+        auto const delimiterSize = static_cast<size_type>(_delimiter.size());
+        if (size() < delimiterSize) {
+            return false;
+        }
+
+        auto const* data = buffer() + _begin;
+        auto const* delimiter = reinterpret_cast<byte const*>(_delimiter.data());
+        auto const* found = std::search(data + _scanned, data + size(), delimiter, delimiter + delimiterSize);
+        if (found == data + size()) {
+            // Delimiter may start in the last few bytes scanned: re-scan them once more data arrives
+            _scanned = size() - (delimiterSize - 1);
+            return false;
+        }
+
+        result = static_cast<size_type>(found - data) + delimiterSize;
+    } break;
+    }
+
+    // Note: promise is moved out as its continuation may start the next operation
+    auto promise = std::move(_promise);
+    _pending = Pending::None;
+    promise.setValue(result);
+
+    return true;
+}
+
+
+void BufferedChannel::resume() {
+    if (tryComplete()) {
+        return;
+    }
+
+    if (size() == _capacity) {
+        fail(makeError(AsyncError::AsyncSystemError, ENOBUFS, "BufferedChannel"));
+        return;
+    }
+
+    refill();
+}
+
+
+void BufferedChannel::compact() noexcept {
+    if (_begin == 0) {
+        return;
+    }
+
+    auto const buffered = size();
+    std::memmove(buffer(), buffer() + _begin, buffered);
+    _begin = 0;
+    _end = buffered;
+}
+
+
+void BufferedChannel::refill() {
+    compact();
+
+    auto const freeSpace = _capacity - _end;
+    auto& state = *_refill;
+    state.writer = ByteWriter(wrapMemory(buffer() + _end, freeSpace));
+    state.pending = true;
+    _channel.asyncReadSome(state.writer, freeSpace, state);
+}
+
+
+void BufferedChannel::onRefill(AsyncCompletion& self) {
+    auto& state = static_cast<RefillState&>(self);
+    state.pending = false;
+
+    if (!state.owner) {
+        // The channel has been destroyed while the read was pending
+        delete &state;
+        return;
+    }
+
+    auto& owner = *state.owner;
+    if (state.isError()) {
+        owner.fail(state.getError());
+        return;
+    }
+
+    owner._end += static_cast<size_type>(state.getValue());
+    owner.resume();
+}
+
+
+void BufferedChannel::fail(Error&& error) {
+    auto promise = std::move(_promise);
+    _pending = Pending::None;
+    promise.setError(std::move(error));
+}
@@ -14,6 +14,7 @@
 
 #include "asio_helper.hpp"
 #include "asio_helper_local.hpp"
+#include "deadlineCompletion.hpp"
 
 #include <asio/local/datagram_protocol.hpp>
 
@@ -56,7 +57,9 @@ public:
         auto f = promise.getFuture();
 
         auto const endpoint = toAsioLocalDatagramEndpoint(peer);
-        _socket.async_connect(endpoint,
+        initiateOn(_strand, _handlerMemory, [this, &endpoint](auto handler) {
+                _socket.async_connect(endpoint, std::move(handler));
+            },
             [pm = std::move(promise)](const asio::error_code& error) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncConnect"));
@@ -73,7 +76,9 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        _socket.async_receive(asio_buffer(dest, bytesToRead),
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto handler) {
+                _socket.async_receive(buffer, std::move(handler));
+            },
             [pm = std::move(promise), &dest](const asio::error_code& error, std::size_t length) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asynRead"));
@@ -93,7 +98,9 @@ public:
         auto f = promise.getFuture();
 
         auto destination = toAsioLocalDatagramEndpoint(endpoint);
-        _socket.async_receive_from(asio_buffer(dest, bytesToRead), destination,
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead), &destination](auto handler) {
+                _socket.async_receive_from(buffer, destination, std::move(handler));
+            },
             [pm = std::move(promise), &dest](const asio::error_code& error, std::size_t length) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncReadFrom"));
@@ -112,7 +119,9 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        _socket.async_send(asio_buffer(src, bytesToWrite),
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(src, bytesToWrite)](auto handler) {
+                _socket.async_send(buffer, std::move(handler));
+            },
             [pm = std::move(promise), &src](const asio::error_code& error, std::size_t bytesTransferred) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncWrite"));
@@ -132,7 +141,9 @@ public:
         auto f = promise.getFuture();
 
         auto const destination = toAsioLocalDatagramEndpoint(endpoint);
-        _socket.async_send_to(asio_buffer(src, bytesToWrite), destination,
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(src, bytesToWrite), &destination](auto handler) {
+                _socket.async_send_to(buffer, destination, std::move(handler));
+            },
             [pm = std::move(promise), &src](const asio::error_code& error, std::size_t bytesTransferred) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncWriteTo"));
@@ -182,6 +193,102 @@ public:
     }
 
 
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto handler) {
+                _socket.async_receive(buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(src, bytesToWrite)](auto handler) {
+                _socket.async_send(buffer, std::move(handler));
+            },
+            completionHandler(completion, src, "asyncWrite"));
+    }
+
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, Deadline deadline, AsyncCompletion& completion) {
+        auto& guard = DeadlineCompletion::create(_socket.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+        initiateOn(_strand, _handlerMemory,
+            [this, buffer = asio_buffer(dest, bytesToRead), slot = guard.slot()](auto handler) {
+                _socket.async_receive(buffer, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            completionHandler(guard, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, Deadline deadline, AsyncCompletion& completion) {
+        auto& guard = DeadlineCompletion::create(_socket.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+        initiateOn(_strand, _handlerMemory,
+            [this, buffer = asio_buffer(src, bytesToWrite), slot = guard.slot()](auto handler) {
+                _socket.async_send(buffer, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            completionHandler(guard, src, "asyncWrite"));
+    }
+
+    void asyncReadSome(ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, maxBytesToRead)](auto handler) {
+                _socket.async_receive(buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncReadSome"));
+    }
+
+    Result<size_type, Error>
+    readSome(ByteWriter& dest, size_type maxBytesToRead) {
+        asio::error_code ec;
+
+        auto const len = _socket.receive(asio_buffer(dest, maxBytesToRead), 0, ec);
+        if (ec) {
+            return Err(fromAsioError(ec, "readSome"));
+        }
+
+        dest.advance(len);
+        return Ok(static_cast<size_type>(len));
+    }
+
+    void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffers = asio_buffers(dests)](auto handler) {
+                _socket.async_receive(buffers, std::move(handler));
+            },
+            buffersCompletionHandler(completion, dests, "asyncReadv"));
+    }
+
+    void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffers = asio_buffers(srcs)](auto handler) {
+                _socket.async_send(buffers, std::move(handler));
+            },
+            buffersCompletionHandler(completion, srcs, "asyncWritev"));
+    }
+
+    Result<void, Error> readv(ReadBuffers dests) {
+        asio::error_code ec;
+
+        auto const len = _socket.receive(asio_buffers(dests), 0, ec);
+        if (ec) {
+            return Err(fromAsioError(ec, "readv"));
+        }
+
+        advanceBuffers(dests, len);
+        return Ok();
+    }
+
+    Result<void, Error> writev(WriteBuffers srcs) {
+        asio::error_code ec;
+
+        auto const len = _socket.send(asio_buffers(srcs), 0, ec);
+        if (ec) {
+            return Err(fromAsioError(ec, "writev"));
+        }
+
+        advanceBuffers(srcs, len);
+        return Ok();
+    }
+
+    void bindTo(Strand& strand) {
+        _strand = &strand;
+    }
+
     void cancel() {
         _socket.cancel();
     }
@@ -195,6 +302,14 @@ public:
         return _socket.is_open();
     }
 
+    int nativeHandle() {
+        return _socket.native_handle();
+    }
+
+    CompletionMemory* getCompletionMemory() noexcept {
+        return _handlerMemory.get();
+    }
+
     UnixEndpoint getLocalEndpoint() const {
         // TODO(abbyssoul): may throw and thus must use ec accepting version and return result<>
         auto localEndpoint = _socket.local_endpoint();
@@ -218,6 +333,8 @@ public:
 
 private:
     asio::local::datagram_protocol::socket      _socket;
+    Strand*                                     _strand{nullptr};
+    HandlerMemoryRef                            _handlerMemory;
 };
 
 
@@ -280,6 +397,52 @@ DatagramDomainSocket::asyncWriteTo(ByteReader& src, std::size_t bytesToWrite, Un
     return _pimpl->asyncWriteTo(src, bytesToWrite, endpoint);
 }
 
+void DatagramDomainSocket::asyncRead(ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) {
+    _pimpl->asyncRead(dest, bytesToRead, completion);
+}
+
+void DatagramDomainSocket::asyncWrite(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) {
+    _pimpl->asyncWrite(src, bytesToWrite, completion);
+}
+
+void DatagramDomainSocket::asyncRead(ByteWriter& dest, size_type bytesToRead,
+                                     Deadline deadline, AsyncCompletion& completion) {
+    _pimpl->asyncRead(dest, bytesToRead, deadline, completion);
+}
+
+void DatagramDomainSocket::asyncWrite(ByteReader& src, size_type bytesToWrite,
+                                      Deadline deadline, AsyncCompletion& completion) {
+    _pimpl->asyncWrite(src, bytesToWrite, deadline, completion);
+}
+
+void DatagramDomainSocket::asyncReadSome(ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) {
+    _pimpl->asyncReadSome(dest, maxBytesToRead, completion);
+}
+
+Result<DatagramDomainSocket::size_type, Error> DatagramDomainSocket::readSome(ByteWriter& dest, size_type maxBytesToRead) {
+    return _pimpl->readSome(dest, maxBytesToRead);
+}
+
+void DatagramDomainSocket::asyncReadv(ReadBuffers dests, AsyncCompletion& completion) {
+    _pimpl->asyncReadv(dests, completion);
+}
+
+void DatagramDomainSocket::asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) {
+    _pimpl->asyncWritev(srcs, completion);
+}
+
+Result<void, Error> DatagramDomainSocket::readv(ReadBuffers dests) {
+    return _pimpl->readv(dests);
+}
+
+Result<void, Error> DatagramDomainSocket::writev(WriteBuffers srcs) {
+    return _pimpl->writev(srcs);
+}
+
+void DatagramDomainSocket::bindTo(Strand& strand) {
+    _pimpl->bindTo(strand);
+}
+
 void DatagramDomainSocket::cancel() {
     _pimpl->cancel();
 }
@@ -308,6 +471,15 @@ bool DatagramDomainSocket::isClosed() const {
     return !_pimpl->isOpen();
 }
 
+Channel::NativeHandles DatagramDomainSocket::getNativeHandles() {
+    auto const handle = _pimpl->nativeHandle();
+    return {handle, handle};
+}
+
+CompletionMemory* DatagramDomainSocket::getCompletionMemory() noexcept {
+    return _pimpl ? _pimpl->getCompletionMemory() : nullptr;
+}
+
 UnixEndpoint DatagramDomainSocket::getLocalEndpoint() const {
     return _pimpl->getLocalEndpoint();
 }
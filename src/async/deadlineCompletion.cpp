@@ -0,0 +1,100 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/deadlineCompletion.cpp
+ *******************************************************************************/
+#include "deadlineCompletion.hpp"
+#include "asio_helper.hpp"
+
+#include <cerrno>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+DeadlineCompletion&
+DeadlineCompletion::create(executor_type const& executor, Strand* strand, HandlerMemoryRef const& memory,
+                           Deadline deadline, AsyncCompletion& completion) {
+    auto* guard = new DeadlineCompletion(executor, completion);
+
+    guard->_timer.expires_at(deadline);
+    initiateOn(strand, memory, [guard](auto handler) {
+            guard->_timer.async_wait(std::move(handler));
+        },
+        [guard](asio::error_code const& error) {
+            guard->onTimer(error);
+        });
+
+    return *guard;
+}
+
+
+DeadlineCompletion::DeadlineCompletion(executor_type const& executor, AsyncCompletion& completion)
+    : AsyncCompletion(&DeadlineCompletion::forward)
+    , _timer(executor)
+    , _completion(completion)
+{}
+
+
+void DeadlineCompletion::forward(AsyncCompletion& self) {
+    auto& guard = static_cast<DeadlineCompletion&>(self);
+
+    auto errorCode = guard.getErrorCode();
+    {
+        // Waits for the timer handler emitting the signal on another thread, if any: once it's done,
+        // the next operation, i.e. started by the caller's completion, can't be cancelled by it.
+        // Note: The mutex is recursive as the operation may complete inside of the emit, on the same thread.
+        std::lock_guard<std::recursive_mutex> lock(guard._mutex);
+
+        // Disarm: the operation may be gone, i.e. a queued write failed by a socket being destroyed
+        guard._completed = true;
+        guard._timer.cancel();
+        if (!guard._emitting) {
+            guard._signal.slot().clear();
+        }
+
+        if (guard._expired && errorCode == ECANCELED) {
+            errorCode = ETIMEDOUT;
+        }
+    }
+
+    guard._completion.complete(errorCode, guard.getValue(), guard.getTag());
+    guard.release();
+}
+
+
+void DeadlineCompletion::onTimer(asio::error_code const& error) {
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        // Timer may have fired just as the operation completed: nothing to cancel then
+        if (!error && !_completed) {
+            _expired = true;
+            _emitting = true;
+            _signal.emit(asio::cancellation_type::terminal);
+            _emitting = false;
+
+            // Handler of the slot can't be destroyed while it runs: operation completed inside it leaves it to us
+            if (_completed) {
+                _signal.slot().clear();
+            }
+        }
+    }
+
+    release();
+}
+
+
+void DeadlineCompletion::release() noexcept {
+    if (_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
+}
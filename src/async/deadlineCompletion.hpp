@@ -0,0 +1,105 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Completion record enforcing a deadline of an async operation
+ *	@file		async/deadlineCompletion.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_DEADLINECOMPLETION_HPP
+#define CADENCE_ASYNC_DEADLINECOMPLETION_HPP
+
+#include "cadence/async/completion.hpp"
+#include "cadence/async/deadline.hpp"
+
+#include "handlerMemory.hpp"
+
+#include <asio/steady_timer.hpp>
+#include <asio/cancellation_signal.hpp>
+#include <asio/bind_cancellation_slot.hpp>
+
+#include <atomic>
+#include <mutex>
+
+
+namespace cadence::async {
+
+class Strand;
+
+
+/**
+ * Completion record that guards an async operation with a deadline.
+ *
+ * The record wraps the caller's completion record and arms a timer of the operation's event loop,
+ * so deadlines share the loop's timer queue. If the deadline expires before the operation completes,
+ * the record emits its cancellation signal: only the operation bound to the signal's slot is cancelled,
+ * and its failure is reported as ETIMEDOUT. Other operations of the same io object keep going.
+ *
+ * Typical usage by an io object:
+ * @code
+ *  auto& guard = DeadlineCompletion::create(_socket.get_executor(), _strand, _handlerMemory, deadline, completion);
+ *  initiateOn(_strand, _handlerMemory, [this, buffer, slot = guard.slot()](auto handler) {
+ *          asio::async_read(_socket, buffer, asio::bind_cancellation_slot(slot, std::move(handler)));
+ *      },
+ *      completionHandler(guard, dest, "asyncRead"));
+ * @endcode
+ *
+ * The record releases itself once both the operation and the timer have completed.
+ *
+ * Io objects bound to a strand complete the operation and the timer through it. Otherwise, on a loop run by
+ * multiple threads, the timer may expire while the operation completes on another thread: the record's mutex
+ * makes sure the signal is never emitted for an operation that has completed already.
+ */
+class DeadlineCompletion :
+        public AsyncCompletion {
+public:
+
+    using executor_type = asio::steady_timer::executor_type;
+
+    /**
+     * Create a new completion record enforcing the deadline.
+     * @param executor Executor of the io object performing the operation.
+     * @param strand Strand the operation completes through, may be null.
+     * @param memory Handler memory of the io object.
+     * @param deadline Deadline of the operation.
+     * @param completion Caller's completion record to notify once the operation completes.
+     * @return Completion record to pass to the operation.
+     */
+    static DeadlineCompletion& create(executor_type const& executor, Strand* strand, HandlerMemoryRef const& memory,
+                                      Deadline deadline, AsyncCompletion& completion);
+
+    /** Slot to bind the guarded operation to. */
+    asio::cancellation_slot slot() noexcept {
+        return _signal.slot();
+    }
+
+private:
+
+    DeadlineCompletion(executor_type const& executor, AsyncCompletion& completion);
+
+    static void forward(AsyncCompletion& self);
+
+    void onTimer(asio::error_code const& error);
+
+    void release() noexcept;
+
+private:
+
+    asio::steady_timer          _timer;
+    asio::cancellation_signal   _signal;
+    AsyncCompletion&            _completion;
+
+    std::recursive_mutex        _mutex;         //!< Guards the signal and the flags below. @see forward
+    bool                        _completed{false};
+    bool                        _expired{false};
+    bool                        _emitting{false};
+    std::atomic<int>            _refCount{2};   //!< Held by the operation and by the timer.
+};
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_DEADLINECOMPLETION_HPP
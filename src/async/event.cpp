@@ -41,17 +41,24 @@ public:
         auto f = promise.getFuture();
 
         _eventFd.async_read_some(asio::buffer(&_readBuffer, sizeof(_readBuffer)),
-            [pm = std::move(promise)] (const asio::error_code& error, std::size_t) mutable {
+            trackHandler([pm = std::move(promise)] (const asio::error_code& error, std::size_t) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncAwait"));
             } else {
                 pm.setValue();
             }
-        });
+        }));
 
         return f;
     }
 
+    void asyncWait(AsyncCompletion& completion) {
+        _eventFd.async_read_some(asio::buffer(&_readBuffer, sizeof(_readBuffer)),
+            trackHandler([c = &completion] (const asio::error_code& error, std::size_t) {
+            c->complete(error.value(), 0, "asyncAwait");
+        }));
+    }
+
 private:
     asio::posix::stream_descriptor _eventFd;
     Solace::uint64 _readBuffer;
@@ -87,3 +94,8 @@ Future<void> Event::asyncWait() {
     return _pimpl->asyncWait();
 }
 
+
+void Event::asyncWait(AsyncCompletion& completion) {
+    _pimpl->asyncWait(completion);
+}
+
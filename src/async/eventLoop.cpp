@@ -11,25 +11,126 @@
  *******************************************************************************/
 #include "cadence/async/eventloop.hpp"
 
+#include "boundedQueue.hpp"
+#include "loopInstrumentation.hpp"
+
 #include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#include <asio/defer.hpp>
+#include <asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 
 using namespace cadence::async;
 
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+//!< Number of tasks that can be submitted from foreign threads without allocation before loop picks them up.
+constexpr std::size_t kForeignTaskQueueCapacity = 512;
+
+/**
+ * Hint CPU that we are in a spin-wait loop.
+ */
+inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+/**
+ * Execute a task queued to the loop, accounting for it in the loop instrumentation.
+ */
+void runQueuedTask(Task& task) {
+    LoopInstrumentation::invoke(task);
+
+    if (auto* instrumentation = LoopInstrumentation::current()) {
+        instrumentation->taskExecuted();
+    }
+}
+
+/**
+ * Adapter of a Task into asio handler.
+ * Note: asio recycles memory of small handlers executed on the threads running the loop.
+ */
+struct TaskHandler {
+    Task task;
+
+    void operator() () {
+        runQueuedTask(task);
+    }
+};
+
+}  // namespace
+
+
 class EventLoop::EventloopImpl {
 public:
 
+    EventloopImpl()
+        : _lagProbe(_io_service)
+        , _foreignTasks(kForeignTaskQueueCapacity)
+    {}
+
     EventLoop::size_type poll() {
+        LoopInstrumentation::Scope scope{_instrumentation.get()};
+
         return _io_service.poll();
     }
 
     void run() {
-        _io_service.run();
+        runOnThreads(1, [this]() { _io_service.run(); });
+    }
+
+    void run(EventLoop::size_type threadCount) {
+        runOnThreads(threadCount, [this]() { _io_service.run(); });
     }
 
     void runFor(int msec) {
-        _io_service.run_for(std::chrono::milliseconds(msec));
+        runFor(1, msec);
+    }
+
+    void runFor(EventLoop::size_type threadCount, int msec) {
+        // All threads share the same deadline regardless of when they have been started
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(msec);
+
+        runOnThreads(threadCount, [this, deadline]() { _io_service.run_until(deadline); });
+    }
+
+    BusyPollStats runBusyPoll(BusyPollOptions const& options) {
+        return runBusyPollUntil(options, Clock::time_point::max());
+    }
+
+    BusyPollStats runBusyPollFor(BusyPollOptions const& options, int msec) {
+        return runBusyPollUntil(options, Clock::now() + std::chrono::milliseconds(msec));
+    }
+
+    EventLoop::size_type runningThreads() const noexcept {
+        return _runningThreads.load(std::memory_order_relaxed);
+    }
+
+    EventLoop::size_type channelCount() const noexcept {
+        return _channelCount.load(std::memory_order_relaxed);
+    }
+
+    void attachChannel() noexcept {
+        _channelCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void detachChannel() noexcept {
+        _channelCount.fetch_sub(1, std::memory_order_relaxed);
     }
 
     bool isStopped() const {
@@ -37,6 +138,10 @@ public:
     }
 
     void reset() {
+        if (_runningThreads.load() != 0) {
+            return;
+        }
+
         _io_service.reset();
     }
 
@@ -44,6 +149,45 @@ public:
         _io_service.stop();
     }
 
+    bool isRunningInThisThread() noexcept {
+        return _io_service.get_executor().running_in_this_thread();
+    }
+
+    void post(Task&& task) {
+        countQueuedTask();
+
+        if (isRunningInThisThread()) {
+            asio::post(_io_service, TaskHandler{std::move(task)});
+            return;
+        }
+
+        // Once tasks spill over, later ones follow them so that tasks of a thread run in order of submission
+        if (_foreignTasksOverflow.load(std::memory_order_acquire) || !_foreignTasks.tryPush(task)) {
+            std::lock_guard<std::mutex> lock(_overflowMutex);
+            _overflowTasks.emplace_back(std::move(task));
+            _foreignTasksOverflow.store(true, std::memory_order_release);
+        }
+
+        scheduleForeignTasks();
+    }
+
+    void dispatch(Task&& task) {
+        if (isRunningInThisThread()) {
+            task();
+        } else {
+            post(std::move(task));
+        }
+    }
+
+    void defer(Task&& task) {
+        if (isRunningInThisThread()) {
+            countQueuedTask();
+            asio::defer(_io_service, TaskHandler{std::move(task)});
+        } else {
+            post(std::move(task));
+        }
+    }
+
     void onForkChild() {
         _io_service.notify_fork(asio::io_context::fork_event::fork_child);
     }
@@ -52,13 +196,266 @@ public:
         _io_service.notify_fork(asio::io_context::fork_event::fork_parent);
     }
 
+    void enableInstrumentation(InstrumentationOptions&& options) {
+        if (_runningThreads.load() != 0) {
+            return;
+        }
+
+        _lagProbe.cancel();
+        _instrumentation = std::make_unique<LoopInstrumentation>(std::move(options));
+        if (_instrumentation->getOptions().lagProbeInterval.count() > 0) {
+            scheduleLagProbe();
+        }
+    }
+
+    void disableInstrumentation() noexcept {
+        // Note: Instrumentation object is kept alive as threads running the loop may still refer to it.
+        // Lag probe is not re-armed once it sees instrumentation disabled.
+        if (_instrumentation) {
+            _instrumentation->setEnabled(false);
+        }
+    }
+
+    bool isInstrumented() const noexcept {
+        return _instrumentation && _instrumentation->isEnabled();
+    }
+
+    EventLoopStats getStats() const {
+        return _instrumentation
+                ? _instrumentation->snapshot()
+                : EventLoopStats{};
+    }
+
     asio::io_context* getIOService() {
         return &_io_service;
     }
 
 private:
 
-    asio::io_context _io_service;
+    BusyPollStats runBusyPollUntil(BusyPollOptions const& options, Clock::time_point deadline) {
+        BusyPollStats stats;
+
+        runOnThreads(1, [&]() {
+            auto const maxSpin = std::chrono::duration_cast<Clock::duration>(options.spinBudget);
+            auto const minSpin = std::min(maxSpin, std::chrono::duration_cast<Clock::duration>(options.minSpinBudget));
+            auto spinBudget = maxSpin;
+
+            auto now = Clock::now();
+            while (!_io_service.stopped() && now < deadline) {
+                // Spin: poll for ready handlers without blocking
+                auto const spinUntil = std::min(deadline, now + spinBudget);
+                std::size_t nbExecuted = 0;
+                do {
+                    nbExecuted = _io_service.poll();
+                    if (nbExecuted == 0) {
+                        stats.spinCycles += 1;
+                        cpuRelax();
+                    }
+
+                    now = Clock::now();
+                } while (nbExecuted == 0 && now < spinUntil && !_io_service.stopped());
+
+                if (nbExecuted != 0) {
+                    stats.handlersSpinning += nbExecuted;
+                    if (options.adaptive) {
+                        // Work is coming in again: spin for the full budget
+                        spinBudget = maxSpin;
+                    }
+
+                    continue;
+                }
+
+                if (_io_service.stopped() || now >= deadline) {
+                    break;
+                }
+
+                // Nothing came while spinning: block until an event arrives
+                if (options.adaptive) {
+                    spinBudget = std::max(minSpin, spinBudget / 2);
+                }
+
+                auto const sleepFor = std::min<Clock::duration>(options.maxSleep, deadline - now);
+                stats.sleepCycles += 1;
+                stats.handlersSleeping += _io_service.run_one_for(sleepFor);
+
+                now = Clock::now();
+            }
+        });
+
+        return stats;
+    }
+
+    void countQueuedTask() noexcept {
+        if (isInstrumented()) {
+            _instrumentation->taskQueued();
+        }
+    }
+
+    /**
+     * Lag probe measures how late a timer handler is executed after the timer has expired.
+     * This is the time any ready handler has to wait for the loop to pick it up.
+     */
+    void scheduleLagProbe() {
+        _lagProbe.expires_after(_instrumentation->getOptions().lagProbeInterval);
+        _lagProbe.async_wait([this](asio::error_code const& error) {
+            if (error || !isInstrumented()) {
+                return;
+            }
+
+            _instrumentation->recordLag(LoopInstrumentation::clock_type::now() - _lagProbe.expiry());
+            scheduleLagProbe();
+        });
+    }
+
+    /**
+     * Make sure that the loop picks up tasks submitted from foreign threads.
+     * Only one drain handler is queued at a time, so a burst of submissions costs a single wake-up.
+     * The flag stays set until the drain finds the queues empty: with several threads running the loop,
+     * a second drain would otherwise run concurrently with the first and break the order of submission.
+     */
+    void scheduleForeignTasks() {
+        if (!_foreignTasksScheduled.exchange(true, std::memory_order_acq_rel)) {
+            postForeignTasksDrain();
+        }
+    }
+
+    void postForeignTasksDrain() {
+        asio::post(_io_service, [this]() { runForeignTasks(); });
+    }
+
+    void runForeignTasks() {
+        try {
+            do {
+                Task task;
+                while (_foreignTasks.tryPop(task)) {
+                    runQueuedTask(task);
+                }
+
+                while (popOverflowTask(task)) {
+                    runQueuedTask(task);
+                }
+
+                _foreignTasksScheduled.exchange(false, std::memory_order_acq_rel);
+
+                // Tasks pushed after the queues have been seen empty but before the flag was cleared
+                // found the drain scheduled: pick them up unless a new drain has been posted already.
+            } while (hasForeignTasks() && !_foreignTasksScheduled.exchange(true, std::memory_order_acq_rel));
+        } catch (...) {
+            // Tasks left in the queues must still run once the exception has been dealt with.
+            // Note: The flag is still set, so this is the only drain queued.
+            postForeignTasksDrain();
+            throw;
+        }
+    }
+
+    bool hasForeignTasks() const noexcept {
+        return !_foreignTasks.isEmpty() || _foreignTasksOverflow.load(std::memory_order_acquire);
+    }
+
+    /** Take the oldest task that did not fit into the queue. */
+    bool popOverflowTask(Task& task) {
+        if (!_foreignTasksOverflow.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(_overflowMutex);
+        if (_overflowTasks.empty()) {
+            _foreignTasksOverflow.store(false, std::memory_order_release);
+            return false;
+        }
+
+        task = std::move(_overflowTasks.front());
+        _overflowTasks.pop_front();
+
+        return true;
+    }
+
+    struct RunningThreadGuard {
+        ~RunningThreadGuard() { counter.fetch_sub(1); }
+
+        explicit RunningThreadGuard(std::atomic<EventLoop::size_type>& c)
+            : counter(c)
+        {
+            counter.fetch_add(1);
+        }
+
+        std::atomic<EventLoop::size_type>& counter;
+    };
+
+    template<typename F>
+    void runOnThreads(EventLoop::size_type threadCount, F&& runner) {
+        if (threadCount < 2) {
+            // Single threaded mode: exceptions propagate directly and the loop can be resumed.
+            RunningThreadGuard guard{_runningThreads};
+            LoopInstrumentation::Scope scope{_instrumentation.get()};
+            runner();
+
+            return;
+        }
+
+        std::exception_ptr firstError;
+        std::mutex errorGuard;
+
+        auto guardedRun = [&]() {
+            RunningThreadGuard guard{_runningThreads};
+            LoopInstrumentation::Scope scope{_instrumentation.get()};
+
+            try {
+                runner();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorGuard);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+
+                // Make sure other threads don't keep running without us
+                _io_service.stop();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        try {
+            workers.reserve(threadCount - 1);
+            for (EventLoop::size_type i = 1; i < threadCount; ++i) {
+                workers.emplace_back(guardedRun);
+            }
+        } catch (...) {
+            // Workers that have been started must not outlive this call: joinable threads terminate on destruction
+            _io_service.stop();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+
+            throw;
+        }
+
+        // Calling thread is a member of the pool too
+        guardedRun();
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        if (firstError) {
+            std::rethrow_exception(firstError);
+        }
+    }
+
+private:
+
+    asio::io_context                        _io_service;
+    std::atomic<EventLoop::size_type>       _runningThreads{0};
+    std::atomic<EventLoop::size_type>       _channelCount{0};
+
+    std::unique_ptr<LoopInstrumentation>    _instrumentation;
+    asio::steady_timer                      _lagProbe;
+
+    BoundedQueue<Task>                      _foreignTasks;
+    std::atomic<bool>                       _foreignTasksScheduled{false};
+
+    std::mutex                              _overflowMutex;
+    std::deque<Task>                        _overflowTasks;     //!< Tasks submitted while the queue was full.
+    std::atomic<bool>                       _foreignTasksOverflow{false};
 };
 
 
@@ -79,10 +476,42 @@ void EventLoop::run() {
     _pimpl->run();
 }
 
+void EventLoop::run(size_type threadCount) {
+    _pimpl->run(threadCount);
+}
+
 void EventLoop::runFor(int msec) {
     _pimpl->runFor(msec);
 }
 
+void EventLoop::runFor(size_type threadCount, int msec) {
+    _pimpl->runFor(threadCount, msec);
+}
+
+BusyPollStats EventLoop::runBusyPoll(BusyPollOptions const& options) {
+    return _pimpl->runBusyPoll(options);
+}
+
+BusyPollStats EventLoop::runBusyPollFor(BusyPollOptions const& options, int msec) {
+    return _pimpl->runBusyPollFor(options, msec);
+}
+
+EventLoop::size_type EventLoop::runningThreads() const noexcept {
+    return _pimpl->runningThreads();
+}
+
+EventLoop::size_type EventLoop::channelCount() const noexcept {
+    return _pimpl->channelCount();
+}
+
+void EventLoop::attachChannel() noexcept {
+    _pimpl->attachChannel();
+}
+
+void EventLoop::detachChannel() noexcept {
+    _pimpl->detachChannel();
+}
+
 bool EventLoop::isStopped() const noexcept {
     return _pimpl->isStopped();
 }
@@ -95,6 +524,38 @@ void EventLoop::stop() {
     _pimpl->stop();
 }
 
+void EventLoop::post(Task&& task) {
+    _pimpl->post(std::move(task));
+}
+
+void EventLoop::dispatch(Task&& task) {
+    _pimpl->dispatch(std::move(task));
+}
+
+void EventLoop::defer(Task&& task) {
+    _pimpl->defer(std::move(task));
+}
+
+bool EventLoop::isRunningInThisThread() const noexcept {
+    return _pimpl->isRunningInThisThread();
+}
+
+void EventLoop::enableInstrumentation(InstrumentationOptions options) {
+    _pimpl->enableInstrumentation(std::move(options));
+}
+
+void EventLoop::disableInstrumentation() noexcept {
+    _pimpl->disableInstrumentation();
+}
+
+bool EventLoop::isInstrumented() const noexcept {
+    return _pimpl->isInstrumented();
+}
+
+EventLoopStats EventLoop::getStats() const {
+    return _pimpl->getStats();
+}
+
 void* EventLoop::getIOService() noexcept {
     return _pimpl->getIOService();
 }
@@ -0,0 +1,159 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/eventLoopGroup.cpp
+ *******************************************************************************/
+#include "cadence/async/eventLoopGroup.hpp"
+
+#include "asio_helper.hpp"
+
+#include <asio/executor_work_guard.hpp>
+
+#include <pthread.h>
+#include <sched.h>
+
+
+using namespace cadence::async;
+
+
+namespace {
+
+void pinCurrentThread(unsigned core) {
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(core, &cpuSet);
+
+    // Note: Failure to pin a thread is not fatal, the loop will still run, just not pinned.
+    pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#else
+    (void)core;
+#endif
+}
+
+}  // namespace
+
+
+/**
+ * Keeps an event loop running even when it has no work queued.
+ */
+class EventLoopGroup::KeepAlive {
+public:
+
+    explicit KeepAlive(EventLoop& loop)
+        : _guard(asAsioService(loop.getIOService()).get_executor())
+    {}
+
+    void release() {
+        if (!_released.exchange(true)) {
+            _guard.reset();
+        }
+    }
+
+private:
+    asio::executor_work_guard<asio::io_context::executor_type>  _guard;
+    std::atomic<bool>                                           _released{false};
+};
+
+
+EventLoopGroup::~EventLoopGroup() {
+    stop();
+    join();
+}
+
+
+EventLoopGroup::EventLoopGroup(size_type nbLoops, Selection selection, bool pinThreads)
+    : _selection(selection)
+    , _pinThreads(pinThreads)
+{
+    if (nbLoops == 0) {
+        nbLoops = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    _loops.reserve(nbLoops);
+    for (size_type i = 0; i < nbLoops; ++i) {
+        _loops.emplace_back(std::make_unique<EventLoop>());
+    }
+}
+
+
+EventLoop&
+EventLoopGroup::next() {
+    switch (_selection) {
+    case Selection::LeastLoaded: {
+        auto* selected = _loops.front().get();
+        for (auto& loop : _loops) {
+            if (loop->channelCount() < selected->channelCount()) {
+                selected = loop.get();
+            }
+        }
+
+        return *selected;
+    }
+
+    case Selection::RoundRobin:
+        break;
+    }
+
+    auto const index = _nextIndex.fetch_add(1, std::memory_order_relaxed);
+    return *_loops[index % _loops.size()];
+}
+
+
+void EventLoopGroup::start() {
+    if (!_threads.empty()) {  // Already started
+        return;
+    }
+
+    auto const nbCores = std::max(1U, std::thread::hardware_concurrency());
+
+    _keepAlive.clear();
+    _threads.reserve(_loops.size());
+    for (size_type i = 0; i < _loops.size(); ++i) {
+        auto& loop = *_loops[i];
+        loop.reset();
+        _keepAlive.emplace_back(std::make_unique<KeepAlive>(loop));
+
+        _threads.emplace_back([&loop, core = i % nbCores, pin = _pinThreads]() {
+            if (pin) {
+                pinCurrentThread(core);
+            }
+
+            loop.run();
+        });
+    }
+}
+
+
+void EventLoopGroup::run() {
+    start();
+    join();
+}
+
+
+void EventLoopGroup::stop() {
+    for (auto& keepAlive : _keepAlive) {
+        keepAlive->release();
+    }
+
+    for (auto& loop : _loops) {
+        loop->stop();
+    }
+}
+
+
+void EventLoopGroup::join() {
+    for (auto& thread : _threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    _threads.clear();
+}
@@ -0,0 +1,300 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/framedChannel.cpp
+ *******************************************************************************/
+#include "cadence/async/framedChannel.hpp"
+
+#include "asynErrorDomain.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+using size_type = FramedChannel::size_type;
+
+/// Outcome of parsing a frame header from the buffered data.
+struct Header {
+    int         errorCode{0};   //!< Non-zero if the header is malformed.
+    size_type   headerSize{0};  //!< Zero if more data is needed to parse the header.
+    size_type   frameSize{0};
+};
+
+
+size_type headerSizeOf(FrameLengthEncoding encoding, size_type frameSize) noexcept {
+    switch (encoding) {
+    case FrameLengthEncoding::Fixed16: return 2;
+    case FrameLengthEncoding::Fixed32: return 4;
+    case FrameLengthEncoding::Varint: break;
+    }
+
+    size_type n = 1;
+    while (frameSize >= 0x80) {
+        frameSize >>= 7;
+        n += 1;
+    }
+
+    return n;
+}
+
+
+Header parseHeader(FrameLengthEncoding encoding, MemoryView data) noexcept {
+    auto const* bytes = data.dataAddress();
+    auto const available = data.size();
+    Header header;
+
+    switch (encoding) {
+    case FrameLengthEncoding::Fixed16:
+        if (available >= 2) {
+            header.headerSize = 2;
+            header.frameSize = (size_type{bytes[0]} << 8) | bytes[1];
+        }
+        break;
+
+    case FrameLengthEncoding::Fixed32:
+        if (available >= 4) {
+            header.headerSize = 4;
+            header.frameSize = (size_type{bytes[0]} << 24) | (size_type{bytes[1]} << 16) |
+                    (size_type{bytes[2]} << 8) | bytes[3];
+        }
+        break;
+
+    case FrameLengthEncoding::Varint: {
+        uint64 value = 0;
+        for (size_type i = 0; i < std::min(available, FramedChannel::kMaxHeaderSize); ++i) {
+            value |= uint64{bytes[i] & 0x7fu} << (7 * i);
+            if ((bytes[i] & 0x80) == 0) {
+                if (value > std::numeric_limits<size_type>::max()) {
+                    header.errorCode = EBADMSG;
+                } else {
+                    header.headerSize = i + 1;
+                    header.frameSize = static_cast<size_type>(value);
+                }
+                return header;
+            }
+        }
+
+        if (available >= FramedChannel::kMaxHeaderSize) {
+            header.errorCode = EBADMSG;
+        }
+    } break;
+    }
+
+    return header;
+}
+
+
+size_type encodeHeader(FrameLengthEncoding encoding, size_type frameSize, byte* dest) noexcept {
+    switch (encoding) {
+    case FrameLengthEncoding::Fixed16:
+        dest[0] = static_cast<byte>(frameSize >> 8);
+        dest[1] = static_cast<byte>(frameSize);
+        return 2;
+
+    case FrameLengthEncoding::Fixed32:
+        dest[0] = static_cast<byte>(frameSize >> 24);
+        dest[1] = static_cast<byte>(frameSize >> 16);
+        dest[2] = static_cast<byte>(frameSize >> 8);
+        dest[3] = static_cast<byte>(frameSize);
+        return 4;
+
+    case FrameLengthEncoding::Varint: break;
+    }
+
+    size_type n = 0;
+    while (frameSize >= 0x80) {
+        dest[n++] = static_cast<byte>(frameSize | 0x80);
+        frameSize >>= 7;
+    }
+    dest[n++] = static_cast<byte>(frameSize);
+
+    return n;
+}
+
+
+size_type maxEncodableFrameSize(FrameLengthEncoding encoding) noexcept {
+    switch (encoding) {
+    case FrameLengthEncoding::Fixed16: return 0xffff;
+    case FrameLengthEncoding::Fixed32:
+    case FrameLengthEncoding::Varint: break;
+    }
+
+    return std::numeric_limits<size_type>::max();
+}
+
+
+template<typename T>
+Future<T> failedFuture(int errorCode, StringLiteral tag) {
+    Promise<T> promise;
+    auto f = promise.getFuture();
+    promise.setError(makeError(AsyncError::AsyncSystemError, errorCode, tag));
+
+    return f;
+}
+
+}  // namespace
+
+
+FramedChannel::WriteCompletion::WriteCompletion(FramedChannel* self) noexcept
+    : AsyncCompletion(&FramedChannel::onWrite)
+    , owner(self)
+{}
+
+
+FramedChannel::~FramedChannel() = default;
+
+
+FramedChannel::FramedChannel(Channel& channel, FrameLengthEncoding encoding, size_type maxFrameSize)
+    : _encoding(encoding)
+    , _maxFrameSize(std::min(maxFrameSize, maxEncodableFrameSize(encoding)))
+    // Buffer must fit the largest frame, but can hold a lot of small ones too
+    , _buffered(channel, std::max(BufferedChannel::kDefaultCapacity,
+                                  headerSizeOf(encoding, _maxFrameSize) + _maxFrameSize))
+    , _writeDone(this)
+{}
+
+
+Future<MemoryView>
+FramedChannel::asyncReadFrame() {
+    if (_reading) {
+        return failedFuture<MemoryView>(EALREADY, "asyncReadFrame");
+    }
+
+    // Frame handed out last is no longer in use
+    _buffered.consume(_frameSize);
+    _frameSize = 0;
+
+    _reading = true;
+    _readPromise = Promise<MemoryView>{};
+    auto f = _readPromise.getFuture();
+
+    resumeRead();
+
+    return f;
+}
+
+
+void FramedChannel::resumeRead() {
+    auto const header = parseHeader(_encoding, _buffered.peek());
+    if (header.errorCode) {
+        failRead(makeError(AsyncError::AsyncSystemError, header.errorCode, "asyncReadFrame"));
+        return;
+    }
+
+    if (header.headerSize != 0 && header.frameSize > _maxFrameSize) {
+        failRead(makeError(AsyncError::AsyncSystemError, EMSGSIZE, "asyncReadFrame"));
+        return;
+    }
+
+    auto const needed = (header.headerSize == 0)
+            ? _buffered.size() + 1
+            : header.headerSize + header.frameSize;
+
+    if (header.headerSize != 0 && _buffered.size() >= needed) {
+        _frameSize = needed;
+
+        // Note: promise is moved out as its continuation may start the next read
+        auto promise = std::move(_readPromise);
+        _reading = false;
+        promise.setValue(_buffered.peek().slice(header.headerSize, needed));
+        return;
+    }
+
+    _buffered.asyncPeek(needed)
+            .then([this](size_type) {
+                resumeRead();
+            })
+            .onError([this](Error&& e) {
+                failRead(std::move(e));
+            });
+}
+
+
+void FramedChannel::failRead(Error&& error) {
+    auto promise = std::move(_readPromise);
+    _reading = false;
+    promise.setError(std::move(error));
+}
+
+
+Channel::WriteBuffers
+FramedChannel::prepareFrame(ByteReader& payload, size_type bytesToWrite) {
+    auto const headerSize = encodeHeader(_encoding, bytesToWrite, _header);
+
+    _writeBuffers[0] = ByteReader(wrapMemory(_header, headerSize));
+    _writeBuffers[1] = ByteReader(payload.viewRemaining().slice(0, bytesToWrite));
+
+    return arrayView(_writeBuffers);
+}
+
+
+Future<void>
+FramedChannel::asyncWriteFrame(ByteReader& payload, size_type bytesToWrite) {
+    if (bytesToWrite > _maxFrameSize) {
+        return failedFuture<void>(EMSGSIZE, "asyncWriteFrame");
+    }
+
+    if (_writing) {
+        return failedFuture<void>(EALREADY, "asyncWriteFrame");
+    }
+
+    _writing = true;
+    _writePromise = Promise<void>{};
+    auto f = _writePromise.getFuture();
+
+    _writeDone.payload = &payload;
+    _writeDone.bytes = bytesToWrite;
+    getChannel().asyncWritev(prepareFrame(payload, bytesToWrite), _writeDone);
+
+    return f;
+}
+
+
+Result<void, Error>
+FramedChannel::writeFrame(ByteReader& payload, size_type bytesToWrite) {
+    if (bytesToWrite > _maxFrameSize) {
+        return Err(makeError(AsyncError::AsyncSystemError, EMSGSIZE, "writeFrame"));
+    }
+
+    if (_writing) {
+        return Err(makeError(AsyncError::AsyncSystemError, EALREADY, "writeFrame"));
+    }
+
+    auto result = getChannel().writev(prepareFrame(payload, bytesToWrite));
+    if (!result) {
+        return result;
+    }
+
+    return payload.advance(bytesToWrite);
+}
+
+
+void FramedChannel::onWrite(AsyncCompletion& self) {
+    auto& completion = static_cast<WriteCompletion&>(self);
+    auto& owner = *completion.owner;
+
+    auto promise = std::move(owner._writePromise);
+    owner._writing = false;
+
+    if (completion.isError()) {
+        promise.setError(completion.getError());
+        return;
+    }
+
+    completion.payload->advance(completion.bytes);
+    promise.setValue();
+}
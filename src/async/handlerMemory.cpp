@@ -0,0 +1,158 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/handlerMemory.cpp
+ *******************************************************************************/
+#include "handlerMemory.hpp"
+
+#include <algorithm>
+#include <new>
+
+
+using namespace cadence::async;
+
+
+namespace {
+
+// Each block is prefixed with a header recording which slot it came from.
+constexpr std::size_t kHeaderSize = alignof(std::max_align_t);
+constexpr std::size_t kHeapBlock = HandlerMemory::kNbSlots;
+
+static_assert(sizeof(std::size_t) <= kHeaderSize, "Block header does not fit slot index");
+
+void* markBlock(void* block, std::size_t slotIndex) noexcept {
+    *static_cast<std::size_t*>(block) = slotIndex;
+    return static_cast<std::byte*>(block) + kHeaderSize;
+}
+
+}  // namespace
+
+
+HandlerMemory::~HandlerMemory() {
+    for (auto& slot : _slots) {
+        ::operator delete(slot.block);
+    }
+}
+
+
+void*
+HandlerMemory::allocate(std::size_t size) {
+    auto const blockSize = size + kHeaderSize;
+
+    // First try to reuse a free block large enough, then grow any free block.
+    for (int pass = 0; pass < 2; ++pass) {
+        for (std::size_t i = 0; i < kNbSlots; ++i) {
+            auto& slot = _slots[i];
+            bool expected = false;
+            if (!slot.inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                continue;
+            }
+
+            if (slot.capacity < blockSize) {
+                if (pass == 0) {
+                    slot.inUse.store(false, std::memory_order_release);
+                    continue;
+                }
+
+                auto const capacity = std::max(blockSize, kMinBlockSize);
+                void* block = ::operator new(capacity, std::nothrow);
+                if (!block) {
+                    slot.inUse.store(false, std::memory_order_release);
+                    break;
+                }
+
+                ::operator delete(slot.block);
+                slot.block = block;
+                slot.capacity = capacity;
+            }
+
+            retain();
+            return markBlock(slot.block, i);
+        }
+    }
+
+    void* block = ::operator new(blockSize);
+    retain();
+
+    return markBlock(block, kHeapBlock);
+}
+
+
+void
+HandlerMemory::deallocate(void* pointer) noexcept {
+    auto block = static_cast<std::byte*>(pointer) - kHeaderSize;
+    auto const slotIndex = *reinterpret_cast<std::size_t*>(block);
+
+    if (slotIndex < kNbSlots) {
+        _slots[slotIndex].inUse.store(false, std::memory_order_release);
+    } else {
+        ::operator delete(block);
+    }
+
+    release();
+}
+
+
+void*
+HandlerMemory::allocateRecord(std::size_t size, Dispose dispose) {
+    auto* header = ::new (allocate(kRecordHeaderSize + size)) RecordHeader{nullptr, nullptr, dispose};
+
+    {
+        std::lock_guard<std::mutex> lock(_recordsMutex);
+        header->next = _records;
+        if (_records) {
+            _records->prev = header;
+        }
+        _records = header;
+        _nbRecords.fetch_add(1, std::memory_order_release);
+    }
+
+    return reinterpret_cast<std::byte*>(header) + kRecordHeaderSize;
+}
+
+
+void
+HandlerMemory::deallocateRecord(void* record) noexcept {
+    auto* header = reinterpret_cast<RecordHeader*>(static_cast<std::byte*>(record) - kRecordHeaderSize);
+
+    {
+        std::lock_guard<std::mutex> lock(_recordsMutex);
+        if (header->prev) {
+            header->prev->next = header->next;
+        } else {
+            _records = header->next;
+        }
+
+        if (header->next) {
+            header->next->prev = header->prev;
+        }
+        _nbRecords.fetch_sub(1, std::memory_order_release);
+    }
+
+    // Releases the reference held by the record, possibly the last one
+    deallocate(header);
+}
+
+
+void
+HandlerMemory::disposeRecords() noexcept {
+    RecordHeader* records = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_recordsMutex);
+        records = std::exchange(_records, nullptr);
+        _nbRecords.store(0, std::memory_order_release);
+    }
+
+    // Memory is destroyed once the last record is freed: only locals are used from here on.
+    while (records) {
+        auto* header = std::exchange(records, records->next);
+        header->dispose(reinterpret_cast<std::byte*>(header) + kRecordHeaderSize);
+        deallocate(header);
+    }
+}
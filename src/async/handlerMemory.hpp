@@ -0,0 +1,270 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Recycling memory for async operation handlers
+ *	@file		async/handlerMemory.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_HANDLERMEMORY_HPP
+#define CADENCE_ASYNC_HANDLERMEMORY_HPP
+
+#include "cadence/async/completion.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+
+
+namespace cadence::async {
+
+/**
+ * Per io-object memory used by asio to store states of pending operations.
+ *
+ * A few blocks are kept and reused once an operation completes, so that in a steady state
+ * starting an async operation does not allocate. If all blocks are in use, i.e. more operations are
+ * pending concurrently, memory is allocated from the heap as usual.
+ *
+ * Operations may outlive the io-object that started them (ones aborted on close are completed later),
+ * so the memory is reference counted: by its owner and by each outstanding block.
+ *
+ * Completion records of callback based operations are allocated from the same blocks.
+ * Records are only ever completed by a pending operation, so once the owner and all blocks of pending operations
+ * are released, records still outstanding are disposed of: their operations can no longer complete.
+ */
+class HandlerMemory final :
+        public CompletionMemory {
+public:
+
+    /// An operation takes a block for its state and a callback based one another for its completion record.
+    static constexpr std::size_t kNbSlots = 8;
+    static constexpr std::size_t kMinBlockSize = 256;
+
+    /** Create a new handler memory owned by the caller. @see HandlerMemoryRef */
+    static HandlerMemory* create() {
+        return new HandlerMemory();
+    }
+
+    HandlerMemory(HandlerMemory const&) = delete;
+    HandlerMemory& operator= (HandlerMemory const&) = delete;
+
+    void* allocate(std::size_t size);
+
+    void deallocate(void* pointer) noexcept;
+
+    void* allocateRecord(std::size_t size, Dispose dispose) override;
+
+    void deallocateRecord(void* record) noexcept override;
+
+    void retain() noexcept {
+        _refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() noexcept {
+        auto const remaining = _refCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        if (remaining == 0) {
+            delete this;
+        } else if (remaining == _nbRecords.load(std::memory_order_acquire)) {
+            disposeRecords();
+        }
+    }
+
+private:
+
+    HandlerMemory() noexcept = default;
+    ~HandlerMemory();
+
+    /** Header of a block holding a completion record. */
+    struct RecordHeader {
+        RecordHeader*   prev;
+        RecordHeader*   next;
+        Dispose         dispose;
+    };
+
+    /// Size of the record header, rounded up to keep records aligned.
+    static constexpr std::size_t kRecordHeaderSize =
+        (sizeof(RecordHeader) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    /** Dispose of records left when only they keep the memory alive. */
+    void disposeRecords() noexcept;
+
+    struct Slot {
+        std::atomic<bool>   inUse{false};
+        void*               block{nullptr};
+        std::size_t         capacity{0};
+    };
+
+    Slot                        _slots[kNbSlots];
+    std::atomic<std::size_t>    _refCount{1};
+
+    std::mutex                  _recordsMutex;      //!< Guards the list of outstanding records.
+    RecordHeader*               _records{nullptr};
+    std::atomic<std::size_t>    _nbRecords{0};
+};
+
+
+/**
+ * Owning reference to a HandlerMemory held by an io-object.
+ */
+class HandlerMemoryRef {
+public:
+
+    HandlerMemoryRef()
+        : _memory(HandlerMemory::create())
+    {}
+
+    ~HandlerMemoryRef() {
+        if (_memory) {
+            _memory->release();
+        }
+    }
+
+    HandlerMemoryRef(HandlerMemoryRef const&) = delete;
+    HandlerMemoryRef& operator= (HandlerMemoryRef const&) = delete;
+
+    HandlerMemoryRef(HandlerMemoryRef&& rhs) noexcept
+        : _memory(std::exchange(rhs._memory, nullptr))
+    {}
+
+    HandlerMemoryRef& operator= (HandlerMemoryRef&& rhs) noexcept {
+        std::swap(_memory, rhs._memory);
+        return *this;
+    }
+
+    HandlerMemory* get() const noexcept { return _memory; }
+
+private:
+    HandlerMemory* _memory;
+};
+
+
+/**
+ * Standard allocator that allocates from a HandlerMemory.
+ * An allocator without memory, i.e. made from a moved-from HandlerMemoryRef, falls back to the heap.
+ */
+template<typename T>
+class HandlerAllocator {
+public:
+    using value_type = T;
+
+    explicit HandlerAllocator(HandlerMemory* memory) noexcept
+        : _memory(memory)
+    {}
+
+    template<typename U>
+    HandlerAllocator(HandlerAllocator<U> const& other) noexcept
+        : _memory(other.memory())
+    {}
+
+    T* allocate(std::size_t n) {
+        if (!_memory) {
+            return static_cast<T*>(::operator new(sizeof(T) * n));
+        }
+
+        return static_cast<T*>(_memory->allocate(sizeof(T) * n));
+    }
+
+    void deallocate(T* pointer, std::size_t) noexcept {
+        if (!_memory) {
+            ::operator delete(pointer);
+            return;
+        }
+
+        _memory->deallocate(pointer);
+    }
+
+    HandlerMemory* memory() const noexcept { return _memory; }
+
+    template<typename U>
+    bool operator== (HandlerAllocator<U> const& rhs) const noexcept { return _memory == rhs.memory(); }
+
+    template<typename U>
+    bool operator!= (HandlerAllocator<U> const& rhs) const noexcept { return _memory != rhs.memory(); }
+
+private:
+    HandlerMemory* _memory;
+};
+
+
+/**
+ * Completion handler which associated allocator takes memory from a HandlerMemory.
+ *
+ * The handler holds a reference to the memory: asio frees the block of an operation before invoking its handler,
+ * and completion records allocated from the memory must outlive the handler that completes them.
+ */
+template<typename Handler>
+class AllocatingHandler {
+public:
+    using allocator_type = HandlerAllocator<Handler>;
+
+    template<typename H>
+    AllocatingHandler(H&& h, HandlerMemory* memory)
+        : _handler(std::forward<H>(h))
+        , _memory(memory)
+    {
+        if (_memory) {
+            _memory->retain();
+        }
+    }
+
+    AllocatingHandler(AllocatingHandler const& rhs)
+        : _handler(rhs._handler)
+        , _memory(rhs._memory)
+    {
+        if (_memory) {
+            _memory->retain();
+        }
+    }
+
+    // A moved-from handler keeps its reference: asio may still use its allocator to free the operation block.
+    AllocatingHandler(AllocatingHandler&& rhs)
+        : _handler(std::move(rhs._handler))
+        , _memory(rhs._memory)
+    {
+        if (_memory) {
+            _memory->retain();
+        }
+    }
+
+    AllocatingHandler& operator= (AllocatingHandler const&) = delete;
+    AllocatingHandler& operator= (AllocatingHandler&&) = delete;
+
+    ~AllocatingHandler() {
+        if (_memory) {
+            _memory->release();
+        }
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return allocator_type{_memory};
+    }
+
+    template<typename... Args>
+    void operator() (Args&&... args) {
+        _handler(std::forward<Args>(args)...);
+    }
+
+private:
+    Handler         _handler;
+    HandlerMemory*  _memory;
+};
+
+
+/**
+ * Make a handler which state is allocated from the given memory.
+ * @note A moved-from io-object has no memory: handlers of operations it starts are allocated from the heap.
+ */
+template<typename Handler>
+AllocatingHandler<std::decay_t<Handler>> allocateFrom(HandlerMemoryRef const& memory, Handler&& handler) {
+    return AllocatingHandler<std::decay_t<Handler>>{std::forward<Handler>(handler), memory.get()};
+}
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_HANDLERMEMORY_HPP
@@ -0,0 +1,77 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/loopInstrumentation.cpp
+ *******************************************************************************/
+#include "loopInstrumentation.hpp"
+
+
+using namespace Solace;
+using namespace cadence::async;
+
+
+void
+AtomicDurationHistogram::record(duration_type value) noexcept {
+    _buckets[DurationHistogram::bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    _total.fetch_add(value.count(), std::memory_order_relaxed);
+
+    auto currentMax = _max.load(std::memory_order_relaxed);
+    while (currentMax < value.count() &&
+           !_max.compare_exchange_weak(currentMax, value.count(), std::memory_order_relaxed)) {
+    }
+}
+
+
+DurationHistogram
+AtomicDurationHistogram::snapshot() const noexcept {
+    DurationHistogram::Buckets buckets;
+    for (DurationHistogram::size_type i = 0; i < DurationHistogram::kNbBuckets; ++i) {
+        buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+    }
+
+    return {buckets,
+            duration_type{_total.load(std::memory_order_relaxed)},
+            duration_type{_max.load(std::memory_order_relaxed)}};
+}
+
+
+void
+LoopInstrumentation::recordHandler(clock_type::duration elapsed) {
+    auto const elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+    _handlerTime.record(elapsedUs);
+
+    auto const budget = _options.handlerBudget;
+    if (budget.count() > 0 && elapsed > budget) {
+        _budgetExceeded.fetch_add(1, std::memory_order_relaxed);
+
+        if (_options.onBudgetExceeded) {
+            _options.onBudgetExceeded(elapsedUs);
+        }
+    }
+}
+
+
+void
+LoopInstrumentation::recordLag(clock_type::duration lag) noexcept {
+    _loopLag.record(std::chrono::duration_cast<std::chrono::microseconds>(lag));
+}
+
+
+EventLoopStats
+LoopInstrumentation::snapshot() const noexcept {
+    EventLoopStats stats;
+    stats.handlerTime = _handlerTime.snapshot();
+    stats.loopLag = _loopLag.snapshot();
+    stats.budgetExceeded = _budgetExceeded.load(std::memory_order_relaxed);
+
+    auto const queued = _tasksQueued.load(std::memory_order_relaxed);
+    stats.tasksQueued = (queued > 0) ? static_cast<uint64>(queued) : 0;
+
+    return stats;
+}
@@ -0,0 +1,164 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Event loop instrumentation internals
+ *	@file		async/loopInstrumentation.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_LOOPINSTRUMENTATION_HPP
+#define CADENCE_ASYNC_LOOPINSTRUMENTATION_HPP
+
+#include "cadence/async/eventLoopStats.hpp"
+
+#include <atomic>
+#include <utility>
+
+
+namespace cadence::async {
+
+/**
+ * Lock-free counterpart of DurationHistogram that can be updated from multiple threads.
+ */
+class AtomicDurationHistogram {
+public:
+    using duration_type = DurationHistogram::duration_type;
+
+    void record(duration_type value) noexcept;
+
+    DurationHistogram snapshot() const noexcept;
+
+private:
+    std::array<std::atomic<Solace::uint64>, DurationHistogram::kNbBuckets> _buckets{};
+    std::atomic<duration_type::rep>     _total{0};
+    std::atomic<duration_type::rep>     _max{0};
+};
+
+
+/**
+ * Instrumentation state of an event loop.
+ * Threads running an instrumented loop install it as `current()` so that handlers can be timed
+ * without knowing which loop they belong to.
+ */
+class LoopInstrumentation {
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    /**
+     * Install loop instrumentation as current for the calling thread for the lifetime of the scope.
+     */
+    class Scope {
+    public:
+        ~Scope() { tCurrent = _previous; }
+
+        explicit Scope(LoopInstrumentation* instrumentation) noexcept
+            : _previous(std::exchange(tCurrent, instrumentation))
+        {}
+
+        Scope(Scope const&) = delete;
+        Scope& operator= (Scope const&) = delete;
+
+    private:
+        LoopInstrumentation* _previous;
+    };
+
+    /**
+     * Get instrumentation of the loop run by the calling thread if it is enabled.
+     * @return Instrumentation to report to or nullptr.
+     */
+    static LoopInstrumentation* current() noexcept {
+        auto* const instrumentation = tCurrent;
+
+        return (instrumentation && instrumentation->isEnabled())
+                ? instrumentation
+                : nullptr;
+    }
+
+    /**
+     * Invoke a handler, recording its execution time with the current loop instrumentation.
+     * Handlers invoked from within another handler, i.e. by dispatch, are accounted for in the outer one.
+     */
+    template<typename F, typename... Args>
+    static void invoke(F& f, Args&&... args) {
+        auto* const instrumentation = current();
+        if (!instrumentation || tDepth != 0) {
+            f(std::forward<Args>(args)...);
+            return;
+        }
+
+        auto const startedAt = clock_type::now();
+        {
+            DepthGuard guard;
+            f(std::forward<Args>(args)...);
+        }
+
+        instrumentation->recordHandler(clock_type::now() - startedAt);
+    }
+
+public:
+
+    explicit LoopInstrumentation(InstrumentationOptions options)
+        : _options(std::move(options))
+    {}
+
+    InstrumentationOptions const& getOptions() const noexcept { return _options; }
+
+    bool isEnabled() const noexcept { return _enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled) noexcept { _enabled.store(enabled, std::memory_order_relaxed); }
+
+    void recordHandler(clock_type::duration elapsed);
+    void recordLag(clock_type::duration lag) noexcept;
+
+    void taskQueued() noexcept { _tasksQueued.fetch_add(1, std::memory_order_relaxed); }
+    void taskExecuted() noexcept { _tasksQueued.fetch_sub(1, std::memory_order_relaxed); }
+
+    EventLoopStats snapshot() const noexcept;
+
+private:
+
+    struct DepthGuard {
+        DepthGuard() noexcept { ++tDepth; }
+        ~DepthGuard() { --tDepth; }
+    };
+
+    inline static thread_local LoopInstrumentation*     tCurrent = nullptr;
+    inline static thread_local unsigned                 tDepth = 0;
+
+    InstrumentationOptions              _options;
+    std::atomic<bool>                   _enabled{true};
+
+    AtomicDurationHistogram             _handlerTime;
+    AtomicDurationHistogram             _loopLag;
+    std::atomic<Solace::uint64>         _budgetExceeded{0};
+
+    // Signed as tasks queued before instrumentation was enabled may be executed after
+    std::atomic<Solace::int64>          _tasksQueued{0};
+};
+
+
+/**
+ * Completion handler adapter that reports handler execution time to the current loop instrumentation.
+ */
+template<typename Handler>
+struct TrackedHandler {
+    Handler handler;
+
+    template<typename... Args>
+    void operator() (Args&&... args) {
+        LoopInstrumentation::invoke(handler, std::forward<Args>(args)...);
+    }
+};
+
+
+template<typename Handler>
+TrackedHandler<std::decay_t<Handler>> trackHandler(Handler&& handler) {
+    return {std::forward<Handler>(handler)};
+}
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_LOOPINSTRUMENTATION_HPP
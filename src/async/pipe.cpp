@@ -12,6 +12,7 @@
 #include "cadence/async/pipe.hpp"
 
 #include "asio_helper.hpp"
+#include "deadlineCompletion.hpp"
 
 #include <asio/posix/stream_descriptor.hpp>
 #include <asio/read.hpp>
@@ -54,7 +55,9 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        _in.async_read_some(asio_buffer(dest, bytesToRead),
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto handler) {
+                _in.async_read_some(buffer, std::move(handler));
+            },
             [&dest, pm = std::move(promise)](const asio::error_code error, std::size_t length) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncRead"));
@@ -72,7 +75,9 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        _out.async_write_some(asio_buffer(src, bytesToWrite),
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(src, bytesToWrite)](auto handler) {
+                _out.async_write_some(buffer, std::move(handler));
+            },
             [&src, pm = std::move(promise)](const asio::error_code error, std::size_t length) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncWrite"));
@@ -113,6 +118,102 @@ public:
     }
 
 
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto handler) {
+                _in.async_read_some(buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(src, bytesToWrite)](auto handler) {
+                _out.async_write_some(buffer, std::move(handler));
+            },
+            completionHandler(completion, src, "asyncWrite"));
+    }
+
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, Deadline deadline, AsyncCompletion& completion) {
+        auto& guard = DeadlineCompletion::create(_in.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+        initiateOn(_strand, _handlerMemory,
+            [this, buffer = asio_buffer(dest, bytesToRead), slot = guard.slot()](auto handler) {
+                _in.async_read_some(buffer, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            completionHandler(guard, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, Deadline deadline, AsyncCompletion& completion) {
+        auto& guard = DeadlineCompletion::create(_out.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+        initiateOn(_strand, _handlerMemory,
+            [this, buffer = asio_buffer(src, bytesToWrite), slot = guard.slot()](auto handler) {
+                _out.async_write_some(buffer, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            completionHandler(guard, src, "asyncWrite"));
+    }
+
+    void asyncReadSome(ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, maxBytesToRead)](auto handler) {
+                _in.async_read_some(buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncReadSome"));
+    }
+
+    Result<size_type, Error>
+    readSome(ByteWriter& dest, size_type maxBytesToRead) {
+        asio::error_code ec;
+
+        auto const len = _in.read_some(asio_buffer(dest, maxBytesToRead), ec);
+        if (ec) {
+            return Err(fromAsioError(ec, "readSome"));
+        }
+
+        dest.advance(len);
+        return Ok(static_cast<size_type>(len));
+    }
+
+    void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffers = asio_buffers(dests)](auto handler) {
+                asio::async_read(_in, buffers, std::move(handler));
+            },
+            buffersCompletionHandler(completion, dests, "asyncReadv"));
+    }
+
+    void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffers = asio_buffers(srcs)](auto handler) {
+                asio::async_write(_out, buffers, std::move(handler));
+            },
+            buffersCompletionHandler(completion, srcs, "asyncWritev"));
+    }
+
+    Result<void, Error> readv(ReadBuffers dests) {
+        asio::error_code ec;
+
+        auto const len = asio::read(_in, asio_buffers(dests), ec);
+        advanceBuffers(dests, len);
+        if (ec) {
+            return Err(fromAsioError(ec, "readv"));
+        }
+
+        return Ok();
+    }
+
+    Result<void, Error> writev(WriteBuffers srcs) {
+        asio::error_code ec;
+
+        auto const len = asio::write(_out, asio_buffers(srcs), ec);
+        advanceBuffers(srcs, len);
+        if (ec) {
+            return Err(fromAsioError(ec, "writev"));
+        }
+
+        return Ok();
+    }
+
+    void bindTo(Strand& strand) {
+        _strand = &strand;
+    }
+
     void cancel() {
         _in.cancel();
         _out.cancel();
@@ -131,9 +232,19 @@ public:
         return !isOpen();
     }
 
+    NativeHandles getNativeHandles() {
+        return {_in.native_handle(), _out.native_handle()};
+    }
+
+    CompletionMemory* getCompletionMemory() noexcept {
+        return _handlerMemory.get();
+    }
+
 private:
     asio::posix::stream_descriptor _in;
     asio::posix::stream_descriptor _out;
+    Strand* _strand{nullptr};
+    HandlerMemoryRef _handlerMemory;
 };
 
 
@@ -180,6 +291,50 @@ Result<void, Error> Pipe::write(ByteReader& src, size_type bytesToWrite) {
 }
 
 
+void Pipe::asyncRead(ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) {
+    _pimpl->asyncRead(dest, bytesToRead, completion);
+}
+
+void Pipe::asyncWrite(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) {
+    _pimpl->asyncWrite(src, bytesToWrite, completion);
+}
+
+void Pipe::asyncRead(ByteWriter& dest, size_type bytesToRead, Deadline deadline, AsyncCompletion& completion) {
+    _pimpl->asyncRead(dest, bytesToRead, deadline, completion);
+}
+
+void Pipe::asyncWrite(ByteReader& src, size_type bytesToWrite, Deadline deadline, AsyncCompletion& completion) {
+    _pimpl->asyncWrite(src, bytesToWrite, deadline, completion);
+}
+
+void Pipe::asyncReadSome(ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) {
+    _pimpl->asyncReadSome(dest, maxBytesToRead, completion);
+}
+
+Result<Pipe::size_type, Error> Pipe::readSome(ByteWriter& dest, size_type maxBytesToRead) {
+    return _pimpl->readSome(dest, maxBytesToRead);
+}
+
+void Pipe::asyncReadv(ReadBuffers dests, AsyncCompletion& completion) {
+    _pimpl->asyncReadv(dests, completion);
+}
+
+void Pipe::asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) {
+    _pimpl->asyncWritev(srcs, completion);
+}
+
+Result<void, Error> Pipe::readv(ReadBuffers dests) {
+    return _pimpl->readv(dests);
+}
+
+Result<void, Error> Pipe::writev(WriteBuffers srcs) {
+    return _pimpl->writev(srcs);
+}
+
+void Pipe::bindTo(Strand& strand) {
+    _pimpl->bindTo(strand);
+}
+
 void Pipe::cancel() {
     _pimpl->cancel();
 }
@@ -195,3 +350,11 @@ bool Pipe::isOpen() const {
 bool Pipe::isClosed() const {
     return _pimpl->isClosed();
 }
+
+Channel::NativeHandles Pipe::getNativeHandles() {
+    return _pimpl->getNativeHandles();
+}
+
+CompletionMemory* Pipe::getCompletionMemory() noexcept {
+    return _pimpl ? _pimpl->getCompletionMemory() : nullptr;
+}
@@ -0,0 +1,64 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Completion record resolving a promise
+ *	@file		async/promiseCompletion.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_PROMISECOMPLETION_HPP
+#define CADENCE_ASYNC_PROMISECOMPLETION_HPP
+
+#include "cadence/async/completion.hpp"
+
+#include <solace/future.hpp>
+
+#include <memory>
+#include <type_traits>
+
+
+namespace cadence::async {
+
+/**
+ * Completion record that resolves a promise and releases itself once notified.
+ * Adapts completion record based operations to their future based versions.
+ * Non-void promises are resolved with the result value of the operation, i.e. number of bytes transferred.
+ */
+template<typename T>
+class PromiseCompletion :
+        public AsyncCompletion {
+public:
+
+    static AsyncCompletion& create(Solace::Promise<T>&& promise) {
+        return *new PromiseCompletion(std::move(promise));
+    }
+
+private:
+
+    explicit PromiseCompletion(Solace::Promise<T>&& promise)
+        : AsyncCompletion(&PromiseCompletion::resolve)
+        , _promise(std::move(promise))
+    {}
+
+    static void resolve(AsyncCompletion& self) {
+        std::unique_ptr<PromiseCompletion> completion{static_cast<PromiseCompletion*>(&self)};
+
+        if (completion->isError()) {
+            completion->_promise.setError(completion->getError());
+        } else if constexpr (std::is_void_v<T>) {
+            completion->_promise.setValue();
+        } else {
+            completion->_promise.setValue(static_cast<T>(completion->getValue()));
+        }
+    }
+
+    Solace::Promise<T> _promise;
+};
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_PROMISECOMPLETION_HPP
@@ -0,0 +1,496 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/relay.cpp
+ *******************************************************************************/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // splice, pipe2, F_SETPIPE_SZ
+#endif
+
+#include "cadence/async/relay.hpp"
+
+#include "asio_helper.hpp"
+
+#include <asio/posix/stream_descriptor.hpp>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+constexpr std::size_t kCopyBufferSize = 16 * 1024;
+
+}  // namespace
+
+
+/**
+ * One direction of the relay: moves data from source descriptor into the pipe and from the pipe into destination.
+ * The flow is shared with its pending wait: a relay destroyed mid-way leaves the wait a live flow to complete into.
+ */
+class RelayFlow :
+        public std::enable_shared_from_this<RelayFlow> {
+public:
+
+    using size_type = Relay::size_type;
+    using OnDone = void (*)(void* owner, int errorCode);
+
+    explicit RelayFlow(asio::io_context& ioContext)
+        : _src(ioContext)
+        , _dst(ioContext)
+    {}
+
+    ~RelayFlow() {
+        closePipe();
+    }
+
+    RelayFlow(RelayFlow const&) = delete;
+    RelayFlow& operator= (RelayFlow const&) = delete;
+
+    /**
+     * Prepare the flow. Descriptors acquired so far are closed on failure, so the flow can be opened again.
+     * @param srcHandle Descriptor to read data from.
+     * @param dstHandle Descriptor to write data into.
+     * @param dstWriteOnly True if the destination descriptor is only used for writing by its channel,
+     * so it can be released once the source reaches end of stream.
+     * @param capacity Requested capacity of the pipe.
+     * @return 0 on success, error code otherwise.
+     */
+    int open(int srcHandle, int dstHandle, bool dstWriteOnly, size_type capacity) {
+        if (::pipe2(_pipe, O_NONBLOCK | O_CLOEXEC) != 0) {
+            auto const error = errno;
+            _pipe[0] = _pipe[1] = -1;
+            return error;
+        }
+
+        // Kernel may round pipe size up, or refuse sizes above the system limit
+        auto const pipeSize = ::fcntl(_pipe[1], F_SETPIPE_SZ, static_cast<int>(capacity));
+        auto const actualSize = (pipeSize > 0) ? pipeSize : ::fcntl(_pipe[1], F_GETPIPE_SZ);
+        _capacity = (actualSize > 0) ? std::min(capacity, static_cast<size_type>(actualSize)) : capacity;
+
+        // Duplicates are owned by the flow, while channels keep their descriptors
+        auto error = assignDuplicate(_src, srcHandle);
+        if (!error) {
+            error = assignDuplicate(_dst, dstHandle);
+        }
+
+        if (error) {
+            close();
+            return error;
+        }
+
+        _dstHandle = dstWriteOnly ? dstHandle : -1;
+
+        return 0;
+    }
+
+    /** Close descriptors of the flow, cancelling the pending wait if any. */
+    void close() noexcept {
+        asio::error_code ec;
+        _src.close(ec);
+        _dst.close(ec);
+        closePipe();
+    }
+
+    /**
+     * Stop the flow without notifying the owner, i.e. once the relay is destroyed.
+     * Pending wait completes with an error into the flow kept alive by it, the pipe is closed with the flow.
+     */
+    void detach() noexcept {
+        _onDone = nullptr;
+        _owner = nullptr;
+
+        asio::error_code ec;
+        _src.close(ec);
+        _dst.close(ec);
+    }
+
+    void start(OnDone onDone, void* owner) {
+        _onDone = onDone;
+        _owner = owner;
+        pump();
+    }
+
+    void cancel() {
+        asio::error_code ec;
+        _src.cancel(ec);
+        _dst.cancel(ec);
+    }
+
+    Solace::uint64 bytesForwarded() const noexcept {
+        return _bytesForwarded;
+    }
+
+private:
+
+    static int assignDuplicate(asio::posix::stream_descriptor& descriptor, int handle) {
+        auto const duplicate = ::fcntl(handle, F_DUPFD_CLOEXEC, 0);
+        if (duplicate < 0) {
+            return errno;
+        }
+
+        // Note: status flags are shared with the original descriptor
+        auto const flags = ::fcntl(duplicate, F_GETFL);
+        if (flags < 0 || ::fcntl(duplicate, F_SETFL, flags | O_NONBLOCK) != 0) {
+            auto const error = errno;
+            ::close(duplicate);
+            return error;
+        }
+
+        asio::error_code ec;
+        descriptor.assign(duplicate, ec);
+        if (ec) {
+            ::close(duplicate);
+            return ec.value();
+        }
+
+        return 0;
+    }
+
+    void closePipe() noexcept {
+        for (auto& fd : _pipe) {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+    /** Number of bytes in the pipe or the output buffer waiting to be written into the destination. */
+    size_type pending() const noexcept {
+        return _inPipe + (_outEnd - _outBegin);
+    }
+
+    /** Move data from the source into the pipe. @return Bytes moved, 0 at end of stream, -1 on error. */
+    ssize_t fill() {
+        auto const room = _capacity - _inPipe;
+
+        if (!_copyIn) {
+            auto const n = ::splice(_src.native_handle(), nullptr, _pipe[1], nullptr, room,
+                                    SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (n >= 0 || errno != EINVAL) {
+                return n;
+            }
+
+            _copyIn = true;
+        }
+
+        if (!_inBuffer) {
+            _inBuffer = std::make_unique<byte[]>(kCopyBufferSize);
+        }
+
+        // Source is only read once the data read before has made it into the pipe: end of stream is never
+        // reported while there is data left in the buffer.
+        if (_inBegin == _inEnd) {
+            auto const n = ::read(_src.native_handle(), _inBuffer.get(), std::min<std::size_t>(room, kCopyBufferSize));
+            if (n <= 0) {
+                return n;
+            }
+
+            _inBegin = 0;
+            _inEnd = static_cast<size_type>(n);
+        }
+
+        // Pipe may take less than asked for: the tail stays in the buffer to be written once there is room
+        auto const n = ::write(_pipe[1], _inBuffer.get() + _inBegin, _inEnd - _inBegin);
+        if (n > 0) {
+            _inBegin += static_cast<size_type>(n);
+        }
+
+        return n;
+    }
+
+    /** Move data from the pipe into the destination. @return Bytes moved, -1 on error. */
+    ssize_t drain() {
+        if (!_copyOut) {
+            auto const n = ::splice(_pipe[0], nullptr, _dst.native_handle(), nullptr, _inPipe,
+                                    SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (n >= 0) {
+                _inPipe -= static_cast<size_type>(n);
+                return n;
+            }
+
+            if (errno != EINVAL) {
+                return n;
+            }
+
+            _copyOut = true;
+            _outBuffer = std::make_unique<byte[]>(kCopyBufferSize);
+        }
+
+        if (_outBegin == _outEnd) {
+            auto const n = ::read(_pipe[0], _outBuffer.get(), std::min<std::size_t>(_inPipe, kCopyBufferSize));
+            if (n < 0) {
+                return n;
+            }
+
+            _inPipe -= static_cast<size_type>(n);
+            _outBegin = 0;
+            _outEnd = static_cast<size_type>(n);
+        }
+
+        auto const n = ::write(_dst.native_handle(), _outBuffer.get() + _outBegin, _outEnd - _outBegin);
+        if (n > 0) {
+            _outBegin += static_cast<size_type>(n);
+        }
+
+        return n;
+    }
+
+    /** Move as much data as possible without blocking, then wait for the descriptor that blocked. */
+    void pump() {
+        bool drainBlocked = false;
+
+        for (bool progress = true; progress; ) {
+            progress = false;
+
+            if (!_srcEof && _inPipe < _capacity) {
+                auto const n = fill();
+                if (n > 0) {
+                    _inPipe += static_cast<size_type>(n);
+                    progress = true;
+                } else if (n == 0) {
+                    _srcEof = true;
+                    progress = true;
+                } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    return finish(errno);
+                }
+            }
+
+            if (pending() > 0) {
+                auto const n = drain();
+                if (n > 0) {
+                    _bytesForwarded += static_cast<Solace::uint64>(n);
+                    progress = true;
+                } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    return finish(errno);
+                }
+
+                drainBlocked = (n <= 0);
+            }
+
+            if (_srcEof && pending() == 0) {
+                shutdownDestination();
+                return finish(0);
+            }
+        }
+
+        auto const waitDestination = (pending() > 0 && drainBlocked);
+        auto& descriptor = waitDestination ? _dst : _src;
+        auto const waitType = waitDestination
+                ? asio::posix::stream_descriptor::wait_write
+                : asio::posix::stream_descriptor::wait_read;
+
+        initiateOn(nullptr, _handlerMemory, [&descriptor, waitType](auto handler) {
+                descriptor.async_wait(waitType, std::move(handler));
+            },
+            [self = shared_from_this()](asio::error_code const& error) {
+            if (error) {
+                self->finish(error.value());
+            } else {
+                self->pump();
+            }
+        });
+    }
+
+    /**
+     * Propagate end of stream to the destination.
+     * Sockets are shut down for writing. Readers of other descriptors, i.e. pipes, only see end of stream
+     * once every write end is closed: that of the flow and that of the channel.
+     */
+    void shutdownDestination() noexcept {
+        if (::shutdown(_dst.native_handle(), SHUT_WR) == 0 || errno != ENOTSOCK) {
+            return;
+        }
+
+        asio::error_code ec;
+        _dst.close(ec);
+
+        if (_dstHandle >= 0) {
+            // Channel keeps a valid descriptor to close, while the one it had is released
+            auto const devNull = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+            if (devNull >= 0) {
+                ::dup3(devNull, _dstHandle, O_CLOEXEC);
+                ::close(devNull);
+            }
+
+            _dstHandle = -1;
+        }
+    }
+
+    void finish(int errorCode) {
+        if (_onDone) {
+            auto onDone = _onDone;
+            _onDone = nullptr;
+            onDone(_owner, errorCode);
+        }
+    }
+
+private:
+
+    asio::posix::stream_descriptor  _src;
+    asio::posix::stream_descriptor  _dst;
+    int                             _dstHandle{-1};     //!< Write-only descriptor of the destination channel.
+    HandlerMemoryRef                _handlerMemory;
+    int                             _pipe[2]{-1, -1};
+
+    size_type                       _capacity{0};
+    size_type                       _inPipe{0};
+    bool                            _srcEof{false};
+    Solace::uint64                  _bytesForwarded{0};
+
+    bool                            _copyIn{false};
+    std::unique_ptr<byte[]>         _inBuffer;
+    size_type                       _inBegin{0};
+    size_type                       _inEnd{0};
+
+    bool                            _copyOut{false};
+    std::unique_ptr<byte[]>         _outBuffer;
+    size_type                       _outBegin{0};
+    size_type                       _outEnd{0};
+
+    OnDone                          _onDone{nullptr};
+    void*                           _owner{nullptr};
+};
+
+
+class Relay::RelayImpl {
+public:
+
+    ~RelayImpl() {
+        // Waits still pending own their flows: these complete without calling back into the relay
+        _aToB->detach();
+        _bToA->detach();
+    }
+
+    RelayImpl(void* ioservice, Channel& a, Channel& b, size_type pipeCapacity)
+        : _a(a)
+        , _b(b)
+        , _pipeCapacity(pipeCapacity)
+        , _aToB(std::make_shared<RelayFlow>(asAsioService(ioservice)))
+        , _bToA(std::make_shared<RelayFlow>(asAsioService(ioservice)))
+    {}
+
+    Future<void> asyncRun() {
+        Promise<void> promise;
+        auto f = promise.getFuture();
+
+        if (_started) {
+            promise.setError(makeError(AsyncError::AsyncSystemError, EALREADY, "Relay::asyncRun"));
+            return f;
+        }
+
+        auto const a = _a.getNativeHandles();
+        auto const b = _b.getNativeHandles();
+
+        int error = _aToB->open(a.readHandle, b.writeHandle, b.writeHandle != b.readHandle, _pipeCapacity);
+        if (!error) {
+            error = _bToA->open(b.readHandle, a.writeHandle, a.writeHandle != a.readHandle, _pipeCapacity);
+        }
+
+        if (error) {
+            // Nothing is left open, so the relay can be run again
+            _aToB->close();
+            _bToA->close();
+            promise.setError(makeError(AsyncError::AsyncSystemError, error, "Relay::asyncRun"));
+            return f;
+        }
+
+        _started = true;
+        _flowsActive = 2;
+        _promise = std::move(promise);
+
+        _aToB->start(&RelayImpl::onFlowDone, this);
+        _bToA->start(&RelayImpl::onFlowDone, this);
+
+        return f;
+    }
+
+    void cancel() {
+        _aToB->cancel();
+        _bToA->cancel();
+    }
+
+    Counters getCounters() const noexcept {
+        return {_aToB->bytesForwarded(), _bToA->bytesForwarded()};
+    }
+
+private:
+
+    static void onFlowDone(void* self, int errorCode) {
+        auto& relay = *static_cast<RelayImpl*>(self);
+
+        if (errorCode && !relay._errorCode) {
+            // One direction failed: no point keeping the other one
+            relay._errorCode = errorCode;
+            relay.cancel();
+        }
+
+        relay._flowsActive -= 1;
+        if (relay._flowsActive != 0) {
+            return;
+        }
+
+        auto promise = std::move(relay._promise);
+        if (relay._errorCode) {
+            promise.setError(makeError(AsyncError::AsyncSystemError, relay._errorCode, "Relay"));
+        } else {
+            promise.setValue();
+        }
+    }
+
+private:
+
+    Channel&            _a;
+    Channel&            _b;
+    size_type           _pipeCapacity;
+
+    std::shared_ptr<RelayFlow>  _aToB;
+    std::shared_ptr<RelayFlow>  _bToA;
+
+    bool                _started{false};
+    int                 _flowsActive{0};
+    int                 _errorCode{0};
+    Promise<void>       _promise;
+};
+
+
+Relay::~Relay() = default;
+
+
+Relay::Relay(EventLoop& loop, Channel& a, Channel& b, size_type pipeCapacity)
+    : _pimpl(std::make_unique<RelayImpl>(loop.getIOService(), a, b, pipeCapacity))
+{}
+
+
+Future<void>
+Relay::asyncRun() {
+    return _pimpl->asyncRun();
+}
+
+
+void Relay::cancel() {
+    _pimpl->cancel();
+}
+
+
+Relay::Counters
+Relay::getCounters() const noexcept {
+    return _pimpl->getCounters();
+}
@@ -0,0 +1,75 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/sendFile.cpp
+ *******************************************************************************/
+#include "sendFile.hpp"
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+// Largest transfer a single sendfile call performs on Linux
+constexpr uint64 kMaxChunkSize = 0x7ffff000;
+
+}  // namespace
+
+
+SendFileStatus
+cadence::async::sendFileSome(int socketFd, SendFileState& state) {
+#if defined(__linux__)
+    while (state.remaining > 0) {
+        auto offset = static_cast<off_t>(state.offset);
+        auto const sent = ::sendfile(socketFd, state.fileFd, &offset, std::min(state.remaining, kMaxChunkSize));
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return SendFileStatus::WouldBlock;
+            }
+
+            state.promise.setError(makeError(AsyncError::AsyncSystemError, errno, "asyncSendFile"));
+            return SendFileStatus::Failed;
+        }
+
+        if (sent == 0) {
+            // File is shorter than requested
+            break;
+        }
+
+        state.offset += static_cast<uint64>(sent);
+        state.remaining -= static_cast<uint64>(sent);
+        state.sent += static_cast<uint64>(sent);
+
+        if (state.progress) {
+            state.progress(state.sent);
+        }
+    }
+
+    state.promise.setValue(state.sent);
+    return SendFileStatus::Done;
+#else
+    (void)socketFd;
+    state.promise.setError(makeError(AsyncError::AsyncSystemError, EOPNOTSUPP, "asyncSendFile"));
+    return SendFileStatus::Failed;
+#endif
+}
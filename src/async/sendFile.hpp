@@ -0,0 +1,102 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Sending file content to a stream socket with sendfile(2)
+ *	@file		async/sendFile.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_SENDFILE_HPP
+#define CADENCE_ASYNC_SENDFILE_HPP
+
+#include "asio_helper.hpp"
+
+#include "cadence/async/streamsocket.hpp"
+
+#include <memory>
+
+
+namespace cadence::async {
+
+/**
+ * State of a file transfer, carried from one step of the transfer to the next.
+ */
+struct SendFileState {
+    int                             fileFd;
+    Solace::uint64                  offset;
+    Solace::uint64                  remaining;
+    Solace::uint64                  sent{0};
+    StreamSocket::SendFileProgress  progress;
+    Solace::Promise<Solace::uint64> promise;
+};
+
+
+enum class SendFileStatus {
+    Done,
+    WouldBlock,
+    Failed
+};
+
+
+/**
+ * Send as much of the file as the socket accepts without blocking.
+ * The promise of the transfer is resolved unless the socket would block.
+ */
+SendFileStatus sendFileSome(int socketFd, SendFileState& state);
+
+
+/**
+ * Transfer file content into the socket, waiting for the socket to become writable between sendfile calls.
+ */
+template<typename Socket>
+void sendFileStep(Socket& socket, Strand* strand, HandlerMemoryRef const& memory,
+                  std::unique_ptr<SendFileState> state) {
+    if (sendFileSome(socket.native_handle(), *state) != SendFileStatus::WouldBlock) {
+        return;
+    }
+
+    initiateOn(strand, memory, [&socket](auto handler) {
+            socket.async_wait(Socket::wait_write, std::move(handler));
+        },
+        [&socket, strand, &memory, s = std::move(state)](asio::error_code const& error) mutable {
+        if (error) {
+            s->promise.setError(fromAsioError(error, "asyncSendFile"));
+        } else {
+            sendFileStep(socket, strand, memory, std::move(s));
+        }
+    });
+}
+
+
+/**
+ * Start an async transfer of file content into the socket.
+ * @see StreamSocket::asyncSendFile
+ */
+template<typename Socket>
+Solace::Future<Solace::uint64>
+asyncSendFile(Socket& socket, Strand* strand, HandlerMemoryRef const& memory,
+              int fileFd, Solace::uint64 offset, Solace::uint64 length,
+              StreamSocket::SendFileProgress&& progress) {
+    auto state = std::make_unique<SendFileState>(SendFileState{fileFd, offset, length, 0, std::move(progress), {}});
+    auto f = state->promise.getFuture();
+
+    // sendfile must not block the loop when the socket buffer is full
+    asio::error_code ec;
+    socket.native_non_blocking(true, ec);
+    if (ec) {
+        state->promise.setError(fromAsioError(ec, "asyncSendFile"));
+        return f;
+    }
+
+    sendFileStep(socket, strand, memory, std::move(state));
+
+    return f;
+}
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_SENDFILE_HPP
@@ -12,6 +12,7 @@
 #include "cadence/async/serial.hpp"
 
 #include "asio_helper.hpp"
+#include "deadlineCompletion.hpp"
 
 #include <asio/serial_port.hpp>
 #include <asio/read.hpp>
@@ -88,7 +89,9 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        _serial.async_read_some(asio_buffer(buffer, bytesToRead),
+        initiateOn(_strand, _handlerMemory, [this, asioBuffer = asio_buffer(buffer, bytesToRead)](auto handler) {
+                _serial.async_read_some(asioBuffer, std::move(handler));
+            },
             [pm = std::move(promise), &buffer](const asio::error_code& error, std::size_t length) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncRead"));
@@ -107,7 +110,9 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        _serial.async_write_some(asio_buffer(buffer, bytesToWrite),
+        initiateOn(_strand, _handlerMemory, [this, asioBuffer = asio_buffer(buffer, bytesToWrite)](auto handler) {
+                _serial.async_write_some(asioBuffer, std::move(handler));
+            },
             [pm = std::move(promise), &buffer](const asio::error_code& error, std::size_t length) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncWrite"));
@@ -147,6 +152,102 @@ public:
     }
 
 
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto handler) {
+                _serial.async_read_some(buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(src, bytesToWrite)](auto handler) {
+                _serial.async_write_some(buffer, std::move(handler));
+            },
+            completionHandler(completion, src, "asyncWrite"));
+    }
+
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, Deadline deadline, AsyncCompletion& completion) {
+        auto& guard = DeadlineCompletion::create(_serial.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+        initiateOn(_strand, _handlerMemory,
+            [this, buffer = asio_buffer(dest, bytesToRead), slot = guard.slot()](auto handler) {
+                _serial.async_read_some(buffer, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            completionHandler(guard, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, Deadline deadline, AsyncCompletion& completion) {
+        auto& guard = DeadlineCompletion::create(_serial.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+        initiateOn(_strand, _handlerMemory,
+            [this, buffer = asio_buffer(src, bytesToWrite), slot = guard.slot()](auto handler) {
+                _serial.async_write_some(buffer, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            completionHandler(guard, src, "asyncWrite"));
+    }
+
+    void asyncReadSome(ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, maxBytesToRead)](auto handler) {
+                _serial.async_read_some(buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncReadSome"));
+    }
+
+    Result<size_type, Error>
+    readSome(ByteWriter& dest, size_type maxBytesToRead) {
+        asio::error_code ec;
+
+        auto const len = _serial.read_some(asio_buffer(dest, maxBytesToRead), ec);
+        if (ec) {
+            return Err(fromAsioError(ec, "readSome"));
+        }
+
+        dest.advance(len);
+        return Ok(static_cast<size_type>(len));
+    }
+
+    void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffers = asio_buffers(dests)](auto handler) {
+                asio::async_read(_serial, buffers, std::move(handler));
+            },
+            buffersCompletionHandler(completion, dests, "asyncReadv"));
+    }
+
+    void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffers = asio_buffers(srcs)](auto handler) {
+                asio::async_write(_serial, buffers, std::move(handler));
+            },
+            buffersCompletionHandler(completion, srcs, "asyncWritev"));
+    }
+
+    Result<void, Error> readv(ReadBuffers dests) {
+        asio::error_code ec;
+
+        auto const len = asio::read(_serial, asio_buffers(dests), ec);
+        advanceBuffers(dests, len);
+        if (ec) {
+            return Err(fromAsioError(ec, "readv"));
+        }
+
+        return Ok();
+    }
+
+    Result<void, Error> writev(WriteBuffers srcs) {
+        asio::error_code ec;
+
+        auto const len = asio::write(_serial, asio_buffers(srcs), ec);
+        advanceBuffers(srcs, len);
+        if (ec) {
+            return Err(fromAsioError(ec, "writev"));
+        }
+
+        return Ok();
+    }
+
+    void bindTo(Strand& strand) {
+        _strand = &strand;
+    }
+
     void cancel() {
         _serial.cancel();
     }
@@ -163,8 +264,18 @@ public:
         return !isOpen();
     }
 
+    int nativeHandle() {
+        return _serial.native_handle();
+    }
+
+    CompletionMemory* getCompletionMemory() noexcept {
+        return _handlerMemory.get();
+    }
+
 private:
     asio::serial_port _serial;
+    Strand* _strand{nullptr};
+    HandlerMemoryRef _handlerMemory;
 };
 
 
@@ -224,6 +335,51 @@ Result<void, Error> SerialChannel::write(ByteReader& src, size_type bytesToWrite
     return _pimpl->write(src, bytesToWrite);
 }
 
+void SerialChannel::asyncRead(ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) {
+    _pimpl->asyncRead(dest, bytesToRead, completion);
+}
+
+void SerialChannel::asyncWrite(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) {
+    _pimpl->asyncWrite(src, bytesToWrite, completion);
+}
+
+void SerialChannel::asyncRead(ByteWriter& dest, size_type bytesToRead, Deadline deadline, AsyncCompletion& completion) {
+    _pimpl->asyncRead(dest, bytesToRead, deadline, completion);
+}
+
+void SerialChannel::asyncWrite(ByteReader& src, size_type bytesToWrite,
+                               Deadline deadline, AsyncCompletion& completion) {
+    _pimpl->asyncWrite(src, bytesToWrite, deadline, completion);
+}
+
+void SerialChannel::asyncReadSome(ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) {
+    _pimpl->asyncReadSome(dest, maxBytesToRead, completion);
+}
+
+Result<SerialChannel::size_type, Error> SerialChannel::readSome(ByteWriter& dest, size_type maxBytesToRead) {
+    return _pimpl->readSome(dest, maxBytesToRead);
+}
+
+void SerialChannel::asyncReadv(ReadBuffers dests, AsyncCompletion& completion) {
+    _pimpl->asyncReadv(dests, completion);
+}
+
+void SerialChannel::asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) {
+    _pimpl->asyncWritev(srcs, completion);
+}
+
+Result<void, Error> SerialChannel::readv(ReadBuffers dests) {
+    return _pimpl->readv(dests);
+}
+
+Result<void, Error> SerialChannel::writev(WriteBuffers srcs) {
+    return _pimpl->writev(srcs);
+}
+
+void SerialChannel::bindTo(Strand& strand) {
+    _pimpl->bindTo(strand);
+}
+
 void SerialChannel::cancel() {
     _pimpl->cancel();
 }
@@ -239,3 +395,12 @@ bool SerialChannel::isOpen() const {
 bool SerialChannel::isClosed() const {
     return _pimpl->isClosed();
 }
+
+Channel::NativeHandles SerialChannel::getNativeHandles() {
+    auto const handle = _pimpl->nativeHandle();
+    return {handle, handle};
+}
+
+CompletionMemory* SerialChannel::getCompletionMemory() noexcept {
+    return _pimpl ? _pimpl->getCompletionMemory() : nullptr;
+}
@@ -35,17 +35,24 @@ public:
         Promise<int> promise;
         auto f = promise.getFuture();
 
-        _signals.async_wait([pm = std::move(promise)] (const asio::error_code& error, int signalNumber) mutable {
+        _signals.async_wait(
+            trackHandler([pm = std::move(promise)] (const asio::error_code& error, int signalNumber) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncWait"));
             } else {
                 pm.setValue(signalNumber);
             }
-        });
+        }));
 
         return f;
     }
 
+    void asyncWait(AsyncCompletion& completion) {
+        _signals.async_wait(trackHandler([c = &completion] (const asio::error_code& error, int signalNumber) {
+            c->complete(error.value(), static_cast<std::size_t>(signalNumber), "asyncWait");
+        }));
+    }
+
 
 private:
     asio::signal_set _signals;
@@ -77,3 +84,8 @@ SignalSet& SignalSet::swap(SignalSet& rhs) noexcept {
 Future<int> SignalSet::asyncWait() {
     return _pimpl->asyncWait();
 }
+
+
+void SignalSet::asyncWait(AsyncCompletion& completion) {
+    _pimpl->asyncWait(completion);
+}
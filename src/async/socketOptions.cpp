@@ -0,0 +1,103 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/socketOptions.cpp
+ *******************************************************************************/
+#include "socketOptions_impl.hpp"
+#include "asynErrorDomain.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <cerrno>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+struct NativeOption {
+    int level;
+    int name;
+};
+
+
+/**
+ * Map an option onto its native level and name.
+ * @return False if the option is not available on this platform.
+ */
+bool toNativeOption(SocketOptionName option, NativeOption& native) noexcept {
+    switch (option) {
+    case SocketOptionName::NoDelay:         native = {IPPROTO_TCP, TCP_NODELAY}; return true;
+    case SocketOptionName::SendBufferSize:  native = {SOL_SOCKET, SO_SNDBUF}; return true;
+    case SocketOptionName::ReceiveBufferSize: native = {SOL_SOCKET, SO_RCVBUF}; return true;
+    case SocketOptionName::KeepAlive:       native = {SOL_SOCKET, SO_KEEPALIVE}; return true;
+
+#ifdef TCP_QUICKACK
+    case SocketOptionName::QuickAck:        native = {IPPROTO_TCP, TCP_QUICKACK}; return true;
+#endif
+#ifdef TCP_CORK
+    case SocketOptionName::Cork:            native = {IPPROTO_TCP, TCP_CORK}; return true;
+#endif
+#ifdef SO_BUSY_POLL
+    case SocketOptionName::BusyPoll:        native = {SOL_SOCKET, SO_BUSY_POLL}; return true;
+#endif
+#ifdef SO_PRIORITY
+    case SocketOptionName::Priority:        native = {SOL_SOCKET, SO_PRIORITY}; return true;
+#endif
+#ifdef TCP_NOTSENT_LOWAT
+    case SocketOptionName::NotSentLowWatermark: native = {IPPROTO_TCP, TCP_NOTSENT_LOWAT}; return true;
+#endif
+#ifdef SO_REUSEPORT
+    case SocketOptionName::ReusePort:       native = {SOL_SOCKET, SO_REUSEPORT}; return true;
+#endif
+
+    default:
+        return false;
+    }
+}
+
+}  // namespace
+
+
+Result<void, Error>
+cadence::async::setSocketOption(int nativeHandle, SocketOptionName option, int32 value) {
+    NativeOption native;
+    if (!toNativeOption(option, native)) {
+        return Err(makeError(AsyncError::AsyncSystemError, ENOPROTOOPT, "setSocketOption"));
+    }
+
+    int const optionValue = value;
+    if (::setsockopt(nativeHandle, native.level, native.name, &optionValue, sizeof(optionValue)) != 0) {
+        return Err(makeError(AsyncError::AsyncSystemError, errno, "setSocketOption"));
+    }
+
+    return Ok();
+}
+
+
+Result<int32, Error>
+cadence::async::getSocketOption(int nativeHandle, SocketOptionName option) {
+    NativeOption native;
+    if (!toNativeOption(option, native)) {
+        return Err(makeError(AsyncError::AsyncSystemError, ENOPROTOOPT, "getSocketOption"));
+    }
+
+    int optionValue = 0;
+    socklen_t optionLength = sizeof(optionValue);
+    if (::getsockopt(nativeHandle, native.level, native.name, &optionValue, &optionLength) != 0) {
+        return Err(makeError(AsyncError::AsyncSystemError, errno, "getSocketOption"));
+    }
+
+    return Ok(static_cast<int32>(optionValue));
+}
@@ -0,0 +1,36 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Socket options of native sockets
+ *	@file		async/socketOptions_impl.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_SOCKETOPTIONS_IMPL_HPP
+#define CADENCE_ASYNC_SOCKETOPTIONS_IMPL_HPP
+
+#include "cadence/async/socketOptions.hpp"
+
+
+namespace cadence::async {
+
+/**
+ * Set value of a socket option of a native socket.
+ * Options not supported by the socket protocol or by the platform fail with ENOPROTOOPT or EOPNOTSUPP.
+ */
+Solace::Result<void, Solace::Error>
+setSocketOption(int nativeHandle, SocketOptionName option, Solace::int32 value);
+
+/**
+ * Get value of a socket option of a native socket.
+ */
+Solace::Result<Solace::int32, Solace::Error>
+getSocketOption(int nativeHandle, SocketOptionName option);
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_SOCKETOPTIONS_IMPL_HPP
@@ -0,0 +1,108 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/strand.cpp
+ *******************************************************************************/
+#include "cadence/async/strand.hpp"
+
+#include "asio_helper.hpp"
+
+#include <asio/dispatch.hpp>
+#include <asio/post.hpp>
+
+
+using namespace cadence::async;
+
+
+namespace {
+
+struct TaskHandler {
+    Task task;
+
+    void operator() () {
+        LoopInstrumentation::invoke(task);
+    }
+};
+
+}  // namespace
+
+
+class Strand::StrandImpl {
+public:
+
+    StrandImpl(asio::io_context& ioservice) :
+        _strand(ioservice.get_executor())
+    {}
+
+    void post(Task&& task) {
+        asio::post(_strand, TaskHandler{std::move(task)});
+    }
+
+    void dispatch(Task&& task) {
+        asio::dispatch(_strand, TaskHandler{std::move(task)});
+    }
+
+    bool isRunningInThisThread() const noexcept {
+        return _strand.running_in_this_thread();
+    }
+
+    StrandExecutor& getExecutor() noexcept {
+        return _strand;
+    }
+
+private:
+    StrandExecutor _strand;
+};
+
+
+Strand::~Strand() = default;
+
+
+Strand::Strand(EventLoop& ioContext) :
+    _ioContext(&ioContext),
+    _pimpl(std::make_unique<StrandImpl>(asAsioService(ioContext.getIOService())))
+{
+}
+
+
+Strand::Strand(Strand&& rhs) noexcept :
+    _ioContext(rhs._ioContext),
+    _pimpl(std::move(rhs._pimpl))
+{
+}
+
+
+Strand&
+Strand::swap(Strand& rhs) noexcept {
+    using std::swap;
+    swap(_ioContext, rhs._ioContext);
+    swap(_pimpl, rhs._pimpl);
+
+    return *this;
+}
+
+
+void Strand::post(Task&& task) {
+    _pimpl->post(std::move(task));
+}
+
+
+void Strand::dispatch(Task&& task) {
+    _pimpl->dispatch(std::move(task));
+}
+
+
+bool Strand::isRunningInThisThread() const noexcept {
+    return _pimpl->isRunningInThisThread();
+}
+
+
+void* Strand::getExecutor() noexcept {
+    return &(_pimpl->getExecutor());
+}
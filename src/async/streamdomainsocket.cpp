@@ -10,14 +10,23 @@
  * @file: async/StreamDomainSocket.cpp
  *******************************************************************************/
 #include "cadence/async/streamsocket.hpp"
+#include "cadence/async/eventLoopGroup.hpp"
 
 #include "streamsocket_impl.hpp"
 #include "asio_helper.hpp"
 #include "asio_helper_local.hpp"
+#include "deadlineCompletion.hpp"
+#include "promiseCompletion.hpp"
+#include "sendFile.hpp"
+#include "socketOptions_impl.hpp"
+#include "writeQueue.hpp"
 
 #include <asio/write.hpp>
 #include <asio/read.hpp>
 
+#include <cerrno>
+#include <memory>
+
 
 using namespace Solace;
 using namespace cadence;
@@ -65,9 +74,22 @@ class StreamDomainSocketImpl :
 public:
 
     using size_type = StreamSocket::size_type;
+    using ReadBuffers = StreamSocket::ReadBuffers;
+    using WriteBuffers = StreamSocket::WriteBuffers;
+    using SendFileProgress = StreamSocket::SendFileProgress;
+    using ZeroCopyStats = StreamSocket::ZeroCopyStats;
     using Socket_type = asio::local::stream_protocol::socket;
 
 
+    ~StreamDomainSocketImpl() override {
+        // Flush handlers outlive the socket: once writes are failed they leave it alone
+        if (_writeQueue) {
+            asio::error_code ec;
+            _socket.close(ec);
+            _writeQueue->fail(ECANCELED);
+        }
+    }
+
     StreamDomainSocketImpl(asio::io_context& ioservice)
         : _socket(ioservice)
     {}
@@ -78,6 +100,9 @@ public:
 
     StreamDomainSocketImpl(StreamDomainSocketImpl&& other)
         : _socket(std::move(other._socket))
+        , _strand(other._strand)
+        , _handlerMemory(std::move(other._handlerMemory))
+        , _writeQueue(std::move(other._writeQueue))
     {}
 
 
@@ -86,7 +111,9 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        asio::async_read(_socket, asio_buffer(dest, bytesToRead),
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto handler) {
+                asio::async_read(_socket, buffer, std::move(handler));
+            },
             [pm = std::move(promise), &dest] (asio::error_code const& error, std::size_t bytes_transferred) mutable {
                 dest.advance(bytes_transferred);
                 if (error) {
@@ -105,15 +132,7 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        asio::async_write(_socket, asio_buffer(src, bytesToWrite),
-            [pm = std::move(promise), &src] (asio::error_code const& error, std::size_t bytes_transferred) mutable {
-                src.advance(bytes_transferred);
-                if (error) {
-                    pm.setError(fromAsioError(error, "asyncWrite"));
-                } else {
-                    pm.setValue();
-                }
-            });
+        asyncWrite(src, bytesToWrite, PromiseCompletion<void>::create(std::move(promise)));
 
         return f;
     }
@@ -147,12 +166,115 @@ public:
     }
 
 
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) override {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto handler) {
+                asio::async_read(_socket, buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) override {
+        if (_writeQueue->push(src, bytesToWrite, completion)) {
+            flushWrites();
+        }
+    }
+
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, Deadline deadline, AsyncCompletion& completion) override {
+        auto& guard = DeadlineCompletion::create(_socket.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+        initiateOn(_strand, _handlerMemory,
+            [this, buffer = asio_buffer(dest, bytesToRead), slot = guard.slot()](auto handler) {
+                asio::async_read(_socket, buffer, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            completionHandler(guard, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, Deadline deadline,
+                    AsyncCompletion& completion) override {
+        auto& guard = DeadlineCompletion::create(_socket.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+
+        // Queued writes are not asio operations: expiry is handled by the queue, which outlives the socket
+        guard.slot().assign([queue = _writeQueue, g = &guard](asio::cancellation_type_t) {
+            queue->expire(*g);
+        });
+
+        asyncWrite(src, bytesToWrite, guard);
+    }
+
+    void asyncReadSome(ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) override {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, maxBytesToRead)](auto handler) {
+                _socket.async_read_some(buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncReadSome"));
+    }
+
+    Result<size_type, Error>
+    readSome(ByteWriter& dest, size_type maxBytesToRead) override {
+        asio::error_code ec;
+
+        auto const len = _socket.read_some(asio_buffer(dest, maxBytesToRead), ec);
+        if (ec) {
+            return Err(fromAsioError(ec, "readSome"));
+        }
+
+        dest.advance(len);
+        return Ok(static_cast<size_type>(len));
+    }
+
+    void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) override {
+        initiateOn(_strand, _handlerMemory, [this, buffers = asio_buffers(dests)](auto handler) {
+                asio::async_read(_socket, buffers, std::move(handler));
+            },
+            buffersCompletionHandler(completion, dests, "asyncReadv"));
+    }
+
+    void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) override {
+        if (_writeQueue->push(srcs, completion)) {
+            flushWrites();
+        }
+    }
+
+    Result<void, Error>
+    readv(ReadBuffers dests) override {
+        asio::error_code ec;
+
+        auto const len = asio::read(_socket, asio_buffers(dests), ec);
+        advanceBuffers(dests, len);
+        if (ec) {
+            return Err(fromAsioError(ec, "readv"));
+        }
+
+        return Ok();
+    }
+
+    Result<void, Error>
+    writev(WriteBuffers srcs) override {
+        asio::error_code ec;
+
+        auto const len = asio::write(_socket, asio_buffers(srcs), ec);
+        advanceBuffers(srcs, len);
+        if (ec) {
+            return Err(fromAsioError(ec, "writev"));
+        }
+
+        return Ok();
+    }
+
+    void bindTo(Strand& strand) override {
+        _strand = &strand;
+    }
+
     void cancel() override {
         _socket.cancel();
     }
 
     void close() override {
         _socket.close();
+
+        // Writers may destroy the socket from their completion: nothing is touched afterwards
+        auto queue = _writeQueue;
+        queue->fail(ECANCELED);
     }
 
     bool isOpen() const override {
@@ -163,6 +285,14 @@ public:
         return !_socket.is_open();
     }
 
+    int nativeHandle() override {
+        return _socket.native_handle();
+    }
+
+    CompletionMemory* getCompletionMemory() noexcept override {
+        return _handlerMemory.get();
+    }
+
     NetworkEndpoint getLocalEndpoint() const override {
         return fromAsioEndpoint(_socket.local_endpoint());
     }
@@ -171,6 +301,35 @@ public:
         return fromAsioEndpoint(_socket.remote_endpoint());
     }
 
+    Result<void, Error>
+    setOption(SocketOptionName option, int32 value) override {
+        return setSocketOption(_socket.native_handle(), option, value);
+    }
+
+    Result<int32, Error>
+    getOption(SocketOptionName option) override {
+        return getSocketOption(_socket.native_handle(), option);
+    }
+
+    Result<void, Error>
+    setZeroCopyThreshold(size_type threshold) override {
+        if (threshold != 0) {
+            return Err(makeError(AsyncError::AsyncSystemError, EOPNOTSUPP, "setZeroCopyThreshold"));
+        }
+
+        return Ok();
+    }
+
+    ZeroCopyStats getZeroCopyStats() const override {
+        return {};
+    }
+
+    Future<uint64>
+    asyncSendFile(ISelectable::poll_id fileFd, uint64 offset, uint64 length, SendFileProgress&& progress) override {
+        return cadence::async::asyncSendFile(_socket, _strand, _handlerMemory, fileFd, offset, length,
+                                             std::move(progress));
+    }
+
     void shutdown() override {
         _socket.shutdown(asio::local::stream_protocol::socket::shutdown_both);
     }
@@ -187,7 +346,10 @@ public:
             return f;
         }
 
-        _socket.async_connect(asioEndpoint, [pm = std::move(promise)] (asio::error_code const& error) mutable {
+        initiateOn(_strand, _handlerMemory, [this, &asioEndpoint](auto handler) {
+                _socket.async_connect(asioEndpoint, std::move(handler));
+            },
+            [pm = std::move(promise)] (asio::error_code const& error) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncConnect"));
             } else {
@@ -198,6 +360,30 @@ public:
         return f;
     }
 
+    Future<void>
+    asyncConnect(NetworkEndpoint const& endpoint, Deadline deadline) override {
+        Promise<void> promise;
+        auto f = promise.getFuture();
+
+        asio::error_code ec;
+        auto const asioEndpoint = toAsioLocalEndpoint(endpoint, ec);
+        if (ec) {
+            promise.setError(fromAsioError(ec, "asyncConnect: local-endpoint"));
+            return f;
+        }
+
+        auto& guard = DeadlineCompletion::create(_socket.get_executor(), _strand, _handlerMemory,
+                                                 deadline, PromiseCompletion<void>::create(std::move(promise)));
+        initiateOn(_strand, _handlerMemory, [this, &asioEndpoint, slot = guard.slot()](auto handler) {
+                _socket.async_connect(asioEndpoint, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            [g = &guard](asio::error_code const& error) {
+            g->complete(error.value(), 0, "asyncConnect");
+        });
+
+        return f;
+    }
+
     Result<void, Error>
     connect(NetworkEndpoint const& endpoint) override {
         asio::error_code ec;
@@ -218,9 +404,29 @@ public:
 
     auto& getSocket() noexcept { return _socket; }
 
+private:
+
+    /** Write out everything queued with a single gathered write. */
+    void flushWrites() {
+        initiateOn(_strand, _handlerMemory,
+            [this, buffers = _writeQueue->takePending(), slot = _writeQueue->flushCancelSlot()](auto handler) {
+                asio::async_write(_socket, buffers, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            [this, queue = _writeQueue, generation = _writeQueue->generation()]
+            (asio::error_code const& error, std::size_t length) {
+            // Writes of a socket closed or destroyed meanwhile have been failed already
+            if (generation == queue->generation() && queue->complete(error.value(), length)) {
+                flushWrites();
+            }
+        });
+    }
+
 private:
 
     asio::local::stream_protocol::socket _socket;
+    Strand* _strand{nullptr};
+    HandlerMemoryRef _handlerMemory;
+    std::shared_ptr<WriteQueue> _writeQueue{std::make_shared<WriteQueue>()};  //!< Shared with flush handlers.
 
 };
 
@@ -232,6 +438,11 @@ cadence::async::createUnixSocket(EventLoop& loop) {
     return { loop, std::make_unique<StreamDomainSocketImpl>(asAsioService(loop.getIOService())) };
 }
 
+StreamSocket
+cadence::async::createUnixSocket(EventLoopGroup& group) {
+    return createUnixSocket(group.next());
+}
+
 StreamSocket
 createUnixSocket(EventLoop& loop, asio::local::stream_protocol::socket&& socket) {
     return { loop, std::make_unique<StreamDomainSocketImpl>(std::move(socket)) };
@@ -12,16 +12,32 @@
 #include "cadence/async/streamsocket.hpp"
 #include "streamsocket_impl.hpp"
 
+#include <sys/socket.h>
+
+#include <mutex>
+#include <utility>  // std::exchange
+
 
 using namespace Solace;
 using namespace cadence;
 using namespace cadence::async;
 
 
+/**
+ * Descriptor of a socket for its shutdown handles, reset once the socket is closed.
+ */
+struct StreamSocket::ShutdownState {
+    std::mutex  mutex;
+    int         nativeHandle{-1};
+};
+
+
 StreamSocket::StreamSocketImpl::~StreamSocketImpl() = default;
 
 
-StreamSocket::~StreamSocket() = default;
+StreamSocket::~StreamSocket() {
+    disarmShutdown();
+}
 
 
 StreamSocket::StreamSocket(EventLoop& ioContext, std::unique_ptr<StreamSocketImpl> impl) :
@@ -30,6 +46,19 @@ StreamSocket::StreamSocket(EventLoop& ioContext, std::unique_ptr<StreamSocketImp
 { }
 
 
+StreamSocket&
+StreamSocket::operator= (StreamSocket&& rhs) noexcept {
+    if (this != &rhs) {
+        disarmShutdown();
+        Channel::operator= (std::move(rhs));
+        _pimpl = std::move(rhs._pimpl);
+        _shutdown = std::move(rhs._shutdown);
+    }
+
+    return *this;
+}
+
+
 Future<void>
 StreamSocket::asyncRead(ByteWriter& dest, size_type bytesToRead) {
     return _pimpl->asyncRead(dest, bytesToRead);
@@ -51,11 +80,60 @@ StreamSocket::write(ByteReader& src, size_type bytesToWrite) {
 }
 
 
+void StreamSocket::asyncRead(ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) {
+    _pimpl->asyncRead(dest, bytesToRead, completion);
+}
+
+void StreamSocket::asyncWrite(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) {
+    _pimpl->asyncWrite(src, bytesToWrite, completion);
+}
+
+void StreamSocket::asyncRead(ByteWriter& dest, size_type bytesToRead, Deadline deadline, AsyncCompletion& completion) {
+    _pimpl->asyncRead(dest, bytesToRead, deadline, completion);
+}
+
+void StreamSocket::asyncWrite(ByteReader& src, size_type bytesToWrite, Deadline deadline,
+                              AsyncCompletion& completion) {
+    _pimpl->asyncWrite(src, bytesToWrite, deadline, completion);
+}
+
+void StreamSocket::asyncReadSome(ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) {
+    _pimpl->asyncReadSome(dest, maxBytesToRead, completion);
+}
+
+Result<StreamSocket::size_type, Error>
+StreamSocket::readSome(ByteWriter& dest, size_type maxBytesToRead) {
+    return _pimpl->readSome(dest, maxBytesToRead);
+}
+
+void StreamSocket::asyncReadv(ReadBuffers dests, AsyncCompletion& completion) {
+    _pimpl->asyncReadv(dests, completion);
+}
+
+void StreamSocket::asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) {
+    _pimpl->asyncWritev(srcs, completion);
+}
+
+Result<void, Error>
+StreamSocket::readv(ReadBuffers dests) {
+    return _pimpl->readv(dests);
+}
+
+Result<void, Error>
+StreamSocket::writev(WriteBuffers srcs) {
+    return _pimpl->writev(srcs);
+}
+
+void StreamSocket::bindTo(Strand& strand) {
+    _pimpl->bindTo(strand);
+}
+
 void StreamSocket::cancel() {
     _pimpl->cancel();
 }
 
 void StreamSocket::close() {
+    disarmShutdown();
     _pimpl->close();
 }
 
@@ -68,6 +146,15 @@ bool StreamSocket::isClosed() const{
     return _pimpl->isClosed();
 }
 
+Channel::NativeHandles StreamSocket::getNativeHandles() {
+    auto const handle = _pimpl->nativeHandle();
+    return {handle, handle};
+}
+
+CompletionMemory* StreamSocket::getCompletionMemory() noexcept {
+    return _pimpl ? _pimpl->getCompletionMemory() : nullptr;
+}
+
 NetworkEndpoint StreamSocket::getLocalEndpoint() const {
     return _pimpl->getLocalEndpoint();
 }
@@ -76,10 +163,64 @@ NetworkEndpoint StreamSocket::getRemoteEndpoint() const {
     return _pimpl->getRemoteEndpoint();
 }
 
+Result<void, Error>
+StreamSocket::setOption(SocketOptionName option, int32 value) {
+    return _pimpl->setOption(option, value);
+}
+
+Result<int32, Error>
+StreamSocket::getOption(SocketOptionName option) {
+    return _pimpl->getOption(option);
+}
+
+Result<void, Error>
+StreamSocket::setZeroCopyThreshold(size_type threshold) {
+    return _pimpl->setZeroCopyThreshold(threshold);
+}
+
+StreamSocket::ZeroCopyStats
+StreamSocket::getZeroCopyStats() const {
+    return _pimpl->getZeroCopyStats();
+}
+
+Future<uint64>
+StreamSocket::asyncSendFile(ISelectable const& source, uint64 offset, uint64 length, SendFileProgress progress) {
+    return _pimpl->asyncSendFile(source.getSelectId(), offset, length, std::move(progress));
+}
+
 void StreamSocket::shutdown() {
     _pimpl->shutdown();
 }
 
+StreamSocket::ShutdownHandle
+StreamSocket::getShutdownHandle() {
+    if (!_shutdown) {
+        _shutdown = std::make_shared<ShutdownState>();
+        _shutdown->nativeHandle = _pimpl->nativeHandle();
+    }
+
+    return ShutdownHandle{_shutdown};
+}
+
+void StreamSocket::disarmShutdown() noexcept {
+    if (auto state = std::exchange(_shutdown, nullptr)) {
+        // Waits out a shutdown in progress, so the descriptor is not closed and reused under it
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->nativeHandle = -1;
+    }
+}
+
+void StreamSocket::ShutdownHandle::shutdown() const {
+    if (!_state) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_state->mutex);
+    if (_state->nativeHandle >= 0) {
+        ::shutdown(_state->nativeHandle, SHUT_RDWR);
+    }
+}
+
 
 Future<void>
 StreamSocket::asyncConnect(NetworkEndpoint const& endpoint) {
@@ -87,6 +228,12 @@ StreamSocket::asyncConnect(NetworkEndpoint const& endpoint) {
 }
 
 
+Future<void>
+StreamSocket::asyncConnect(NetworkEndpoint const& endpoint, Deadline deadline) {
+    return _pimpl->asyncConnect(endpoint, deadline);
+}
+
+
 Result<void, Error>
 StreamSocket::connect(NetworkEndpoint const& endpoint) {
     return _pimpl->connect(endpoint);
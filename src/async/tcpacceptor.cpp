@@ -13,6 +13,15 @@
 
 #include "asio_helper.hpp"
 #include "asio_helper_tcp.hpp"
+#include "socketOptions_impl.hpp"
+#include "deadlineCompletion.hpp"
+#include "acceptPending.hpp"
+
+#include "cadence/async/eventLoopGroup.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
 
 
 using namespace Solace;
@@ -31,6 +40,8 @@ class TcpAcceptor
         : public Acceptor::AcceptorImpl {
 public:
 
+    using size_type = Acceptor::size_type;
+
     TcpAcceptor(EventLoop& loop)
         : _loop(&loop)
         , _acceptor(asAsioService(loop.getIOService()))
@@ -38,16 +49,19 @@ public:
     }
 
     Result<void, Error>
-    open(NetworkEndpoint const& endpoint) override {
+    open(NetworkEndpoint const& endpoint, ListenOptions const& options) override {
         asio::error_code ec;
         const bool reuseAddr = true;
-        const int backlog = 16;
+        const int backlog = (options.backlog > 0)
+                ? options.backlog
+                : asio::socket_base::max_listen_connections;
 
         auto e = toAsioIPEndpoint(endpoint, ec);
         if (ec) {
             return Err(fromAsioError(ec, "open: to ip endpoint"));
         }
 
+        _protocol = e.protocol();
         if (!_acceptor.is_open()) {
             _acceptor.open(e.protocol(), ec);
 
@@ -65,6 +79,13 @@ public:
           }
         }
 
+        if (options.reusePort) {
+            auto result = setSocketOption(_acceptor.native_handle(), SocketOptionName::ReusePort, 1);
+            if (!result) {
+                return result;
+            }
+        }
+
         _acceptor.bind(e, ec);
         if (ec) {
             return Err(fromAsioError(ec, "open:bind"));
@@ -105,22 +126,100 @@ public:
     }
 
 
-    Future<StreamSocket> asyncAccept() override {
+    Future<StreamSocket> asyncAccept(EventLoop& sessionLoop) override {
         Promise<StreamSocket> prom;
         auto futureConnection = prom.getFuture();
 
         using socket_t = asio::ip::tcp::socket;
-        _acceptor.async_accept([pm = std::move(prom), l = _loop](asio::error_code const& ec, socket_t&& peer) mutable {
+        _acceptor.async_accept(asAsioService(sessionLoop.getIOService()), allocateFrom(_handlerMemory,
+            trackHandler([pm = std::move(prom), l = &sessionLoop](asio::error_code const& ec, socket_t&& peer) mutable {
             if (ec) {
                 pm.setError(fromAsioError(ec, "asyncAccept"));
             } else {
                 pm.setValue(createTCPSocket(*l, std::move(peer)));
             }
-        });
+        })));
 
         return futureConnection;
     }
 
+    void asyncAccept(EventLoop& sessionLoop, AcceptCompletion& completion) override {
+        using socket_t = asio::ip::tcp::socket;
+        _acceptor.async_accept(asAsioService(sessionLoop.getIOService()), allocateFrom(_handlerMemory,
+            trackHandler([c = &completion, l = &sessionLoop](asio::error_code const& ec, socket_t&& peer) {
+            if (!ec) {
+                c->socket.emplace(createTCPSocket(*l, std::move(peer)));
+            }
+
+            c->complete(ec.value(), 0, "asyncAccept");
+        })));
+    }
+
+    void asyncAccept(EventLoop& sessionLoop, Deadline deadline, AcceptCompletion& completion) override {
+        using socket_t = asio::ip::tcp::socket;
+        auto& guard = DeadlineCompletion::create(_acceptor.get_executor(), nullptr, _handlerMemory,
+                                                 deadline, completion);
+        _acceptor.async_accept(asAsioService(sessionLoop.getIOService()), asio::bind_cancellation_slot(guard.slot(),
+            allocateFrom(_handlerMemory,
+            trackHandler([c = &completion, g = &guard, l = &sessionLoop](asio::error_code const& ec, socket_t&& peer) {
+            if (!ec) {
+                c->socket.emplace(createTCPSocket(*l, std::move(peer)));
+            }
+
+            g->complete(ec.value(), 0, "asyncAccept");
+        }))));
+    }
+
+    void asyncAcceptBatch(EventLoopGroup* sessionLoops, size_type maxBatchSize,
+                          AcceptBatchCompletion& completion) override {
+        // Pending connections are drained with non-blocking accepts once the acceptor is readable
+        asio::error_code ec;
+        _acceptor.native_non_blocking(true, ec);
+        if (ec) {
+            completion.complete(ec.value(), 0, "asyncAcceptBatch");
+            return;
+        }
+
+        initiateOn(nullptr, _handlerMemory, [this](auto handler) {
+                _acceptor.async_wait(asio::socket_base::wait_read, std::move(handler));
+            },
+            [this, sessionLoops, maxBatchSize, c = &completion](asio::error_code const& error) {
+            if (error) {
+                c->complete(error.value(), 0, "asyncAcceptBatch");
+                return;
+            }
+
+            std::vector<int> handles;
+            auto const errorCode = acceptPending(_acceptor.native_handle(), std::max<size_type>(maxBatchSize, 1),
+                                                 handles);
+
+            c->sockets.clear();
+            c->sockets.reserve(handles.size());
+            for (auto handle : handles) {
+                auto& loop = sessionLoops ? sessionLoops->next() : *_loop;
+                asio::ip::tcp::socket peer{asAsioService(loop.getIOService())};
+
+                asio::error_code assignError;
+                peer.assign(_protocol, handle, assignError);
+                if (assignError) {
+                    ::close(handle);
+                    continue;
+                }
+
+                c->sockets.emplace_back(createTCPSocket(loop, std::move(peer)));
+            }
+
+            if (!c->sockets.empty()) {
+                // Failure after some connections have been accepted will be reported by the next batch
+                c->complete(0, c->sockets.size(), "asyncAcceptBatch");
+            } else if (errorCode) {
+                c->complete(errorCode, 0, "asyncAcceptBatch");
+            } else {
+                // Spurious wake-up or the connection has been reset by the peer already: wait for the next one
+                asyncAcceptBatch(sessionLoops, maxBatchSize, *c);
+            }
+        });
+    }
 
 
     bool nonBlocking() override {
@@ -148,10 +247,22 @@ public:
         return fromAsioEndpoint(_acceptor.local_endpoint());
     }
 
+    Result<void, Error>
+    setOption(SocketOptionName option, int32 value) override {
+        return setSocketOption(_acceptor.native_handle(), option, value);
+    }
+
+    Result<int32, Error>
+    getOption(SocketOptionName option) override {
+        return getSocketOption(_acceptor.native_handle(), option);
+    }
+
 
 private:
     EventLoop*              _loop;
     asio::ip::tcp::acceptor _acceptor;
+    asio::ip::tcp           _protocol{asio::ip::tcp::v4()};  //!< Protocol of the endpoint the acceptor is bound to.
+    HandlerMemoryRef        _handlerMemory;
 };
 
 }  // namespace
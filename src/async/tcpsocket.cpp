@@ -10,14 +10,24 @@
  * @file: async/TcpSocket.cpp
  *******************************************************************************/
 #include "cadence/async/streamsocket.hpp"
+#include "cadence/async/eventLoopGroup.hpp"
 
 #include "streamsocket_impl.hpp"
 #include "asio_helper.hpp"
 #include "asio_helper_tcp.hpp"
+#include "deadlineCompletion.hpp"
+#include "promiseCompletion.hpp"
+#include "sendFile.hpp"
+#include "socketOptions_impl.hpp"
+#include "writeQueue.hpp"
+#include "zeroCopySender.hpp"
 
 #include <asio/read.hpp>
 #include <asio/write.hpp>
 
+#include <cerrno>
+#include <memory>
+
 
 using namespace Solace;
 using namespace cadence;
@@ -32,9 +42,22 @@ class TcpSocketImpl :
 public:
 
     using size_type = StreamSocket::size_type;
+    using ReadBuffers = StreamSocket::ReadBuffers;
+    using WriteBuffers = StreamSocket::WriteBuffers;
+    using SendFileProgress = StreamSocket::SendFileProgress;
+    using ZeroCopyStats = StreamSocket::ZeroCopyStats;
     using Socket_type = asio::ip::tcp::socket;
 
 
+    ~TcpSocketImpl() override {
+        // Flush handlers outlive the socket: once writes are failed they leave it alone
+        if (_writeQueue) {
+            asio::error_code ec;
+            _socket.close(ec);
+            _writeQueue->fail(ECANCELED);
+        }
+    }
+
     TcpSocketImpl(asio::io_context& ioservice)
         : _socket(ioservice)
     {}
@@ -45,6 +68,12 @@ public:
 
     TcpSocketImpl(TcpSocketImpl&& other) noexcept
         : _socket(std::move(other._socket))
+        , _strand(other._strand)
+        , _handlerMemory(std::move(other._handlerMemory))
+        , _writeQueue(std::move(other._writeQueue))
+        , _zeroCopy(std::move(other._zeroCopy))
+        , _zeroCopyThreshold(other._zeroCopyThreshold)
+        , _awaitingRelease(other._awaitingRelease)
     {}
 
     Future<void>
@@ -52,7 +81,9 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        asio::async_read(_socket, asio_buffer(dest, bytesToRead),
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto handler) {
+                asio::async_read(_socket, buffer, std::move(handler));
+            },
             [pm = std::move(promise), &dest](asio::error_code const& error, std::size_t length) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncRead"));
@@ -71,15 +102,7 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        asio::async_write(_socket, asio_buffer(src, bytesToWrite),
-            [pm = std::move(promise), &src](asio::error_code const& error, std::size_t length) mutable {
-            if (error) {
-                pm.setError(fromAsioError(error, "asyncWrite"));
-            } else {
-                src.advance(length);   // FIXME: Is it an error if we can't advance anymore?
-                pm.setValue();
-            }
-        });
+        asyncWrite(src, bytesToWrite, PromiseCompletion<void>::create(std::move(promise)));
 
         return f;
     }
@@ -109,12 +132,120 @@ public:
     }
 
 
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) override {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto handler) {
+                asio::async_read(_socket, buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) override {
+        if (_writeQueue->push(src, bytesToWrite, completion)) {
+            flushWrites();
+        }
+    }
+
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, Deadline deadline, AsyncCompletion& completion) override {
+        auto& guard = DeadlineCompletion::create(_socket.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+        initiateOn(_strand, _handlerMemory,
+            [this, buffer = asio_buffer(dest, bytesToRead), slot = guard.slot()](auto handler) {
+                asio::async_read(_socket, buffer, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            completionHandler(guard, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, Deadline deadline,
+                    AsyncCompletion& completion) override {
+        auto& guard = DeadlineCompletion::create(_socket.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+
+        // Queued writes are not asio operations: expiry is handled by the queue, which outlives the socket
+        guard.slot().assign([queue = _writeQueue, g = &guard](asio::cancellation_type_t) {
+            queue->expire(*g);
+        });
+
+        asyncWrite(src, bytesToWrite, guard);
+    }
+
+    void asyncReadSome(ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) override {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, maxBytesToRead)](auto handler) {
+                _socket.async_read_some(buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncReadSome"));
+    }
+
+    Result<size_type, Error>
+    readSome(ByteWriter& dest, size_type maxBytesToRead) override {
+        asio::error_code ec;
+
+        auto const len = _socket.read_some(asio_buffer(dest, maxBytesToRead), ec);
+        if (ec) {
+            return Err(fromAsioError(ec, "readSome"));
+        }
+
+        dest.advance(len);
+        return Ok(static_cast<size_type>(len));
+    }
+
+    void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) override {
+        initiateOn(_strand, _handlerMemory, [this, buffers = asio_buffers(dests)](auto handler) {
+                asio::async_read(_socket, buffers, std::move(handler));
+            },
+            buffersCompletionHandler(completion, dests, "asyncReadv"));
+    }
+
+    void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) override {
+        if (_writeQueue->push(srcs, completion)) {
+            flushWrites();
+        }
+    }
+
+    Result<void, Error>
+    readv(ReadBuffers dests) override {
+        asio::error_code ec;
+
+        auto const len = asio::read(_socket, asio_buffers(dests), ec);
+        advanceBuffers(dests, len);
+        if (ec) {
+            return Err(fromAsioError(ec, "readv"));
+        }
+
+        return Ok();
+    }
+
+    Result<void, Error>
+    writev(WriteBuffers srcs) override {
+        asio::error_code ec;
+
+        auto const len = asio::write(_socket, asio_buffers(srcs), ec);
+        advanceBuffers(srcs, len);
+        if (ec) {
+            return Err(fromAsioError(ec, "writev"));
+        }
+
+        return Ok();
+    }
+
+    void bindTo(Strand& strand) override {
+        _strand = &strand;
+    }
+
     void cancel() override {
         _socket.cancel();
     }
 
     void close() override {
         _socket.close();
+
+        // Sequence of zero-copy sends starts over with a new socket, which has to enable them again
+        _zeroCopy = ZeroCopySender{};
+        _zeroCopyThreshold = 0;
+        _awaitingRelease = false;
+
+        // Writers may destroy the socket from their completion: nothing is touched afterwards
+        auto queue = _writeQueue;
+        queue->fail(ECANCELED);
     }
 
     bool isOpen() const override {
@@ -125,6 +256,14 @@ public:
         return !_socket.is_open();
     }
 
+    int nativeHandle() override {
+        return _socket.native_handle();
+    }
+
+    CompletionMemory* getCompletionMemory() noexcept override {
+        return _handlerMemory.get();
+    }
+
     NetworkEndpoint getLocalEndpoint() const override {
         return fromAsioEndpoint(_socket.local_endpoint());
     }
@@ -133,6 +272,39 @@ public:
         return fromAsioEndpoint(_socket.remote_endpoint());
     }
 
+    Result<void, Error>
+    setOption(SocketOptionName option, int32 value) override {
+        return setSocketOption(_socket.native_handle(), option, value);
+    }
+
+    Result<int32, Error>
+    getOption(SocketOptionName option) override {
+        return getSocketOption(_socket.native_handle(), option);
+    }
+
+    Result<void, Error>
+    setZeroCopyThreshold(size_type threshold) override {
+        if (threshold != 0 && _zeroCopyThreshold == 0) {
+            auto result = ZeroCopySender::enable(_socket.native_handle());
+            if (!result) {
+                return result;
+            }
+        }
+
+        _zeroCopyThreshold = threshold;
+        return Ok();
+    }
+
+    ZeroCopyStats getZeroCopyStats() const override {
+        return {_zeroCopy.sequence(), _zeroCopy.released(), _zeroCopy.copied()};
+    }
+
+    Future<uint64>
+    asyncSendFile(ISelectable::poll_id fileFd, uint64 offset, uint64 length, SendFileProgress&& progress) override {
+        return cadence::async::asyncSendFile(_socket, _strand, _handlerMemory, fileFd, offset, length,
+                                             std::move(progress));
+    }
+
     void shutdown() override {
         _socket.shutdown(Socket_type::shutdown_both);
     }
@@ -149,7 +321,10 @@ public:
             return f;
         }
 
-        _socket.async_connect(asioEndpoint, [pm = std::move(promise)] (asio::error_code const& error) mutable {
+        initiateOn(_strand, _handlerMemory, [this, &asioEndpoint](auto handler) {
+                _socket.async_connect(asioEndpoint, std::move(handler));
+            },
+            [pm = std::move(promise)] (asio::error_code const& error) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncConnect"));
             } else {
@@ -160,6 +335,30 @@ public:
         return f;
     }
 
+    Future<void>
+    asyncConnect(NetworkEndpoint const& endpoint, Deadline deadline) override {
+        Promise<void> promise;
+        auto f = promise.getFuture();
+
+        asio::error_code ec;
+        auto const asioEndpoint = toAsioIPEndpoint(endpoint, ec);
+        if (ec) {
+            promise.setError(fromAsioError(ec, "asyncConnect: to ip endpoint"));
+            return f;
+        }
+
+        auto& guard = DeadlineCompletion::create(_socket.get_executor(), _strand, _handlerMemory,
+                                                 deadline, PromiseCompletion<void>::create(std::move(promise)));
+        initiateOn(_strand, _handlerMemory, [this, &asioEndpoint, slot = guard.slot()](auto handler) {
+                _socket.async_connect(asioEndpoint, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            [g = &guard](asio::error_code const& error) {
+            g->complete(error.value(), 0, "asyncConnect");
+        });
+
+        return f;
+    }
+
     Result<void, Error>
     connect(NetworkEndpoint const& endpoint) override {
         asio::error_code ec;
@@ -182,7 +381,121 @@ public:
 
 private:
 
-    Socket_type   _socket;
+    /** Write out everything queued with a single gathered write. */
+    void flushWrites() {
+        auto buffers = _writeQueue->takePending();
+        if (_zeroCopyThreshold != 0 && asio::buffer_size(buffers) >= _zeroCopyThreshold) {
+            _zeroCopy.start(buffers);
+            sendZeroCopy();
+            return;
+        }
+
+        initiateOn(_strand, _handlerMemory,
+            [this, buffers, slot = _writeQueue->flushCancelSlot()](auto handler) {
+                asio::async_write(_socket, buffers, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            [this, queue = _writeQueue, generation = _writeQueue->generation()]
+            (asio::error_code const& error, std::size_t length) {
+            // Writes of a socket closed or destroyed meanwhile have been failed already
+            if (generation != queue->generation()) {
+                return;
+            }
+
+            if (!queue->hasParked()) {
+                if (queue->complete(error.value(), length)) {
+                    flushWrites();
+                }
+                return;
+            }
+
+            // Writers are notified in order: this flush waits for release of zero-copy sends made before it
+            bool const more = queue->park(error.value(), length, _zeroCopy.sequence());
+            awaitZeroCopyRelease();
+            if (more && generation == queue->generation()) {
+                flushWrites();
+            }
+        });
+    }
+
+    /** Hand queued data to the kernel without copying, waiting for the socket to become writable as needed. */
+    void sendZeroCopy() {
+        if (_zeroCopy.send(_socket.native_handle()) != ZeroCopySender::Status::WouldBlock) {
+            finishZeroCopy();
+            return;
+        }
+
+        initiateOn(_strand, _handlerMemory, [this, slot = _writeQueue->flushCancelSlot()](auto handler) {
+                _socket.async_wait(Socket_type::wait_write, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            [this, queue = _writeQueue, generation = _writeQueue->generation()](asio::error_code const& error) {
+            if (generation != queue->generation()) {
+                return;
+            }
+
+            if (error) {
+                _zeroCopy.fail(error.value());
+                finishZeroCopy();
+            } else {
+                sendZeroCopy();
+            }
+        });
+    }
+
+    /**
+     * Once the batch has been handed to the kernel its writers wait for release of the memory,
+     * while the next flush starts right away rather than a round trip later.
+     */
+    void finishZeroCopy() {
+        auto queue = _writeQueue;
+        auto const generation = queue->generation();
+
+        bool const more = queue->park(_zeroCopy.errorCode(), _zeroCopy.bytesSent(), _zeroCopy.sequence());
+        awaitZeroCopyRelease();
+        if (more && generation == queue->generation()) {
+            flushWrites();
+        }
+    }
+
+    /** Parked writers are only notified once the kernel no longer references their buffers. */
+    void awaitZeroCopyRelease() {
+        _zeroCopy.reapNotifications(_socket.native_handle());
+
+        auto queue = _writeQueue;
+        if (!queue->release(_zeroCopy.released())) {
+            // The socket has been closed or destroyed by a writer
+            return;
+        }
+
+        if (!queue->hasParked() || _awaitingRelease) {
+            return;
+        }
+
+        // Release notifications arrive via the socket error queue.
+        // Not cancellable by deadlines: the kernel still references the buffers until the socket is closed.
+        _awaitingRelease = true;
+        initiateOn(_strand, _handlerMemory, [this](auto handler) {
+                _socket.async_wait(Socket_type::wait_error, std::move(handler));
+            },
+            [this, queue, generation = queue->generation()](asio::error_code const&) {
+            // Once the socket is closed parked writes are notified by failing the queue
+            if (generation != queue->generation() || !_socket.is_open()) {
+                return;
+            }
+
+            _awaitingRelease = false;
+            awaitZeroCopyRelease();
+        });
+    }
+
+private:
+
+    Socket_type         _socket;
+    Strand*             _strand{nullptr};
+    HandlerMemoryRef    _handlerMemory;
+    std::shared_ptr<WriteQueue> _writeQueue{std::make_shared<WriteQueue>()};  //!< Shared with flush handlers.
+    ZeroCopySender      _zeroCopy;
+    size_type           _zeroCopyThreshold{0};
+    bool                _awaitingRelease{false};  //!< Waiting for zero-copy notifications on the error queue.
 
 };
 
@@ -192,7 +505,12 @@ private:
 StreamSocket
 cadence::async::createTCPSocket(EventLoop& loop) {
     return { loop, std::make_unique<TcpSocketImpl>(asAsioService(loop.getIOService())) };
+}
 
+
+StreamSocket
+cadence::async::createTCPSocket(EventLoopGroup& group) {
+    return createTCPSocket(group.next());
 }
 
 
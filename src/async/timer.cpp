@@ -47,17 +47,23 @@ public:
         Promise<int64> promise;
         auto f = promise.getFuture();
 
-        _timer.async_wait([pm = std::move(promise)](asio::error_code const& error) mutable {
+        _timer.async_wait(trackHandler([pm = std::move(promise)](asio::error_code const& error) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncWait"));
             } else {
                 pm.setValue(1);
             }
-        });
+        }));
 
         return f;
     }
 
+    void asyncWait(AsyncCompletion& completion) {
+        _timer.async_wait(trackHandler([c = &completion](asio::error_code const& error) {
+            c->complete(error.value(), 1, "asyncWait");
+        }));
+    }
+
 private:
 //    asio::deadline_timer _timer;
     asio::steady_timer _timer;
@@ -116,3 +122,8 @@ Timer& Timer::cancel() {
 Future<int64> Timer::asyncWait() {
     return _pimpl->asyncWait();
 }
+
+
+void Timer::asyncWait(AsyncCompletion& completion) {
+    _pimpl->asyncWait(completion);
+}
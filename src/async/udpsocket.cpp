@@ -13,6 +13,8 @@
 
 #include "asio_helper.hpp"
 #include "asio_helper_tcp.hpp"
+#include "socketOptions_impl.hpp"
+#include "deadlineCompletion.hpp"
 
 
 using namespace Solace;
@@ -42,7 +44,9 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        _socket.async_receive(asio_buffer(dest, bytesToRead),
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto handler) {
+                _socket.async_receive(buffer, std::move(handler));
+            },
             [pm = std::move(promise), &dest](const asio::error_code& error, std::size_t length) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncRead"));
@@ -76,7 +80,10 @@ public:
         ReadFromHandler handler{{}, dest, std::ref(pe)};
         auto f = handler.pm.getFuture();
 
-        _socket.async_receive_from(asio_buffer(dest, bytesToRead), pe, std::move(handler));
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto h) {
+                _socket.async_receive_from(buffer, pe, std::move(h));
+            },
+            std::move(handler));
 
         return f;
 
@@ -105,7 +112,9 @@ public:
         Promise<void> promise;
         auto f = promise.getFuture();
 
-        _socket.async_send(asio_buffer(src, bytesToWrite),
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(src, bytesToWrite)](auto handler) {
+                _socket.async_send(buffer, std::move(handler));
+            },
             [pm = std::move(promise), &src](asio::error_code const& error, std::size_t bytesTransferred) mutable {
             if (error) {
                 pm.setError(fromAsioError(error, "asyncWrite"));
@@ -134,7 +143,9 @@ public:
             }
         }
 
-        _socket.async_send_to(asio_buffer(src, bytesToWrite), destEndpoint,
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(src, bytesToWrite), &destEndpoint](auto handler) {
+                _socket.async_send_to(buffer, destEndpoint, std::move(handler));
+            },
             [pm = std::move(promise), &src](asio::error_code const& ec, std::size_t length) mutable {
             if (ec) {
                 pm.setError(fromAsioError(ec, "asyncWriteTo:async_send_to"));
@@ -170,6 +181,102 @@ public:
         return src.advance(len);
     }
 
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, bytesToRead)](auto handler) {
+                _socket.async_receive(buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(src, bytesToWrite)](auto handler) {
+                _socket.async_send(buffer, std::move(handler));
+            },
+            completionHandler(completion, src, "asyncWrite"));
+    }
+
+    void asyncRead(ByteWriter& dest, size_type bytesToRead, Deadline deadline, AsyncCompletion& completion) {
+        auto& guard = DeadlineCompletion::create(_socket.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+        initiateOn(_strand, _handlerMemory,
+            [this, buffer = asio_buffer(dest, bytesToRead), slot = guard.slot()](auto handler) {
+                _socket.async_receive(buffer, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            completionHandler(guard, dest, "asyncRead"));
+    }
+
+    void asyncWrite(ByteReader& src, size_type bytesToWrite, Deadline deadline, AsyncCompletion& completion) {
+        auto& guard = DeadlineCompletion::create(_socket.get_executor(), _strand, _handlerMemory,
+                                                 deadline, completion);
+        initiateOn(_strand, _handlerMemory,
+            [this, buffer = asio_buffer(src, bytesToWrite), slot = guard.slot()](auto handler) {
+                _socket.async_send(buffer, asio::bind_cancellation_slot(slot, std::move(handler)));
+            },
+            completionHandler(guard, src, "asyncWrite"));
+    }
+
+    void asyncReadSome(ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffer = asio_buffer(dest, maxBytesToRead)](auto handler) {
+                _socket.async_receive(buffer, std::move(handler));
+            },
+            completionHandler(completion, dest, "asyncReadSome"));
+    }
+
+    Result<size_type, Error>
+    readSome(ByteWriter& dest, size_type maxBytesToRead) {
+        asio::error_code ec;
+
+        auto const len = _socket.receive(asio_buffer(dest, maxBytesToRead), 0, ec);
+        if (ec) {
+            return Err(fromAsioError(ec, "readSome"));
+        }
+
+        dest.advance(len);
+        return Ok(static_cast<size_type>(len));
+    }
+
+    void asyncReadv(ReadBuffers dests, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffers = asio_buffers(dests)](auto handler) {
+                _socket.async_receive(buffers, std::move(handler));
+            },
+            buffersCompletionHandler(completion, dests, "asyncReadv"));
+    }
+
+    void asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) {
+        initiateOn(_strand, _handlerMemory, [this, buffers = asio_buffers(srcs)](auto handler) {
+                _socket.async_send(buffers, std::move(handler));
+            },
+            buffersCompletionHandler(completion, srcs, "asyncWritev"));
+    }
+
+    Result<void, Error> readv(ReadBuffers dests) {
+        asio::error_code ec;
+
+        auto const len = _socket.receive(asio_buffers(dests), 0, ec);
+        if (ec) {
+            return Err(fromAsioError(ec, "readv"));
+        }
+
+        advanceBuffers(dests, len);
+        return Ok();
+    }
+
+    Result<void, Error> writev(WriteBuffers srcs) {
+        asio::error_code ec;
+
+        auto const len = _socket.send(asio_buffers(srcs), 0, ec);
+        if (ec) {
+            return Err(fromAsioError(ec, "writev"));
+        }
+
+        advanceBuffers(srcs, len);
+        return Ok();
+    }
+
+    void bindTo(Strand& strand) {
+        _strand = &strand;
+    }
+
     void cancel() {
         _socket.cancel();
     }
@@ -195,6 +302,14 @@ public:
         return _socket.is_open();
     }
 
+    int nativeHandle() {
+        return _socket.native_handle();
+    }
+
+    CompletionMemory* getCompletionMemory() noexcept {
+        return _handlerMemory.get();
+    }
+
 
     Result<void, Error>
     open() {
@@ -216,13 +331,25 @@ public:
         return fromAsioEndpoint(_socket.remote_endpoint());
     }
 
+    Result<void, Error>
+    setOption(SocketOptionName option, int32 value) {
+        return setSocketOption(_socket.native_handle(), option, value);
+    }
+
+    Result<int32, Error>
+    getOption(SocketOptionName option) {
+        return getSocketOption(_socket.native_handle(), option);
+    }
+
     void shutdown() {
         _socket.shutdown(Socket_type::shutdown_both);
     }
 
 
 private:
-    Socket_type    _socket;
+    Socket_type         _socket;
+    Strand*             _strand{nullptr};
+    HandlerMemoryRef    _handlerMemory;
 };
 
 
@@ -278,6 +405,50 @@ UdpSocket::asyncWriteTo(const IPEndpoint& remote, ByteReader& src, size_type byt
     return _pimpl->asyncWriteTo(remote, src, bytesToWrite);
 }
 
+void UdpSocket::asyncRead(ByteWriter& dest, size_type bytesToRead, AsyncCompletion& completion) {
+    _pimpl->asyncRead(dest, bytesToRead, completion);
+}
+
+void UdpSocket::asyncWrite(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) {
+    _pimpl->asyncWrite(src, bytesToWrite, completion);
+}
+
+void UdpSocket::asyncRead(ByteWriter& dest, size_type bytesToRead, Deadline deadline, AsyncCompletion& completion) {
+    _pimpl->asyncRead(dest, bytesToRead, deadline, completion);
+}
+
+void UdpSocket::asyncWrite(ByteReader& src, size_type bytesToWrite, Deadline deadline, AsyncCompletion& completion) {
+    _pimpl->asyncWrite(src, bytesToWrite, deadline, completion);
+}
+
+void UdpSocket::asyncReadSome(ByteWriter& dest, size_type maxBytesToRead, AsyncCompletion& completion) {
+    _pimpl->asyncReadSome(dest, maxBytesToRead, completion);
+}
+
+Result<UdpSocket::size_type, Error> UdpSocket::readSome(ByteWriter& dest, size_type maxBytesToRead) {
+    return _pimpl->readSome(dest, maxBytesToRead);
+}
+
+void UdpSocket::asyncReadv(ReadBuffers dests, AsyncCompletion& completion) {
+    _pimpl->asyncReadv(dests, completion);
+}
+
+void UdpSocket::asyncWritev(WriteBuffers srcs, AsyncCompletion& completion) {
+    _pimpl->asyncWritev(srcs, completion);
+}
+
+Result<void, Error> UdpSocket::readv(ReadBuffers dests) {
+    return _pimpl->readv(dests);
+}
+
+Result<void, Error> UdpSocket::writev(WriteBuffers srcs) {
+    return _pimpl->writev(srcs);
+}
+
+void UdpSocket::bindTo(Strand& strand) {
+    _pimpl->bindTo(strand);
+}
+
 void UdpSocket::cancel() {
     _pimpl->cancel();
 }
@@ -307,6 +478,15 @@ bool UdpSocket::isClosed() const {
     return !_pimpl->isOpen();
 }
 
+Channel::NativeHandles UdpSocket::getNativeHandles() {
+    auto const handle = _pimpl->nativeHandle();
+    return {handle, handle};
+}
+
+CompletionMemory* UdpSocket::getCompletionMemory() noexcept {
+    return _pimpl ? _pimpl->getCompletionMemory() : nullptr;
+}
+
 
 IPEndpoint UdpSocket::getLocalEndpoint() const {
     return _pimpl->getLocalEndpoint();
@@ -317,6 +497,18 @@ IPEndpoint UdpSocket::getRemoteEndpoint() const {
     return _pimpl->getRemoteEndpoint();
 }
 
+
+Result<void, Error>
+UdpSocket::setOption(SocketOptionName option, int32 value) {
+    return _pimpl->setOption(option, value);
+}
+
+
+Result<int32, Error>
+UdpSocket::getOption(SocketOptionName option) {
+    return _pimpl->getOption(option);
+}
+
 void UdpSocket::shutdown() {
     _pimpl->shutdown();
 }
@@ -0,0 +1,208 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/writeQueue.cpp
+ *******************************************************************************/
+#include "writeQueue.hpp"
+
+#include <algorithm>
+#include <cerrno>
+
+
+using namespace Solace;
+using namespace cadence::async;
+
+
+namespace {
+
+/**
+ * Call the given function for each source buffer of an entry with the number of bytes the entry writes from it.
+ */
+template<typename Entry, typename F>
+void forEachSource(Entry const& entry, F&& f) {
+    if (entry.src) {
+        f(*entry.src, entry.bytes);
+        return;
+    }
+
+    auto bytesLeft = entry.bytes;
+    for (auto& src : entry.srcs) {
+        auto const n = std::min(bytesLeft, src.remaining());
+        f(src, n);
+        bytesLeft -= n;
+    }
+}
+
+
+/**
+ * Advance sources of flushed entries by the number of bytes written and call the given function with outcome of each.
+ */
+template<typename Entry, typename F>
+void settle(std::vector<Entry> const& entries, int errorCode, std::size_t length, F&& f) {
+    for (auto const& entry : entries) {
+        auto const written = std::min<std::size_t>(length, entry.bytes);
+        auto advanceBy = written;
+        forEachSource(entry, [&advanceBy](ByteReader& src, ByteReader::size_type bytes) {
+            auto const n = std::min<std::size_t>(advanceBy, bytes);
+            src.advance(n);
+            advanceBy -= n;
+        });
+        length -= written;
+
+        // Writes fully flushed before an error are reported as successful
+        auto const entryError = (written == entry.bytes) ? 0 : (errorCode ? errorCode : EIO);
+        f(entry, entryError, written);
+    }
+}
+
+}  // namespace
+
+
+bool WriteQueue::push(ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion) {
+    return enqueue({&src, {}, bytesToWrite, &completion, "asyncWrite"});
+}
+
+
+bool WriteQueue::push(ArrayView<ByteReader> srcs, AsyncCompletion& completion) {
+    size_type bytes = 0;
+    for (auto const& src : srcs) {
+        bytes += src.remaining();
+    }
+
+    return enqueue({nullptr, srcs, bytes, &completion, "asyncWritev"});
+}
+
+
+bool WriteQueue::enqueue(Entry const& entry) {
+    _pending.push_back(entry);
+
+    if (_flushing) {
+        return false;
+    }
+
+    _flushing = true;
+    return true;
+}
+
+
+void WriteQueue::expire(AsyncCompletion& completion) {
+    auto const isWrite = [&completion](Entry const& entry) {
+        return entry.completion == &completion;
+    };
+
+    auto it = std::find_if(_pending.begin(), _pending.end(), isWrite);
+    if (it != _pending.end()) {
+        auto const tag = it->tag;
+        _pending.erase(it);
+        completion.complete(ETIMEDOUT, 0, tag);
+        return;
+    }
+
+    if (std::any_of(_inflight.begin(), _inflight.end(), isWrite)) {
+        abortFlush();
+    }
+}
+
+
+ConstBufferRange WriteQueue::takePending() {
+    _inflight.clear();
+    _inflight.swap(_pending);
+
+    _buffers.clear();
+    for (auto const& entry : _inflight) {
+        forEachSource(entry, [this](ByteReader& src, size_type bytes) {
+            if (bytes != 0) {
+                auto data = src.viewRemaining().slice(0, bytes);
+                _buffers.emplace_back(data.dataAddress(), data.size());
+            }
+        });
+    }
+
+    return {_buffers.data(), _buffers.data() + _buffers.size()};
+}
+
+
+bool WriteQueue::complete(int errorCode, std::size_t length) {
+    // Writers may post new writes from their completion: these go to `_pending` as `_flushing` is still set.
+    // They may also close the channel, failing writes: flushed ones are taken out first not to be notified twice.
+    std::vector<Entry> inflight;
+    inflight.swap(_inflight);
+    auto const generation = _generation;
+
+    settle(inflight, errorCode, length, [](Entry const& entry, int entryError, std::size_t written) {
+        entry.completion->complete(entryError, written, entry.tag);
+    });
+
+    if (generation != _generation) {
+        // Writes have been failed meanwhile: the channel may be gone, there is nothing to flush
+        return false;
+    }
+
+    // Keep the storage for the next flush
+    inflight.clear();
+    _inflight.swap(inflight);
+    _flushing = !_pending.empty();
+
+    return _flushing;
+}
+
+
+bool WriteQueue::park(int errorCode, std::size_t length, std::uint64_t releaseMark) {
+    settle(_inflight, errorCode, length, [this, releaseMark](Entry const& entry, int entryError, std::size_t written) {
+        _parked.push_back({entry.completion, entry.tag, entryError, written, releaseMark});
+    });
+
+    _inflight.clear();
+    _flushing = !_pending.empty();
+
+    return _flushing;
+}
+
+
+bool WriteQueue::release(std::uint64_t releasedMark) {
+    auto const generation = _generation;
+
+    while (!_parked.empty() && _parked.front().releaseMark <= releasedMark) {
+        auto const parked = _parked.front();
+        _parked.pop_front();
+
+        parked.completion->complete(parked.errorCode, parked.written, parked.tag);
+        if (generation != _generation) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+void WriteQueue::fail(int errorCode) {
+    std::deque<Parked> parked;
+    std::vector<Entry> inflight;
+    std::vector<Entry> pending;
+    parked.swap(_parked);
+    inflight.swap(_inflight);
+    pending.swap(_pending);
+    _flushing = false;
+    _generation += 1;
+
+    // Memory of parked writes is released with the socket: these have their outcome already
+    for (auto const& entry : parked) {
+        entry.completion->complete(entry.errorCode, entry.written, entry.tag);
+    }
+
+    // Writers may post new writes from their completion: these start a new generation of flushes
+    for (auto const& entry : inflight) {
+        entry.completion->complete(errorCode, 0, entry.tag);
+    }
+
+    for (auto const& entry : pending) {
+        entry.completion->complete(errorCode, 0, entry.tag);
+    }
+}
@@ -0,0 +1,223 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Outbound queue coalescing concurrent writes
+ *	@file		async/writeQueue.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_WRITEQUEUE_HPP
+#define CADENCE_ASYNC_WRITEQUEUE_HPP
+
+#include "cadence/async/completion.hpp"
+
+#include <solace/arrayView.hpp>
+#include <solace/byteReader.hpp>
+
+#include <asio/buffer.hpp>
+#include <asio/cancellation_signal.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+
+namespace cadence::async {
+
+/**
+ * Range of asio buffers suitable for use as a ConstBufferSequence.
+ * Refers to buffers owned by the WriteQueue, thus valid until the flush it was taken for completes.
+ */
+class ConstBufferRange {
+public:
+    using value_type = asio::const_buffer;
+    using const_iterator = asio::const_buffer const*;
+
+    ConstBufferRange(const_iterator begin, const_iterator end) noexcept
+        : _begin(begin)
+        , _end(end)
+    {}
+
+    const_iterator begin() const noexcept { return _begin; }
+    const_iterator end() const noexcept { return _end; }
+
+private:
+    const_iterator _begin;
+    const_iterator _end;
+};
+
+
+/**
+ * Outbound queue of a stream channel.
+ *
+ * Composed async writes must not interleave, so writes posted while a flush is in flight are queued.
+ * A gather write is queued as a single entry: its buffers are written out back to back.
+ * Once the flush completes, everything queued is written out by a single gathered write
+ * and each writer is notified via its own completion record in the order writes were posted.
+ *
+ * Typical usage by a channel:
+ * @code
+ *  if (_writeQueue.push(src, bytes, completion)) {
+ *      flush();  // async_write(_writeQueue.takePending()), then _writeQueue.complete(...)
+ *  }
+ * @endcode
+ *
+ * Storage is reused between flushes, so a busy channel does not allocate once queues have grown.
+ *
+ * A zero-copy flush hands buffers to the kernel which keeps referencing them after the send: its writes are parked
+ * until the kernel releases the memory, while the next flush may already start.
+ *
+ * The queue is shared by the channel and handlers of its flush operations, so it outlives a channel
+ * destroyed with a flush in progress. Such channel fails its writes: the flush then finds the queue
+ * has moved on to the next generation and leaves the channel alone.
+ */
+class WriteQueue {
+public:
+    using size_type = Solace::ByteReader::size_type;
+
+public:
+
+    WriteQueue() = default;
+
+    WriteQueue(WriteQueue const&) = delete;
+    WriteQueue& operator= (WriteQueue const&) = delete;
+
+    /**
+     * Queue a write.
+     * @param src Source of data to write. Advanced by the number of bytes written once the write completes.
+     * @param bytesToWrite Number of bytes to write from the source.
+     * @param completion Completion record to notify once the write completes.
+     * @return True if the caller must start a flush, false if the write will be picked up by a flush in progress.
+     */
+    bool push(Solace::ByteReader& src, size_type bytesToWrite, AsyncCompletion& completion);
+
+    /**
+     * Queue a gather write of remaining data of all of the given buffers.
+     * @param srcs Buffers to write data from, in order.
+     * Advanced by the number of bytes written once the write completes.
+     * @param completion Completion record to notify once the write completes.
+     * @return True if the caller must start a flush, false if the write will be picked up by a flush in progress.
+     */
+    bool push(Solace::ArrayView<Solace::ByteReader> srcs, AsyncCompletion& completion);
+
+    /**
+     * Expire a write once its deadline has passed.
+     * A write that has not been taken for a flush yet is removed and notified with ETIMEDOUT,
+     * while a write being flushed aborts the flush. Parked and unknown writes are left alone.
+     * Called from deadline handlers holding the queue, so it never reaches into a channel that may be gone.
+     * @param completion Completion record of the write to expire.
+     */
+    void expire(AsyncCompletion& completion);
+
+    /**
+     * Take all queued writes to be flushed.
+     * @return Range of buffers to write out, valid until `complete()` is called.
+     */
+    ConstBufferRange takePending();
+
+    /**
+     * Report outcome of a flush and notify each writer.
+     * Writes posted by the notified writers are queued for the next flush.
+     * A writer may close or destroy the channel from its completion: the queue must be kept alive by the caller.
+     *
+     * @param errorCode Error code of the flush operation, 0 on success.
+     * @param length Number of bytes written by the flush.
+     * @return True if the caller must start another flush for writes queued meanwhile.
+     * False if there is nothing left to write or writes have been failed by one of the writers.
+     */
+    bool complete(int errorCode, std::size_t length);
+
+    /**
+     * Report outcome of a flush which buffers are still referenced by the kernel, i.e. a zero-copy send.
+     * Writers are not notified until `release()` reaches the given mark, but the next flush may start right away.
+     * Flushes completed while writes are parked must be parked as well, so that writers are notified in order.
+     *
+     * @param errorCode Error code of the flush operation, 0 on success.
+     * @param length Number of bytes written by the flush.
+     * @param releaseMark Mark of release of the memory referenced by the flush.
+     * @return True if the caller must start another flush for writes queued meanwhile.
+     */
+    bool park(int errorCode, std::size_t length, std::uint64_t releaseMark);
+
+    /**
+     * Notify parked writers which memory the kernel has released.
+     * A writer may close or destroy the channel from its completion: the queue must be kept alive by the caller.
+     *
+     * @param releasedMark Mark of memory released so far. Writes parked with a mark up to it are notified.
+     * @return False if writes have been failed by one of the writers, so that the channel may be gone.
+     */
+    bool release(std::uint64_t releasedMark);
+
+    /** Test if there are writes waiting for their memory to be released. */
+    bool hasParked() const noexcept {
+        return !_parked.empty();
+    }
+
+    /**
+     * Fail all writes queued and being flushed, i.e. once the channel is closed or destroyed.
+     * Parked writes are notified of their outcome: the kernel releases their memory once the socket is closed.
+     * Outcome of the flush in progress, if any, is to be ignored. @see generation
+     * @param errorCode Error code to notify writers with.
+     */
+    void fail(int errorCode);
+
+    /**
+     * Get generation of the queue, advanced each time writes are failed.
+     * A flush started in an earlier generation is stale: its writes have been notified already.
+     */
+    std::uint64_t generation() const noexcept {
+        return _generation;
+    }
+
+    /** Get a slot to bind the flush operation to, so that it can be aborted. */
+    asio::cancellation_slot flushCancelSlot() noexcept {
+        return _flushCancel.slot();
+    }
+
+    /** Abort the flush in progress, i.e. once a write being flushed has expired. */
+    void abortFlush() {
+        _flushCancel.emit(asio::cancellation_type::terminal);
+    }
+
+    /** Test if a flush is in progress. */
+    bool isFlushing() const noexcept {
+        return _flushing;
+    }
+
+private:
+
+    struct Entry {
+        Solace::ByteReader*                     src;        //!< Source of a single buffer write, null for gather.
+        Solace::ArrayView<Solace::ByteReader>   srcs;       //!< Sources of a gather write.
+        size_type                               bytes;      //!< Total number of bytes to write.
+        AsyncCompletion*                        completion;
+        Solace::StringLiteral                   tag;
+    };
+
+    /** Write which outcome is known, waiting for the kernel to release its memory. */
+    struct Parked {
+        AsyncCompletion*                        completion;
+        Solace::StringLiteral                   tag;
+        int                                     errorCode;
+        std::size_t                             written;
+        std::uint64_t                           releaseMark;
+    };
+
+    bool enqueue(Entry const& entry);
+
+    std::vector<Entry>              _pending;
+    std::vector<Entry>              _inflight;
+    std::deque<Parked>              _parked;
+    std::vector<asio::const_buffer> _buffers;
+    bool                            _flushing{false};
+    std::uint64_t                   _generation{0};
+    asio::cancellation_signal       _flushCancel;       //!< Aborts the flush in progress once a write expires.
+};
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_WRITEQUEUE_HPP
@@ -0,0 +1,189 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * @file: async/zeroCopySender.cpp
+ *******************************************************************************/
+#include "zeroCopySender.hpp"
+#include "asynErrorDomain.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#endif
+
+#include <cerrno>
+#include <climits>  // IOV_MAX
+#include <cstring>
+
+
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) && defined(SO_EE_ORIGIN_ZEROCOPY)
+#define CADENCE_ASYNC_HAS_ZEROCOPY 1
+#endif
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+#ifndef IOV_MAX
+constexpr std::size_t kMaxIovecs = 1024;
+#else
+constexpr std::size_t kMaxIovecs = IOV_MAX;
+#endif
+
+}  // namespace
+
+
+bool ZeroCopySender::isSupported() noexcept {
+#ifdef CADENCE_ASYNC_HAS_ZEROCOPY
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+Result<void, Error>
+ZeroCopySender::enable(int nativeHandle) {
+#ifdef CADENCE_ASYNC_HAS_ZEROCOPY
+    int const one = 1;
+    if (::setsockopt(nativeHandle, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) != 0) {
+        return Err(makeError(AsyncError::AsyncSystemError, errno, "enableZeroCopy"));
+    }
+
+    return Ok();
+#else
+    (void)nativeHandle;
+    return Err(makeError(AsyncError::AsyncSystemError, EOPNOTSUPP, "enableZeroCopy"));
+#endif
+}
+
+
+void ZeroCopySender::start(ConstBufferRange buffers) {
+    _buffers = buffers;
+    _bytesSent = 0;
+    _errorCode = 0;
+}
+
+
+ZeroCopySender::Status
+ZeroCopySender::send(int nativeHandle) {
+#ifdef CADENCE_ASYNC_HAS_ZEROCOPY
+    for (;;) {
+        // Collect what is left to send, skipping data sent already
+        _iovecs.clear();
+        auto skip = _bytesSent;
+        for (auto const& buffer : _buffers) {
+            if (skip >= buffer.size()) {
+                skip -= buffer.size();
+                continue;
+            }
+
+            auto* data = const_cast<char*>(static_cast<char const*>(buffer.data()));
+            _iovecs.push_back({data + skip, buffer.size() - skip});
+            skip = 0;
+
+            if (_iovecs.size() == kMaxIovecs) {
+                break;
+            }
+        }
+
+        if (_iovecs.empty()) {
+            return Status::Sent;
+        }
+
+        msghdr message{};
+        message.msg_iov = _iovecs.data();
+        message.msg_iovlen = _iovecs.size();
+
+        auto sent = ::sendmsg(nativeHandle, &message, MSG_ZEROCOPY | MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent >= 0) {
+            // Each successful zero-copy send is acknowledged individually via the error queue
+            _sequence += 1;
+        } else if (errno == ENOBUFS) {
+            // Out of memory to pin pages: fall back to copying this chunk
+            sent = ::sendmsg(nativeHandle, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+        }
+
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return Status::WouldBlock;
+            }
+
+            if (errno == EINTR) {
+                continue;
+            }
+
+            _errorCode = errno;
+            return Status::Failed;
+        }
+
+        _bytesSent += static_cast<std::size_t>(sent);
+    }
+#else
+    (void)nativeHandle;
+    _errorCode = EOPNOTSUPP;
+    return Status::Failed;
+#endif
+}
+
+
+bool ZeroCopySender::reapNotifications(int nativeHandle) {
+#ifdef CADENCE_ASYNC_HAS_ZEROCOPY
+    while (!isReleased()) {
+        char control[128];
+        msghdr message{};
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        if (::recvmsg(nativeHandle, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            break;
+        }
+
+        for (auto* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            bool const isRecvError = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                    (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+            if (!isRecvError) {
+                continue;
+            }
+
+            sock_extended_err error;
+            std::memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+            if (error.ee_errno != 0 || error.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+
+            // Notification covers an inclusive range of send calls
+            auto const nbSends = static_cast<std::uint32_t>(error.ee_data - error.ee_info) + 1;
+            _released += nbSends;
+#ifdef SO_EE_CODE_ZEROCOPY_COPIED
+            if (error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                _copied += nbSends;
+            }
+#endif
+        }
+    }
+#else
+    (void)nativeHandle;
+#endif
+
+    return isReleased();
+}
+
+
+void ZeroCopySender::fail(int errorCode) noexcept {
+    if (_errorCode == 0) {
+        _errorCode = errorCode;
+    }
+}
@@ -0,0 +1,128 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence: Zero-copy send of a batch of buffers
+ *	@file		async/zeroCopySender.hpp
+ ******************************************************************************/
+#pragma once
+#ifndef CADENCE_ASYNC_ZEROCOPYSENDER_HPP
+#define CADENCE_ASYNC_ZEROCOPYSENDER_HPP
+
+#include "writeQueue.hpp"
+
+#include <solace/result.hpp>
+#include <solace/error.hpp>
+
+#include <sys/uio.h>  // iovec
+
+#include <cstdint>
+#include <vector>
+
+
+namespace cadence::async {
+
+/**
+ * Sends batches of buffers with MSG_ZEROCOPY and tracks when the kernel releases them.
+ *
+ * Pages of a zero-copy send stay pinned by the kernel after the send call returns,
+ * until the data has been acknowledged by the peer. The kernel reports release of the memory
+ * via the socket error queue, one notification per range of send calls, so buffers must stay
+ * untouched until every send made for them has been released or the socket is closed.
+ *
+ * Once a batch has been handed to the kernel the next one may be sent, while notifications of earlier ones
+ * are still outstanding: buffers of a batch are released once `released()` reaches `sequence()` taken after it.
+ *
+ * The sender does no IO waiting of its own: the socket owner waits for the socket to become writable
+ * when `send()` returns `WouldBlock`, and for the error queue to become readable while memory is pinned.
+ */
+class ZeroCopySender {
+public:
+
+    enum class Status {
+        Sent,           //!< All data of the batch has been handed to the kernel.
+        WouldBlock,     //!< Socket send buffer is full: wait for the socket to become writable and send again.
+        Failed          //!< Send failed. Data sent so far still has to be released.
+    };
+
+    /** Test if zero-copy sends are supported on this platform. */
+    static bool isSupported() noexcept;
+
+    /** Enable zero-copy sends on the given native socket. */
+    static Solace::Result<void, Solace::Error> enable(int nativeHandle);
+
+    /**
+     * Start sending a new batch of buffers.
+     * @param buffers Buffers to send. Must stay valid until the batch is released.
+     */
+    void start(ConstBufferRange buffers);
+
+    /**
+     * Send as much of the batch as the socket accepts without blocking.
+     * @return Status of the batch.
+     */
+    Status send(int nativeHandle);
+
+    /**
+     * Process zero-copy notifications available on the socket error queue.
+     * @return True if the kernel has released all the memory sent so far.
+     */
+    bool reapNotifications(int nativeHandle);
+
+    /** Test if the kernel has released all the memory sent so far. */
+    bool isReleased() const noexcept {
+        return _released == _sequence;
+    }
+
+    /** Get number of zero-copy send calls made. Memory of data sent so far is released once `released()` gets here. */
+    std::uint64_t sequence() const noexcept {
+        return _sequence;
+    }
+
+    /** Get number of zero-copy send calls the kernel has released memory of. */
+    std::uint64_t released() const noexcept {
+        return _released;
+    }
+
+    /** Get number of zero-copy send calls the kernel reported it had to copy data of anyway, i.e. over loopback. */
+    std::uint64_t copied() const noexcept {
+        return _copied;
+    }
+
+    /**
+     * Stop sending the current batch, i.e. once waiting for the socket to become writable has failed.
+     * Data sent so far stays pinned until released by the kernel.
+     * @param errorCode Error to report for the batch.
+     */
+    void fail(int errorCode) noexcept;
+
+    /** Error code of the batch, 0 if all of the data has been sent. */
+    int errorCode() const noexcept {
+        return _errorCode;
+    }
+
+    /** Number of bytes of the batch sent. */
+    std::size_t bytesSent() const noexcept {
+        return _bytesSent;
+    }
+
+private:
+
+    ConstBufferRange        _buffers{nullptr, nullptr};
+    std::size_t             _bytesSent{0};
+    int                     _errorCode{0};
+
+    std::uint64_t           _sequence{0};       //!< Number of zero-copy send calls made on the socket.
+    std::uint64_t           _released{0};       //!< Number of zero-copy send calls the kernel released memory of.
+    std::uint64_t           _copied{0};         //!< Number of released send calls which data the kernel copied.
+
+    std::vector<iovec>      _iovecs;
+};
+
+}  // End of namespace cadence::async
+#endif  // CADENCE_ASYNC_ZEROCOPYSENDER_HPP
@@ -8,6 +8,22 @@
 */
 
 #include "cadence/asyncServer.hpp"
+#include "cadence/async/timer.hpp"
+
+#include "async/asynErrorDomain.hpp"
+
+#include <solace/posixErrorDomain.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <vector>
 
 
 using namespace Solace;
@@ -15,34 +31,499 @@ using namespace cadence;
 using namespace cadence::async;
 
 
-void
-doAcceptSession(async::Acceptor& acceptor, AsyncServer::AcceptHandler& handler) {
-    acceptor.asyncAccept()
-            .then([&](StreamSocket&& socket) {
-                if (handler) {
-                    handler(std::move(socket));
-                }
+namespace {
+
+/// Delay before accepting again after a failure that can not be recovered from right away, i.e. out of descriptors.
+constexpr Timer::duration_type kAcceptRetryDelay{100};
+
+int openReserveHandle() noexcept {
+    return ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+}
+
+}  // namespace
+
+
+/**
+ * Entry of the registry of sessions.
+ */
+struct AsyncServer::SessionRecord {
+    SessionRecord*                  prev{nullptr};
+    SessionRecord*                  next{nullptr};
+    StreamSocket::ShutdownHandle    socket;     //!< Socket of the session, shut down to cancel the session.
+};
+
+
+/**
+ * Accept loops of the server and the registry of sessions admitted.
+ */
+struct AsyncServer::AdmissionControl
+        : public std::enable_shared_from_this<AdmissionControl> {
+
+    /**
+     * Accept loop of one acceptor of the server.
+     * A pending accept holds the admission control, which owns the listener and its acceptor, so the accept
+     * can complete after the server is gone.
+     *
+     * Accepts are started by handlers of the acceptor's loop, and by whoever starts the server. The mutex keeps
+     * these from using the acceptor while it is being closed, i.e. if the loop is run by multiple threads.
+     * Note: The mutex is recursive as a failure to start an accept is reported inline.
+     */
+    class Listener
+            : public AcceptBatchCompletion {
+    public:
+
+        Listener(AdmissionControl& owner, Acceptor&& listening, EventLoop& acceptLoop, EventLoopGroup* loopGroup)
+            : AcceptBatchCompletion(&Listener::onComplete)
+            , admission(owner)
+            , acceptor(std::move(listening))
+            , loop(acceptLoop)
+            , sessionLoops(loopGroup)
+            , retryTimer(acceptLoop)
+        {}
+
+        AdmissionControl&   admission;
+        std::recursive_mutex    acceptorMutex;
+        Acceptor            acceptor;
+        EventLoop&          loop;
+        EventLoopGroup*     sessionLoops;
+        Timer               retryTimer;
+        std::atomic<bool>   paused{false};   //!< Stopped accepting at the limit of sessions.
+        std::shared_ptr<AdmissionControl>   pending;    //!< Held by the accept in progress.
+
+    private:
+
+        static void onComplete(AsyncCompletion& self) {
+            auto& listener = static_cast<Listener&>(self);
+
+            // Accept is over: the listener lives for as long as this call
+            auto const admission = std::move(listener.pending);
+            if (admission->stopped.load()) {
+                // Connections accepted after the server has stopped are dropped
+                listener.sockets.clear();
+                return;
+            }
+
+            if (listener.isError()) {
+                admission->onAcceptFailed(listener, listener.getErrorCode());
+            } else {
+                admission->onAccepted(listener);
+            }
+        }
+    };
+
+
+    AdmissionControl(EventLoop& loop, SessionHandler const& connectionHandler, Acceptor::size_type acceptBatchSize,
+                     size_type sessionLimit)
+        : serverLoop(loop)
+        , handler(connectionHandler)
+        , batchSize(acceptBatchSize)
+        , maxSessions(sessionLimit)
+        , reserveHandle(openReserveHandle())
+        , drainTimer(loop)
+    {}
+
+    ~AdmissionControl() {
+        if (reserveHandle >= 0) {
+            ::close(reserveHandle);
+        }
+    }
+
+    void addListener(Acceptor&& acceptor, EventLoop& loop, EventLoopGroup* sessionLoops) {
+        listeners.emplace_back(std::make_unique<Listener>(*this, std::move(acceptor), loop, sessionLoops));
+    }
+
+    void start() {
+        for (auto& listener : listeners) {
+            accept(*listener);
+        }
+    }
+
+    void stop() {
+        // Accepts started from now on see the server stopped, so acceptors can be closed
+        if (stopped.exchange(true)) {
+            return;
+        }
+
+        for (auto& listener : listeners) {
+            // Acceptor and the retry timer are closed by their loop, so that their handlers don't run meanwhile
+            listener->loop.dispatch([self = shared_from_this(), l = listener.get()]() {
+                std::lock_guard<std::recursive_mutex> lock(l->acceptorMutex);
+                l->retryTimer.cancel();
+                l->acceptor.close();
+            });
+        }
+    }
+
+    void accept(Listener& listener) {
+        std::lock_guard<std::recursive_mutex> lock(listener.acceptorMutex);
+        if (stopped.load() || !listener.acceptor.isOpen()) {
+            return;
+        }
 
-                // Keep on accepting other sessions
-                if (acceptor.isOpen()) {
-                    doAcceptSession(acceptor, handler);
+        auto batch = batchSize;
+        if (maxSessions != 0) {
+            auto active = activeSessions.load();
+            while (active >= maxSessions) {
+                // At the limit: the next session to close resumes accepting.
+                // Re-check once paused as the last session may have closed in between.
+                listener.paused.store(true);
+                active = activeSessions.load();
+                if (active >= maxSessions || !listener.paused.exchange(false)) {
+                    return;
                 }
-          });
+            }
+
+            batch = std::min<Acceptor::size_type>(batch, maxSessions - active);
+        }
+
+        listener.pending = shared_from_this();
+        if (listener.sessionLoops) {
+            listener.acceptor.asyncAcceptBatch(*listener.sessionLoops, batch, listener);
+        } else {
+            listener.acceptor.asyncAcceptBatch(batch, listener);
+        }
+    }
+
+    void onAccepted(Listener& listener) {
+        for (auto& socket : listener.sockets) {
+            activeSessions.fetch_add(1);
+            acceptedSessions.fetch_add(1);
+
+            SessionTicket ticket{shared_from_this(), registerSession(socket)};
+            if (handler) {
+                handler(std::move(socket), std::move(ticket));
+            }
+        }
+
+        listener.sockets.clear();
+
+        // Keep on accepting other sessions
+        accept(listener);
+    }
+
+    void onAcceptFailed(Listener& listener, int errorCode) {
+        std::lock_guard<std::recursive_mutex> lock(listener.acceptorMutex);
+        if (stopped.load() || !listener.acceptor.isOpen()) {
+            return;
+        }
+
+        if ((errorCode == EMFILE || errorCode == ENFILE) && rejectConnection(listener.acceptor)) {
+            // Pending connection has been turned away, so the acceptor is not woken up for it again
+            accept(listener);
+            return;
+        }
+
+        // Accepting right away would spin on the same error: give sessions time to close and free resources
+        listener.retryTimer.setTimeout(kAcceptRetryDelay);
+        listener.retryTimer.asyncWait()
+                .then([self = shared_from_this(), l = &listener](int64) {
+                    self->restoreReserve();
+                    self->accept(*l);
+                });
+    }
+
+    /**
+     * Accept and close a pending connection using the reserve descriptor, when out of descriptors.
+     * @return True if a connection has been rejected.
+     */
+    bool rejectConnection(Acceptor& acceptor) {
+        std::lock_guard<std::mutex> lock(reserveMutex);
+        if (reserveHandle < 0) {
+            return false;
+        }
+
+        ::close(reserveHandle);
+        reserveHandle = -1;
+
+        // Non-blocking accept fails instead of waiting if the connection has been reset by the peer
+        acceptor.nonBlocking(true);
+        bool const rejected = acceptor.accept().isOk();
+        acceptor.nonBlocking(false);
+
+        reserveHandle = openReserveHandle();
+
+        return rejected;
+    }
+
+    void restoreReserve() {
+        std::lock_guard<std::mutex> lock(reserveMutex);
+        if (reserveHandle < 0) {
+            reserveHandle = openReserveHandle();
+        }
+    }
+
+    SessionRecord* registerSession(StreamSocket& socket) {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+
+        auto* record = freeRecords;
+        if (record) {
+            freeRecords = record->next;
+        } else {
+            record = records.emplace_back(std::make_unique<SessionRecord>()).get();
+        }
+
+        record->socket = socket.getShutdownHandle();
+        record->prev = nullptr;
+        record->next = liveSessions;
+        if (liveSessions) {
+            liveSessions->prev = record;
+        }
+        liveSessions = record;
+
+        return record;
+    }
+
+    void release(SessionRecord* record) {
+        std::optional<Promise<void>> drained;
+        size_type active = 0;
+        {
+            std::lock_guard<std::mutex> lock(sessionsMutex);
+            if (record->prev) {
+                record->prev->next = record->next;
+            } else {
+                liveSessions = record->next;
+            }
+
+            if (record->next) {
+                record->next->prev = record->prev;
+            }
+
+            record->socket = {};
+            record->prev = nullptr;
+            record->next = freeRecords;
+            freeRecords = record;
+
+            active = activeSessions.fetch_sub(1) - 1;
+            closedSessions.fetch_add(1);
+            if (active == 0 && drainPromise) {
+                drained = std::move(drainPromise);
+                drainPromise.reset();
+            }
+        }
+
+        if (drained) {
+            // Deadline has not come: sessions are all gone, there is nothing left to cancel
+            serverLoop.post([self = shared_from_this()]() {
+                self->drainTimer.cancel();
+            });
+
+            drained->setValue();
+            return;
+        }
+
+        if (maxSessions == 0 || active >= maxSessions || stopped.load()) {
+            return;
+        }
+
+        for (auto& listener : listeners) {
+            if (listener->paused.exchange(false)) {
+                listener->loop.post([self = shared_from_this(), l = listener.get()]() {
+                    self->accept(*l);
+                });
+            }
+        }
+    }
+
+
+    Future<void> drain(Deadline deadline) {
+        Promise<void> promise;
+        auto f = promise.getFuture();
+
+        if (draining.exchange(true)) {
+            promise.setError(makeError(AsyncError::AsyncSystemError, EALREADY, "AsyncServer::drain"));
+            return f;
+        }
+
+        bool pending = false;
+        {
+            std::lock_guard<std::mutex> lock(sessionsMutex);
+            pending = (activeSessions.load() != 0);
+            if (pending) {
+                drainPromise = std::move(promise);
+            }
+        }
+
+        if (!pending) {
+            promise.setValue();
+            return f;
+        }
+
+        auto const now = Deadline::clock::now();
+        auto const timeout = (deadline > now)
+                ? std::chrono::ceil<Timer::duration_type>(deadline - now)
+                : Timer::duration_type{0};
+
+        drainTimer.setTimeout(timeout);
+        drainTimer.asyncWait()
+                .then([self = shared_from_this()](int64) {
+                    self->cancelSessions();
+                });
+
+        return f;
+    }
+
+    /** Cancel sessions still open: IO in progress fails and further IO finds the socket shut down. */
+    void cancelSessions() {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        for (auto* record = liveSessions; record; record = record->next) {
+            record->socket.shutdown();
+        }
+    }
+
+
+    EventLoop&                      serverLoop;     //!< Loop of the drain timer.
+    SessionHandler const            handler;        //!< Copy of the server's handler, as sessions may outlive it.
+    Acceptor::size_type const       batchSize;
+    size_type const                 maxSessions;    //!< Maximum number of sessions admitted, 0 for no limit.
+    std::atomic<size_type>          activeSessions{0};
+    std::atomic<uint64>             acceptedSessions{0};
+    std::atomic<uint64>             closedSessions{0};
+    std::atomic<bool>               stopped{false};
+    std::atomic<bool>               draining{false};
+
+    std::mutex                      reserveMutex;
+    int                             reserveHandle;  //!< Descriptor kept in reserve to reject connections with.
+
+    std::vector<std::unique_ptr<Listener>>  listeners;
+
+    std::mutex                      sessionsMutex;  //!< Guards the registry of sessions and the drain promise.
+    SessionRecord*                  liveSessions{nullptr};
+    SessionRecord*                  freeRecords{nullptr};
+    std::vector<std::unique_ptr<SessionRecord>> records;
+    std::optional<Promise<void>>    drainPromise;   //!< Resolved once the last session closes while draining.
+    Timer                           drainTimer;
+};
+
+
+AsyncServer::~AsyncServer() {
+    stop();
+}
+
+
+AsyncServer&
+AsyncServer::operator= (AsyncServer&& rhs) noexcept {
+    if (this != &rhs) {
+        stop();
+
+        _loop = rhs._loop;
+        _sessionLoops = rhs._sessionLoops;
+        _connectionHandler = std::move(rhs._connectionHandler);
+        _acceptBatchSize = rhs._acceptBatchSize;
+        _maxSessions = rhs._maxSessions;
+        _admission = std::move(rhs._admission);
+    }
+
+    return *this;
+}
+
+
+void
+AsyncServer::SessionTicket::release() {
+    if (auto admission = std::move(_admission)) {
+        admission->release(std::exchange(_record, nullptr));
+    }
+}
+
+
+bool
+AsyncServer::SessionTicket::isDraining() const noexcept {
+    return _admission && _admission->draining.load();
+}
+
+
+AsyncServer::size_type
+AsyncServer::getActiveSessions() const noexcept {
+    return _admission ? _admission->activeSessions.load() : 0;
+}
+
+
+AsyncServer::SessionCounters
+AsyncServer::getSessionCounters() const noexcept {
+    if (!_admission) {
+        return {0, 0, 0};
+    }
+
+    return {_admission->acceptedSessions.load(), _admission->closedSessions.load(), _admission->activeSessions.load()};
+}
+
+
+Future<void>
+AsyncServer::drain(Deadline deadline) {
+    if (!_admission) {
+        Promise<void> promise;
+        auto f = promise.getFuture();
+        promise.setValue();
+
+        return f;
+    }
+
+    stop();
+
+    return _admission->drain(deadline);
 }
 
 
 void
 AsyncServer::stop() {
-    _acceptor.close();
+    if (_admission) {
+        _admission->stop();
+    }
+}
+
+
+NetworkEndpoint
+AsyncServer::getLocalEndpoint() const {
+    // All the acceptors of a sharded server are bound to the same endpoint
+    auto& listener = *_admission->listeners.front();
+    std::lock_guard<std::recursive_mutex> lock(listener.acceptorMutex);
+
+    return listener.acceptor.getLocalEndpoint();
 }
 
 
 Solace::Result<void, Solace::Error>
 AsyncServer::startListen(NetworkEndpoint const& endpoint) {
-    return _acceptor.open(endpoint)
-                .then([this]() {
-                    doAcceptSession(_acceptor, _connectionHandler);
-                });
+    return startListen(endpoint, ListenOptions{});
 }
 
 
+Solace::Result<void, Solace::Error>
+AsyncServer::startListen(NetworkEndpoint const& endpoint, ListenOptions const& options) {
+    if (_admission) {
+        return Err(makeError(SystemErrors::ISCONN, "AsyncServer::startListen"));
+    }
+
+    Acceptor acceptor{_loop};
+    auto result = acceptor.open(endpoint, options);
+    if (!result) {
+        return result;
+    }
+
+    bool const sharded = options.reusePort && _sessionLoops;
+
+    // Other acceptors must bind the port actually assigned to the first one
+    std::vector<Acceptor> shardAcceptors;
+    if (sharded) {
+        auto const boundEndpoint = acceptor.getLocalEndpoint();
+
+        shardAcceptors.reserve(_sessionLoops->size() - 1);
+        for (EventLoopGroup::size_type i = 1; i < _sessionLoops->size(); ++i) {
+            auto shardResult = shardAcceptors.emplace_back((*_sessionLoops)[i]).open(boundEndpoint, options);
+            if (!shardResult) {
+                return shardResult;
+            }
+        }
+    }
+
+    _admission = std::make_shared<AdmissionControl>(_loop, _connectionHandler, _acceptBatchSize, _maxSessions);
+
+    // Each acceptor of a sharded server hands connections to its own loop
+    _admission->addListener(std::move(acceptor), _loop, sharded ? nullptr : _sessionLoops);
+    for (EventLoopGroup::size_type i = 0; i < shardAcceptors.size(); ++i) {
+        _admission->addListener(std::move(shardAcceptors[i]), (*_sessionLoops)[i + 1], nullptr);
+    }
+
+    _admission->start();
+
+    return result;
+}
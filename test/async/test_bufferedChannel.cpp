@@ -0,0 +1,168 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/async/test_bufferedChannel.cpp
+ *******************************************************************************/
+#include <cadence/async/bufferedChannel.hpp>  // Class being tested
+#include <cadence/async/pipe.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+
+using namespace Solace;
+using namespace cadence::async;
+
+
+namespace {
+
+void writeMessage(Pipe& pipe, char const* message) {
+    auto src = ByteReader(wrapMemory(message, strlen(message)));
+    ASSERT_TRUE(pipe.write(src).isOk());
+}
+
+}  // namespace
+
+
+TEST(TestBufferedChannel, testReadUntilServesManyMessagesFromOneRead) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+    BufferedChannel buffered(iopipe);
+
+    writeMessage(iopipe, "first\nsecond\n");
+
+    BufferedChannel::size_type lineLength = 0;
+    buffered.asyncReadUntil("\n")
+            .then([&lineLength](BufferedChannel::size_type n) {
+                lineLength = n;
+            });
+
+    iocontext.runFor(300);
+    iocontext.reset();
+
+    ASSERT_EQ(6U, lineLength);
+    ASSERT_EQ(13U, buffered.size());
+    ASSERT_EQ(0, memcmp(buffered.peek().dataAddress(), "first\n", 6));
+    buffered.consume(lineLength);
+
+    // Second line is already buffered: no IO needed
+    lineLength = 0;
+    buffered.asyncReadUntil("\n")
+            .then([&lineLength](BufferedChannel::size_type n) {
+                lineLength = n;
+            });
+
+    ASSERT_EQ(7U, lineLength);
+    ASSERT_EQ(0, memcmp(buffered.peek().dataAddress(), "second\n", 7));
+}
+
+
+TEST(TestBufferedChannel, testReadUntilMultibyteDelimiterAcrossReads) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+    BufferedChannel buffered(iopipe);
+
+    BufferedChannel::size_type headerLength = 0;
+    buffered.asyncReadUntil("\r\n\r\n")
+            .then([&headerLength](BufferedChannel::size_type n) {
+                headerLength = n;
+            });
+
+    writeMessage(iopipe, "GET / HTTP/1.1\r\n\r");
+    iocontext.poll();
+    ASSERT_EQ(0U, headerLength);
+
+    writeMessage(iopipe, "\nbody");
+    iocontext.runFor(300);
+
+    ASSERT_EQ(18U, headerLength);
+    ASSERT_EQ(22U, buffered.size());
+}
+
+
+TEST(TestBufferedChannel, testReadUntilFailsWhenBufferIsFull) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+    BufferedChannel buffered(iopipe, 8);
+
+    writeMessage(iopipe, "no delimiter here");
+
+    bool failed = false;
+    buffered.asyncReadUntil("\n")
+            .onError([&failed](Error&&) {
+                failed = true;
+            });
+
+    iocontext.runFor(300);
+
+    ASSERT_TRUE(failed);
+    ASSERT_EQ(8U, buffered.size());
+}
+
+
+TEST(TestBufferedChannel, testPeekAndRead) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+    BufferedChannel buffered(iopipe);
+
+    writeMessage(iopipe, "0123456789");
+
+    BufferedChannel::size_type available = 0;
+    buffered.asyncPeek(4)
+            .then([&available](BufferedChannel::size_type n) {
+                available = n;
+            });
+
+    iocontext.runFor(300);
+    iocontext.reset();
+    ASSERT_EQ(10U, available);
+
+    char dest[6];
+    auto destWriter = ByteWriter(wrapMemory(dest));
+
+    bool readComplete = false;
+    buffered.asyncRead(destWriter)
+            .then([&readComplete]() {
+                readComplete = true;
+            });
+
+    iocontext.runFor(300);
+
+    ASSERT_TRUE(readComplete);
+    ASSERT_EQ(0, memcmp(dest, "012345", 6));
+    ASSERT_EQ(4U, buffered.size());
+}
+
+
+TEST(TestBufferedChannel, testDestroyWithReadPending) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    bool resolved = false;
+    {
+        BufferedChannel buffered(iopipe);
+        buffered.asyncPeek(4)
+                .then([&resolved](BufferedChannel::size_type) {
+                    resolved = true;
+                });
+
+        iocontext.runFor(10);
+        iocontext.reset();
+    }
+
+    // Read of the pipe completes into the buffer left behind by the destroyed channel
+    writeMessage(iopipe, "late data");
+    iocontext.runFor(100);
+
+    ASSERT_FALSE(resolved);
+}
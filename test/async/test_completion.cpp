@@ -0,0 +1,120 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/async/test_completion.cpp
+ *
+ * Tests of completion record based async operations.
+ * Coroutine awaitables built on them are tested by test/async/test_coroutine.cpp.
+ *******************************************************************************/
+#include <cadence/async/completion.hpp>  // Class being tested
+
+#include <cadence/async/pipe.hpp>
+#include <cadence/async/timer.hpp>
+#include <cadence/async/event.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+
+using namespace Solace;
+using namespace cadence::async;
+
+
+namespace {
+
+struct CountingCompletion : public AsyncCompletion {
+    CountingCompletion()
+        : AsyncCompletion(&CountingCompletion::onComplete)
+    {}
+
+    static void onComplete(AsyncCompletion& self) {
+        static_cast<CountingCompletion&>(self).timesCalled += 1;
+    }
+
+    int timesCalled{0};
+};
+
+}  // namespace
+
+
+TEST(TestAsyncCompletion, testPipeReadWrite) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    char message[] = "Hello there!";
+    auto const messageLen = strlen(message) + 1;
+    auto messageBuffer = ByteReader(wrapMemory(message));
+
+    char rcv_buffer[128];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+
+    CountingCompletion writeDone;
+    CountingCompletion readDone;
+
+    iopipe.asyncWrite(messageBuffer, messageBuffer.remaining(), writeDone);
+    iopipe.asyncRead(readBuffer, readBuffer.remaining(), readDone);
+
+    iocontext.runFor(300);
+
+    ASSERT_EQ(1, writeDone.timesCalled);
+    ASSERT_EQ(1, readDone.timesCalled);
+    ASSERT_FALSE(writeDone.isError());
+    ASSERT_FALSE(readDone.isError());
+
+    ASSERT_EQ(messageLen, writeDone.getValue());
+    ASSERT_EQ(messageLen, readDone.getValue());
+    ASSERT_EQ(messageLen, messageBuffer.position());
+    ASSERT_EQ(messageLen, readBuffer.position());
+    ASSERT_EQ(0, strcmp(message, rcv_buffer));
+}
+
+
+TEST(TestAsyncCompletion, testCancelledReadReportsError) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    char rcv_buffer[16];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+
+    CountingCompletion readDone;
+    iopipe.asyncRead(readBuffer, readBuffer.remaining(), readDone);
+    iopipe.cancel();
+
+    iocontext.runFor(100);
+
+    ASSERT_EQ(1, readDone.timesCalled);
+    ASSERT_TRUE(readDone.isError());
+    ASSERT_TRUE(readDone.toResult().isError());
+    ASSERT_EQ(0, readBuffer.position());
+}
+
+
+TEST(TestAsyncCompletion, testTimerAndEvent) {
+    EventLoop iocontext;
+    Timer timer(iocontext, std::chrono::milliseconds(5));
+    Event event(iocontext);
+
+    CountingCompletion timerDone;
+    CountingCompletion eventDone;
+
+    timer.asyncWait(timerDone);
+    event.asyncWait(eventDone);
+    event.notify();
+
+    iocontext.runFor(100);
+
+    ASSERT_EQ(1, timerDone.timesCalled);
+    ASSERT_EQ(1, eventDone.timesCalled);
+    ASSERT_FALSE(timerDone.isError());
+    ASSERT_FALSE(eventDone.isError());
+}
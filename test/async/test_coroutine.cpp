@@ -0,0 +1,94 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/async/test_coroutine.cpp
+ *
+ * Tests of C++20 coroutine awaitables. Built as C++20 into a test executable of its own,
+ * as the library and the rest of the tests are C++17.
+ *******************************************************************************/
+#include <cadence/async/coroutine.hpp>  // Class being tested
+
+#include <cadence/async/pipe.hpp>
+#include <cadence/async/timer.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstring>
+
+#ifndef CADENCE_ASYNC_HAS_COROUTINES
+#error "Coroutine tests must be compiled with coroutine support, i.e. -std=c++20"
+#endif
+
+
+using namespace Solace;
+using namespace cadence::async;
+
+
+namespace {
+
+coro::Detached echoOnce(Pipe& iopipe, ByteReader& src, ByteWriter& dest, int& stage) {
+    auto writeResult = co_await coro::asyncWrite(iopipe, src);
+    stage = writeResult.isOk() ? 1 : -1;
+
+    auto readResult = co_await coro::asyncRead(iopipe, dest, src.position());
+    stage = readResult.isOk() ? 2 : -2;
+}
+
+coro::Detached waitTwice(Timer& timer, int& nbWakeups) {
+    for (int i = 0; i < 2; ++i) {
+        timer.setTimeout(std::chrono::milliseconds(2));
+        auto result = co_await coro::asyncWait(timer);
+        if (result.isOk()) {
+            nbWakeups += 1;
+        }
+    }
+}
+
+}  // namespace
+
+
+TEST(TestAsyncCoroutine, testPipeWriteThenRead) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    char message[] = "Hello coroutine!";
+    auto const messageLen = strlen(message) + 1;
+    auto messageBuffer = ByteReader(wrapMemory(message));
+
+    char rcv_buffer[128];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+
+    int stage = 0;
+    echoOnce(iopipe, messageBuffer, readBuffer, stage);
+    ASSERT_EQ(0, stage);
+
+    iocontext.runFor(300);
+
+    ASSERT_EQ(2, stage);
+    ASSERT_EQ(messageLen, readBuffer.position());
+    ASSERT_EQ(0, strcmp(message, rcv_buffer));
+}
+
+
+TEST(TestAsyncCoroutine, testTimerLoop) {
+    EventLoop iocontext;
+    Timer timer(iocontext);
+
+    int nbWakeups = 0;
+    waitTwice(timer, nbWakeups);
+
+    iocontext.runFor(100);
+
+    ASSERT_EQ(2, nbWakeups);
+}
+
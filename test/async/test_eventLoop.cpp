@@ -0,0 +1,324 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/async/test_eventLoop.cpp
+ *******************************************************************************/
+#include <cadence/async/eventloop.hpp>  // Class being tested
+#include <cadence/async/timer.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace Solace;
+using namespace cadence::async;
+using namespace std::chrono_literals;
+
+
+TEST(TestEventLoop, testRunWithNoWorkReturns) {
+    EventLoop iocontext;
+
+    iocontext.run(4);
+
+    ASSERT_EQ(0U, iocontext.runningThreads());
+}
+
+
+TEST(TestEventLoop, testRunOnMultipleThreads) {
+    EventLoop iocontext;
+
+    std::mutex guard;
+    std::set<std::thread::id> threadsUsed;
+    std::atomic<int> nbTimesCalled{0};
+
+    std::vector<Timer> timers;
+    for (int i = 0; i < 8; ++i) {
+        timers.emplace_back(iocontext, std::chrono::milliseconds(5));
+    }
+
+    for (auto& timer : timers) {
+        timer.asyncWait()
+            .then([&](int64) {
+                {
+                    std::lock_guard<std::mutex> lock(guard);
+                    threadsUsed.insert(std::this_thread::get_id());
+                }
+
+                // Keep this thread busy so that other threads pick up remaining handlers
+                std::this_thread::sleep_for(20ms);
+                nbTimesCalled += 1;
+            });
+    }
+
+    iocontext.run(4);
+
+    ASSERT_EQ(8, nbTimesCalled.load());
+    ASSERT_LT(1U, threadsUsed.size());
+    ASSERT_EQ(0U, iocontext.runningThreads());
+}
+
+
+TEST(TestEventLoop, testStopFromHandlerStopsAllThreads) {
+    EventLoop iocontext;
+
+    Timer stopTimer(iocontext, std::chrono::milliseconds(10));
+    Timer farTimer(iocontext, std::chrono::milliseconds(10000));
+
+    stopTimer.asyncWait()
+        .then([&iocontext](int64) {
+            iocontext.stop();
+        });
+    farTimer.asyncWait();
+
+    auto const startedAt = std::chrono::steady_clock::now();
+    iocontext.run(3);
+
+    ASSERT_LT(std::chrono::steady_clock::now() - startedAt, 5s);
+    ASSERT_TRUE(iocontext.isStopped());
+
+    // Loop can be restarted once all threads have returned
+    iocontext.reset();
+    ASSERT_FALSE(iocontext.isStopped());
+}
+
+
+TEST(TestEventLoop, testRunForWithThreadsRespectsDeadline) {
+    EventLoop iocontext;
+
+    Timer farTimer(iocontext, std::chrono::milliseconds(10000));
+    farTimer.asyncWait();
+
+    auto const startedAt = std::chrono::steady_clock::now();
+    iocontext.runFor(4, 50);
+
+    ASSERT_LT(std::chrono::steady_clock::now() - startedAt, 5s);
+    ASSERT_EQ(0U, iocontext.runningThreads());
+}
+
+
+TEST(TestEventLoop, testPostRunsOnRun) {
+    EventLoop iocontext;
+
+    int nbTimesCalled = 0;
+    iocontext.post([&nbTimesCalled]() { nbTimesCalled += 1; });
+    iocontext.post([&nbTimesCalled]() { nbTimesCalled += 1; });
+
+    // Posting never runs the task inline
+    ASSERT_EQ(0, nbTimesCalled);
+
+    iocontext.run();
+    ASSERT_EQ(2, nbTimesCalled);
+}
+
+
+TEST(TestEventLoop, testDispatchRunsInlineOnLoopThread) {
+    EventLoop iocontext;
+
+    std::vector<int> order;
+    iocontext.post([&]() {
+        ASSERT_TRUE(iocontext.isRunningInThisThread());
+
+        iocontext.defer([&order]() { order.push_back(3); });
+        iocontext.dispatch([&order]() { order.push_back(1); });
+        order.push_back(2);
+    });
+
+    ASSERT_FALSE(iocontext.isRunningInThisThread());
+    iocontext.run();
+
+    ASSERT_EQ((std::vector<int>{1, 2, 3}), order);
+}
+
+
+TEST(TestEventLoop, testTaskHoldsMoveOnlyState) {
+    EventLoop iocontext;
+
+    auto value = std::make_unique<int>(42);
+    int observed = 0;
+    iocontext.post([v = std::move(value), &observed]() { observed = *v; });
+
+    iocontext.run();
+    ASSERT_EQ(42, observed);
+}
+
+
+TEST(TestEventLoop, testPostFromForeignThreads) {
+    EventLoop iocontext;
+
+    constexpr int kNbThreads = 4;
+    constexpr int kNbTasksPerThread = 2000;
+    std::atomic<int> nbTimesCalled{0};
+
+    // Keep the loop alive long enough for all producers to finish
+    Timer keepAlive(iocontext, std::chrono::milliseconds(10000));
+    keepAlive.asyncWait();
+
+    std::vector<std::thread> producers;
+    for (int i = 0; i < kNbThreads; ++i) {
+        producers.emplace_back([&]() {
+            for (int j = 0; j < kNbTasksPerThread; ++j) {
+                iocontext.post([&]() {
+                    if (nbTimesCalled.fetch_add(1) + 1 == kNbThreads * kNbTasksPerThread) {
+                        iocontext.stop();
+                    }
+                });
+            }
+        });
+    }
+
+    iocontext.run(2);
+
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    ASSERT_EQ(kNbThreads * kNbTasksPerThread, nbTimesCalled.load());
+}
+
+
+TEST(TestEventLoop, testPostFromForeignThreadKeepsOrderWhenQueueOverflows) {
+    EventLoop iocontext;
+
+    // More tasks than the queue of foreign submissions holds, submitted before the loop runs
+    constexpr int kNbTasks = 2000;
+    std::vector<int> order;
+
+    std::thread producer([&]() {
+        for (int i = 0; i < kNbTasks; ++i) {
+            iocontext.post([&order, i]() {
+                order.push_back(i);
+            });
+        }
+    });
+    producer.join();
+
+    iocontext.run();
+
+    ASSERT_EQ(static_cast<std::size_t>(kNbTasks), order.size());
+    ASSERT_TRUE(std::is_sorted(order.begin(), order.end()));
+}
+
+
+TEST(TestEventLoop, testPostFromForeignThreadKeepsOrderOnMultipleThreads) {
+    EventLoop iocontext;
+
+    // Keeps the loop running until the last task stops it
+    Timer farTimer(iocontext, std::chrono::milliseconds(10000));
+    farTimer.asyncWait();
+
+    constexpr int kNbTasks = 20000;
+    std::mutex orderGuard;
+    std::vector<int> order;
+
+    std::thread producer([&]() {
+        for (int i = 0; i < kNbTasks; ++i) {
+            iocontext.post([&, i]() {
+                std::lock_guard<std::mutex> lock(orderGuard);
+                order.push_back(i);
+                if (i + 1 == kNbTasks) {
+                    iocontext.stop();
+                }
+            });
+        }
+    });
+
+    iocontext.run(4);
+    producer.join();
+
+    ASSERT_EQ(static_cast<std::size_t>(kNbTasks), order.size());
+    ASSERT_TRUE(std::is_sorted(order.begin(), order.end()));
+}
+
+
+TEST(TestEventLoop, testThrowingTaskDoesNotStrandForeignTasks) {
+    EventLoop iocontext;
+
+    int nbTimesCalled = 0;
+    std::thread producer([&]() {
+        iocontext.post([]() {
+            throw std::runtime_error("task failed");
+        });
+        iocontext.post([&nbTimesCalled]() {
+            nbTimesCalled += 1;
+        });
+    });
+    producer.join();
+
+    ASSERT_THROW(iocontext.run(), std::runtime_error);
+
+    // Loop is resumed after the exception
+    iocontext.run();
+    ASSERT_EQ(1, nbTimesCalled);
+}
+
+
+TEST(TestEventLoop, testBusyPollRunsHandlersWhileSpinning) {
+    EventLoop iocontext;
+
+    int nbTimesCalled = 0;
+    for (int i = 0; i < 10; ++i) {
+        iocontext.post([&nbTimesCalled]() { nbTimesCalled += 1; });
+    }
+
+    auto const stats = iocontext.runBusyPoll(BusyPollOptions{});
+
+    ASSERT_EQ(10, nbTimesCalled);
+    // Note: tasks posted from outside of the loop are executed in batches
+    ASSERT_LT(0U, stats.handlersSpinning);
+    ASSERT_EQ(0U, stats.sleepCycles);
+    ASSERT_TRUE(iocontext.isStopped());
+}
+
+
+TEST(TestEventLoop, testBusyPollSleepsWhenIdle) {
+    EventLoop iocontext;
+
+    bool timerFired = false;
+    Timer timer(iocontext, std::chrono::milliseconds(30));
+    timer.asyncWait().then([&timerFired](int64) {
+        timerFired = true;
+    });
+
+    BusyPollOptions options;
+    options.spinBudget = 20us;
+    options.maxSleep = 5ms;
+
+    auto const stats = iocontext.runBusyPoll(options);
+
+    ASSERT_TRUE(timerFired);
+    ASSERT_LT(0U, stats.spinCycles);
+    // With 5ms max sleep we must have gone to sleep a few times while waiting for a 30ms timer
+    ASSERT_LE(2U, stats.sleepCycles);
+}
+
+
+TEST(TestEventLoop, testBusyPollForRespectsDeadline) {
+    EventLoop iocontext;
+
+    Timer farTimer(iocontext, std::chrono::milliseconds(10000));
+    farTimer.asyncWait();
+
+    auto const startedAt = std::chrono::steady_clock::now();
+    iocontext.runBusyPollFor(BusyPollOptions{}, 50);
+
+    ASSERT_LT(std::chrono::steady_clock::now() - startedAt, 5s);
+    ASSERT_EQ(0U, iocontext.runningThreads());
+}
+
@@ -0,0 +1,119 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/async/test_eventLoopGroup.cpp
+ *******************************************************************************/
+#include <cadence/async/eventLoopGroup.hpp>  // Class being tested
+#include <cadence/async/pipe.hpp>
+#include <cadence/async/acceptor.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+using namespace std::chrono_literals;
+
+
+TEST(TestEventLoopGroup, testDefaultSizeIsNonZero) {
+    EventLoopGroup group;
+
+    ASSERT_LT(0U, group.size());
+}
+
+
+TEST(TestEventLoopGroup, testRoundRobinSelection) {
+    EventLoopGroup group(3, EventLoopGroup::Selection::RoundRobin, false);
+
+    auto* first = &group.next();
+    auto* second = &group.next();
+    auto* third = &group.next();
+
+    ASSERT_NE(first, second);
+    ASSERT_NE(second, third);
+    ASSERT_NE(first, third);
+    ASSERT_EQ(first, &group.next());
+}
+
+
+TEST(TestEventLoopGroup, testLeastLoadedSelection) {
+    EventLoopGroup group(2, EventLoopGroup::Selection::LeastLoaded, false);
+
+    Pipe p1(group[0]);
+    Pipe p2(group[0]);
+    ASSERT_EQ(2U, group[0].channelCount());
+    ASSERT_EQ(0U, group[1].channelCount());
+
+    ASSERT_EQ(&group[1], &group.next());
+
+    {
+        Pipe p3(group[1]);
+        Pipe p4(group[1]);
+        Pipe p5(group[1]);
+        ASSERT_EQ(&group[0], &group.next());
+    }
+
+    // Channels have been destroyed and detached from the loop
+    ASSERT_EQ(0U, group[1].channelCount());
+    ASSERT_EQ(&group[1], &group.next());
+}
+
+
+TEST(TestEventLoopGroup, testStartStop) {
+    EventLoopGroup group(2, EventLoopGroup::Selection::RoundRobin, true);
+
+    group.start();
+    std::this_thread::sleep_for(10ms);
+
+    // Loops keep running without any work until stopped
+    ASSERT_EQ(1U, group[0].runningThreads());
+    ASSERT_EQ(1U, group[1].runningThreads());
+
+    group.stop();
+    group.join();
+
+    ASSERT_EQ(0U, group[0].runningThreads());
+    ASSERT_EQ(0U, group[1].runningThreads());
+}
+
+
+TEST(TestEventLoopGroup, testAcceptOntoAnotherLoop) {
+    EventLoopGroup group(2, EventLoopGroup::Selection::RoundRobin, false);
+
+    std::atomic<EventLoop*> acceptedOn{nullptr};
+
+    Acceptor acceptor(group[0]);
+    ASSERT_TRUE(acceptor.open(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+
+    acceptor.asyncAccept(group[1])
+            .then([&acceptedOn](StreamSocket&& socket) {
+                acceptedOn.store(&socket.getIOContext());
+            });
+
+    group.start();
+
+    auto client = createTCPSocket(group);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+    for (int i = 0; i < 100 && !acceptedOn.load(); ++i) {
+        std::this_thread::sleep_for(5ms);
+    }
+
+    group.stop();
+    group.join();
+
+    ASSERT_EQ(&group[1], acceptedOn.load());
+}
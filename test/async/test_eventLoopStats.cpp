@@ -0,0 +1,145 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/async/test_eventLoopStats.cpp
+ *******************************************************************************/
+#include <cadence/async/eventLoopStats.hpp>  // Class being tested
+#include <cadence/async/eventloop.hpp>
+#include <cadence/async/timer.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <thread>
+
+
+using namespace Solace;
+using namespace cadence::async;
+using namespace std::chrono_literals;
+
+
+TEST(TestDurationHistogram, testBucketIndex) {
+    ASSERT_EQ(0U, DurationHistogram::bucketIndex(0us));
+    ASSERT_EQ(1U, DurationHistogram::bucketIndex(1us));
+    ASSERT_EQ(2U, DurationHistogram::bucketIndex(2us));
+    ASSERT_EQ(2U, DurationHistogram::bucketIndex(3us));
+    ASSERT_EQ(11U, DurationHistogram::bucketIndex(1500us));
+    ASSERT_EQ(DurationHistogram::kNbBuckets - 1, DurationHistogram::bucketIndex(std::chrono::hours(48)));
+
+    ASSERT_LT(1500us, DurationHistogram::bucketUpperBound(DurationHistogram::bucketIndex(1500us)));
+}
+
+
+TEST(TestDurationHistogram, testPercentile) {
+    DurationHistogram::Buckets buckets{};
+    buckets[DurationHistogram::bucketIndex(10us)] = 99;
+    buckets[DurationHistogram::bucketIndex(5000us)] = 1;
+
+    DurationHistogram histogram{buckets, 99 * 10us + 5000us, 5000us};
+
+    ASSERT_EQ(100U, histogram.count());
+    ASSERT_EQ(59us, histogram.mean());
+    ASSERT_EQ(16us, histogram.percentile(0.5));
+    ASSERT_EQ(5000us, histogram.percentile(0.999));
+    ASSERT_EQ(5000us, histogram.max());
+}
+
+
+TEST(TestEventLoopStats, testDisabledByDefault) {
+    EventLoop iocontext;
+
+    iocontext.post([]() {});
+    iocontext.run();
+
+    ASSERT_FALSE(iocontext.isInstrumented());
+    ASSERT_EQ(0U, iocontext.getStats().handlerTime.count());
+}
+
+
+TEST(TestEventLoopStats, testHandlerTimeIsRecorded) {
+    EventLoop iocontext;
+    iocontext.enableInstrumentation();
+    ASSERT_TRUE(iocontext.isInstrumented());
+
+    Timer timer(iocontext, 1ms);
+    timer.asyncWait().then([](int64) {
+        std::this_thread::sleep_for(2ms);
+    });
+
+    iocontext.post([&iocontext]() {
+        // Nested handler is accounted for by the outer one
+        iocontext.dispatch([]() {});
+    });
+
+    ASSERT_EQ(1U, iocontext.getStats().tasksQueued);
+    iocontext.run();
+
+    auto const stats = iocontext.getStats();
+    ASSERT_EQ(2U, stats.handlerTime.count());
+    ASSERT_LE(2000us, stats.handlerTime.max());
+    ASSERT_EQ(0U, stats.tasksQueued);
+    ASSERT_EQ(0U, stats.budgetExceeded);
+}
+
+
+TEST(TestEventLoopStats, testBudgetExceeded) {
+    EventLoop iocontext;
+
+    int nbCallbacks = 0;
+    std::chrono::microseconds reported{0};
+
+    InstrumentationOptions options;
+    options.handlerBudget = 1ms;
+    options.onBudgetExceeded = [&](std::chrono::microseconds elapsed) {
+        nbCallbacks += 1;
+        reported = elapsed;
+    };
+    iocontext.enableInstrumentation(std::move(options));
+
+    iocontext.post([]() {});
+    iocontext.post([]() { std::this_thread::sleep_for(5ms); });
+    iocontext.run();
+
+    ASSERT_EQ(1, nbCallbacks);
+    ASSERT_LE(5000us, reported);
+    ASSERT_EQ(1U, iocontext.getStats().budgetExceeded);
+}
+
+
+TEST(TestEventLoopStats, testLagProbe) {
+    EventLoop iocontext;
+
+    InstrumentationOptions options;
+    options.lagProbeInterval = 2ms;
+    iocontext.enableInstrumentation(std::move(options));
+
+    // Block the loop so that the probe is executed late
+    Timer blocker(iocontext, 1ms);
+    blocker.asyncWait().then([](int64) {
+        std::this_thread::sleep_for(20ms);
+    });
+
+    iocontext.runFor(100);
+
+    auto const stats = iocontext.getStats();
+    ASSERT_LT(1U, stats.loopLag.count());
+    ASSERT_LE(15ms, stats.loopLag.max());
+
+    // Probe is not re-armed once disabled
+    iocontext.disableInstrumentation();
+    ASSERT_FALSE(iocontext.isInstrumented());
+    iocontext.reset();
+    iocontext.runFor(10);
+
+    auto const laterStats = iocontext.getStats();
+    ASSERT_GE(stats.loopLag.count() + 1, laterStats.loopLag.count());
+}
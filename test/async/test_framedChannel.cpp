@@ -0,0 +1,205 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/async/test_framedChannel.cpp
+ *******************************************************************************/
+#include <cadence/async/framedChannel.hpp>  // Class being tested
+#include <cadence/async/pipe.hpp>
+#include <cadence/async/acceptor.hpp>
+#include <cadence/async/streamsocket.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <vector>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+void writeBytes(Pipe& pipe, char const* data, size_t size) {
+    auto src = ByteReader(wrapMemory(data, size));
+    ASSERT_TRUE(pipe.write(src).isOk());
+}
+
+}  // namespace
+
+
+TEST(TestFramedChannel, testWriteAndReadFrames) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+    FramedChannel framed(iopipe);
+
+    char message[] = "Hello, framed world!";
+    auto payload = ByteReader(wrapMemory(message, strlen(message)));
+
+    bool writeComplete = false;
+    framed.asyncWriteFrame(payload)
+            .then([&writeComplete]() {
+                writeComplete = true;
+            });
+
+    bool readComplete = false;
+    framed.asyncReadFrame()
+            .then([&readComplete, &message](MemoryView frame) {
+                readComplete = true;
+                ASSERT_EQ(strlen(message), frame.size());
+                ASSERT_EQ(0, memcmp(frame.dataAddress(), message, frame.size()));
+            });
+
+    iocontext.runFor(300);
+
+    ASSERT_TRUE(writeComplete);
+    ASSERT_TRUE(readComplete);
+    ASSERT_FALSE(payload.hasRemaining());
+}
+
+
+TEST(TestFramedChannel, testBufferedFramesAreServedWithoutIO) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+    FramedChannel framed(iopipe, FrameLengthEncoding::Fixed16);
+
+    // Three frames arrive with a single read
+    writeBytes(iopipe, "\0\3one\0\3two\0\0", 12);
+
+    int framesRead = 0;
+    framed.asyncReadFrame()
+            .then([&framesRead](MemoryView frame) {
+                framesRead += 1;
+                ASSERT_EQ(0, memcmp(frame.dataAddress(), "one", 3));
+            });
+
+    iocontext.runFor(300);
+    ASSERT_EQ(1, framesRead);
+
+    // Remaining frames are buffered already: reads complete without running the loop
+    framed.asyncReadFrame()
+            .then([&framesRead](MemoryView frame) {
+                framesRead += 1;
+                ASSERT_EQ(0, memcmp(frame.dataAddress(), "two", 3));
+            });
+    ASSERT_EQ(2, framesRead);
+
+    framed.asyncReadFrame()
+            .then([&framesRead](MemoryView frame) {
+                framesRead += 1;
+                ASSERT_TRUE(frame.empty());
+            });
+    ASSERT_EQ(3, framesRead);
+}
+
+
+TEST(TestFramedChannel, testVarintHeaderSplitAcrossReads) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+    FramedChannel framed(iopipe, FrameLengthEncoding::Varint);
+
+    std::vector<char> frame(300, 'x');
+    MemoryView::size_type frameSize = 0;
+    framed.asyncReadFrame()
+            .then([&frameSize](MemoryView payload) {
+                frameSize = payload.size();
+            });
+
+    // 300 encodes as 0xAC 0x02
+    writeBytes(iopipe, "\xAC", 1);
+    iocontext.poll();
+    ASSERT_EQ(0U, frameSize);
+
+    writeBytes(iopipe, "\x02", 1);
+    writeBytes(iopipe, frame.data(), frame.size());
+    iocontext.runFor(300);
+
+    ASSERT_EQ(300U, frameSize);
+}
+
+
+TEST(TestFramedChannel, testOversizedFramesAreRejected) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+    FramedChannel framed(iopipe, FrameLengthEncoding::Fixed32, 16);
+
+    char message[] = "This message is too long for the channel";
+    auto payload = ByteReader(wrapMemory(message, strlen(message)));
+
+    bool writeFailed = false;
+    framed.asyncWriteFrame(payload)
+            .onError([&writeFailed](Error&&) {
+                writeFailed = true;
+            });
+    ASSERT_TRUE(writeFailed);
+    ASSERT_TRUE(payload.hasRemaining());
+
+    writeBytes(iopipe, "\0\0\1\0", 4);
+
+    bool readFailed = false;
+    framed.asyncReadFrame()
+            .onError([&readFailed](Error&&) {
+                readFailed = true;
+            });
+
+    iocontext.runFor(300);
+    ASSERT_TRUE(readFailed);
+}
+
+
+TEST(TestFramedChannel, testFrameIsQueuedWithOtherWrites) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(IPEndpoint{IPAddress::any(), 0}).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    FramedChannel framed(client, FrameLengthEncoding::Fixed16);
+
+    char before[] = "AAAA";
+    char payload[] = "BBBB";
+    char after[] = "CCCC";
+    auto beforeSrc = ByteReader(wrapMemory(before, 4));
+    auto payloadSrc = ByteReader(wrapMemory(payload, 4));
+    auto afterSrc = ByteReader(wrapMemory(after, 4));
+
+    // The frame is posted while the first write is in flight: header and payload go out together after it
+    int writesComplete = 0;
+    auto countWrite = [&writesComplete]() {
+        writesComplete += 1;
+    };
+    client.asyncWrite(beforeSrc).then(countWrite);
+    framed.asyncWriteFrame(payloadSrc).then(countWrite);
+    client.asyncWrite(afterSrc).then(countWrite);
+
+    char rcv_buffer[14];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+    bool readComplete = false;
+    server.asyncRead(readBuffer)
+            .then([&readComplete]() {
+                readComplete = true;
+            });
+
+    iocontext.runFor(300);
+
+    ASSERT_EQ(3, writesComplete);
+    ASSERT_TRUE(readComplete);
+    ASSERT_EQ(0, memcmp(rcv_buffer, "AAAA\x00\x04" "BBBBCCCC", 14));
+    ASSERT_FALSE(payloadSrc.hasRemaining());
+}
@@ -0,0 +1,268 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/async/test_handlerAllocation.cpp
+ *
+ * Check that steady state async IO does not allocate memory for operation states.
+ *******************************************************************************/
+#include <cadence/async/pipe.hpp>
+#include <cadence/async/acceptor.hpp>
+#include <cadence/async/streamsocket.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+std::atomic<bool>           gCountAllocations{false};
+std::atomic<std::size_t>    gNbAllocations{0};
+
+}  // namespace
+
+
+// Replacement of the global allocation functions counting allocations made while counting is enabled.
+void* operator new(std::size_t size) {
+    if (gCountAllocations.load(std::memory_order_relaxed)) {
+        gNbAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+
+namespace {
+
+class AllocationCounter {
+public:
+    AllocationCounter() {
+        gNbAllocations.store(0);
+        gCountAllocations.store(true);
+    }
+
+    ~AllocationCounter() {
+        gCountAllocations.store(false);
+    }
+
+    std::size_t count() const {
+        return gNbAllocations.load();
+    }
+};
+
+
+/**
+ * Write a message and read it back from the same channel, round and round, using completion records.
+ */
+class RoundTrip {
+public:
+
+    RoundTrip(Channel& writeChannel, Channel& readChannel, int nbRounds)
+        : _writeChannel(writeChannel)
+        , _readChannel(readChannel)
+        , _nbRounds(nbRounds)
+    {}
+
+    void start() {
+        _src.rewind();
+        _dest.clear();
+        _writeChannel.asyncWrite(_src, _src.remaining(), _writeDone);
+        _readChannel.asyncRead(_dest, _src.remaining(), _readDone);
+    }
+
+    int roundsCompleted() const noexcept { return _roundsCompleted; }
+    bool failed() const noexcept { return _failed; }
+
+private:
+
+    static void onWrite(AsyncCompletion& self) {
+        auto& completion = static_cast<Completion&>(self);
+        completion.owner->_failed |= completion.isError();
+    }
+
+    static void onRead(AsyncCompletion& self) {
+        auto& completion = static_cast<Completion&>(self);
+        auto& owner = *completion.owner;
+        owner._failed |= completion.isError();
+
+        if (!owner._failed && ++owner._roundsCompleted < owner._nbRounds) {
+            owner.start();
+        }
+    }
+
+    struct Completion : public AsyncCompletion {
+        Completion(Callback callback, RoundTrip* self)
+            : AsyncCompletion(callback)
+            , owner(self)
+        {}
+
+        RoundTrip* owner;
+    };
+
+    Channel&    _writeChannel;
+    Channel&    _readChannel;
+    int const   _nbRounds;
+    int         _roundsCompleted{0};
+    bool        _failed{false};
+
+    char        _message[32] = "Ping!";
+    char        _buffer[32];
+    ByteReader  _src{wrapMemory(_message)};
+    ByteWriter  _dest{wrapMemory(_buffer)};
+
+    Completion  _writeDone{&RoundTrip::onWrite, this};
+    Completion  _readDone{&RoundTrip::onRead, this};
+};
+
+
+/**
+ * Same round trip using callback based operations: a completion record is created for each operation.
+ */
+class CallbackRoundTrip {
+public:
+
+    CallbackRoundTrip(Pipe& pipe, int nbRounds)
+        : _pipe(pipe)
+        , _nbRounds(nbRounds)
+    {}
+
+    void start() {
+        _src.rewind();
+        _dest.clear();
+        _pipe.asyncWrite(_src, _src.remaining(), [this](Result<void, Error>&& result) {
+            _failed |= result.isError();
+        });
+        _pipe.asyncRead(_dest, _src.remaining(), [this](Result<void, Error>&& result) {
+            _failed |= result.isError();
+            if (!_failed && ++_roundsCompleted < _nbRounds) {
+                start();
+            }
+        });
+    }
+
+    int roundsCompleted() const noexcept { return _roundsCompleted; }
+    bool failed() const noexcept { return _failed; }
+
+private:
+    Pipe&       _pipe;
+    int const   _nbRounds;
+    int         _roundsCompleted{0};
+    bool        _failed{false};
+
+    char        _message[32] = "Ping!";
+    char        _buffer[32];
+    ByteReader  _src{wrapMemory(_message)};
+    ByteWriter  _dest{wrapMemory(_buffer)};
+};
+
+}  // namespace
+
+
+TEST(TestHandlerAllocation, testPipeSteadyStateDoesNotAllocate) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    // Warm up: first operations may allocate blocks that are later recycled.
+    RoundTrip warmUp(iopipe, iopipe, 4);
+    warmUp.start();
+    iocontext.runFor(200);
+    ASSERT_EQ(4, warmUp.roundsCompleted());
+    iocontext.reset();
+
+    RoundTrip roundTrip(iopipe, iopipe, 100);
+    {
+        AllocationCounter counter;
+        roundTrip.start();
+        iocontext.runFor(500);
+
+        EXPECT_EQ(0U, counter.count());
+    }
+
+    ASSERT_FALSE(roundTrip.failed());
+    ASSERT_EQ(100, roundTrip.roundsCompleted());
+}
+
+
+TEST(TestHandlerAllocation, testSocketSteadyStateDoesNotAllocate) {
+    EventLoop iocontext;
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(IPEndpoint{IPAddress::any(), 0}).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    RoundTrip warmUp(client, server, 4);
+    warmUp.start();
+    iocontext.runFor(200);
+    ASSERT_EQ(4, warmUp.roundsCompleted());
+    iocontext.reset();
+
+    RoundTrip roundTrip(client, server, 100);
+    {
+        AllocationCounter counter;
+        roundTrip.start();
+        iocontext.runFor(500);
+
+        EXPECT_EQ(0U, counter.count());
+    }
+
+    ASSERT_FALSE(roundTrip.failed());
+    ASSERT_EQ(100, roundTrip.roundsCompleted());
+}
+
+
+TEST(TestHandlerAllocation, testCallbackSteadyStateDoesNotAllocate) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    // Warm up: completion records are recycled along with blocks of operation states.
+    CallbackRoundTrip warmUp(iopipe, 4);
+    warmUp.start();
+    iocontext.runFor(200);
+    ASSERT_EQ(4, warmUp.roundsCompleted());
+    iocontext.reset();
+
+    CallbackRoundTrip roundTrip(iopipe, 100);
+    {
+        AllocationCounter counter;
+        roundTrip.start();
+        iocontext.runFor(500);
+
+        EXPECT_EQ(0U, counter.count());
+    }
+
+    ASSERT_FALSE(roundTrip.failed());
+    ASSERT_EQ(100, roundTrip.roundsCompleted());
+}
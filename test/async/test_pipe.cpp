@@ -19,6 +19,10 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 
 using namespace Solace;
 using namespace cadence::async;
@@ -111,3 +115,227 @@ TEST(TestAsyncPipe, testAsyncReadWrite) {
     ASSERT_EQ(messageLen, messageBuffer.position());
     ASSERT_EQ(messageLen, readBuffer.position());
 }
+
+
+TEST(TestAsyncPipe, testAsyncReadWriteCallback) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    char message[] = "Hello there!";
+    auto const messageLen = strlen(message) + 1;
+    auto messageBuffer = ByteReader(wrapMemory(message));
+
+    char rcv_buffer[128];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+
+    bool readComplete = false;
+    bool writeComplete = false;
+
+    iopipe.asyncWrite(messageBuffer, messageLen, [&writeComplete](Result<void, Error>&& result) {
+        writeComplete = result.isOk();
+    });
+
+    // Callback overloads are also available through the base channel interface
+    Channel& channel = iopipe;
+    channel.asyncRead(readBuffer, messageLen, [&readComplete](Result<void, Error>&& result) {
+        readComplete = result.isOk();
+    });
+
+    iocontext.runFor(300);
+
+    ASSERT_TRUE(writeComplete);
+    ASSERT_TRUE(readComplete);
+
+    // Check that we read as much as was written
+    ASSERT_FALSE(messageBuffer.hasRemaining());
+    ASSERT_EQ(messageLen, messageBuffer.position());
+    ASSERT_EQ(messageLen, readBuffer.position());
+}
+
+
+TEST(TestAsyncPipe, testPendingCallbackIsDisposedOfWithPipeAndLoop) {
+    auto token = std::make_shared<int>(0);
+    bool called = false;
+
+    char rcv_buffer[16];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+
+    {
+        EventLoop iocontext;
+        Pipe iopipe(iocontext);
+
+        // Nothing is ever written: the read is still pending when the pipe and the loop are destroyed
+        iopipe.asyncRead(readBuffer, 4, [token, &called](Result<void, Error>&&) {
+            called = true;
+        });
+        ASSERT_EQ(2, token.use_count());
+    }
+
+    // Callable of the record is destroyed without being invoked
+    ASSERT_FALSE(called);
+    ASSERT_EQ(1, token.use_count());
+}
+
+
+TEST(TestAsyncPipe, testAsyncReadvWritev) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    char header[] = "head:";
+    char body[] = "body:";
+    char trailer[] = "end";
+    ByteReader srcs[] = {
+        ByteReader(wrapMemory(header, 5)),
+        ByteReader(wrapMemory(body, 5)),
+        ByteReader(wrapMemory(trailer, 3))
+    };
+
+    char first[7];
+    char second[6];
+    ByteWriter dests[] = {
+        ByteWriter(wrapMemory(first)),
+        ByteWriter(wrapMemory(second))
+    };
+
+    bool readComplete = false;
+    bool writeComplete = false;
+
+    iopipe.asyncWritev(arrayView(srcs)).then([&writeComplete]() {
+        writeComplete = true;
+    });
+
+    iopipe.asyncReadv(arrayView(dests)).then([&readComplete]() {
+        readComplete = true;
+    });
+
+    iocontext.runFor(300);
+
+    ASSERT_TRUE(writeComplete);
+    ASSERT_TRUE(readComplete);
+
+    // All source buffers are written, and data is scattered over destination buffers in order
+    for (auto const& src : srcs) {
+        ASSERT_FALSE(src.hasRemaining());
+    }
+    ASSERT_EQ(7U, dests[0].position());
+    ASSERT_EQ(6U, dests[1].position());
+    ASSERT_EQ(0, memcmp(first, "head:bo", 7));
+    ASSERT_EQ(0, memcmp(second, "dy:end", 6));
+}
+
+
+TEST(TestAsyncPipe, testAsyncReadvWritevLargerThanPipeCapacity) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    // Default pipe capacity is 64KiB: neither call can complete in a single system call
+    constexpr std::size_t kChunkSize = 96 * 1024;
+    std::vector<char> first(kChunkSize, 'a');
+    std::vector<char> second(kChunkSize, 'b');
+    ByteReader srcs[] = {
+        ByteReader(wrapMemory(first.data(), first.size())),
+        ByteReader(wrapMemory(second.data(), second.size()))
+    };
+
+    std::vector<char> received(2 * kChunkSize);
+    ByteWriter dests[] = {
+        ByteWriter(wrapMemory(received.data(), kChunkSize)),
+        ByteWriter(wrapMemory(received.data() + kChunkSize, kChunkSize))
+    };
+
+    bool readComplete = false;
+    bool writeComplete = false;
+
+    iopipe.asyncWritev(arrayView(srcs)).then([&writeComplete]() {
+        writeComplete = true;
+    });
+
+    iopipe.asyncReadv(arrayView(dests)).then([&readComplete]() {
+        readComplete = true;
+    });
+
+    iocontext.runFor(1000);
+
+    ASSERT_TRUE(writeComplete);
+    ASSERT_TRUE(readComplete);
+
+    ASSERT_FALSE(srcs[0].hasRemaining());
+    ASSERT_FALSE(srcs[1].hasRemaining());
+    ASSERT_FALSE(dests[0].hasRemaining());
+    ASSERT_FALSE(dests[1].hasRemaining());
+    ASSERT_TRUE(std::equal(first.begin(), first.end(), received.begin()));
+    ASSERT_TRUE(std::equal(second.begin(), second.end(), received.begin() + kChunkSize));
+}
+
+
+TEST(TestAsyncPipe, testReadvWritev) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    char header[] = "head:";
+    char body[] = "body";
+    ByteReader srcs[] = {
+        ByteReader(wrapMemory(header, 5)),
+        ByteReader(wrapMemory(body, 4))
+    };
+
+    char first[4];
+    char second[5];
+    ByteWriter dests[] = {
+        ByteWriter(wrapMemory(first)),
+        ByteWriter(wrapMemory(second))
+    };
+
+    ASSERT_TRUE(iopipe.writev(arrayView(srcs)).isOk());
+    ASSERT_TRUE(iopipe.readv(arrayView(dests)).isOk());
+
+    ASSERT_FALSE(dests[0].hasRemaining());
+    ASSERT_FALSE(dests[1].hasRemaining());
+    ASSERT_EQ(0, memcmp(first, "head", 4));
+    ASSERT_EQ(0, memcmp(second, ":body", 5));
+}
+
+
+TEST(TestAsyncPipe, testAsyncReadSome) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    char message[] = "Hello there!";
+    auto const messageLen = strlen(message) + 1;
+    auto messageBuffer = ByteReader(wrapMemory(message));
+
+    char rcv_buffer[128];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+
+    Pipe::size_type bytesRead = 0;
+
+    ASSERT_TRUE(iopipe.write(messageBuffer).isOk());
+    iopipe.asyncReadSome(readBuffer)
+            .then([&bytesRead](Pipe::size_type n) {
+                bytesRead = n;
+            });
+
+    iocontext.runFor(300);
+
+    // Read completes with what is available rather than waiting for the buffer to fill up
+    ASSERT_EQ(messageLen, bytesRead);
+    ASSERT_EQ(messageLen, readBuffer.position());
+}
+
+
+TEST(TestAsyncPipe, testReadSome) {
+    EventLoop iocontext;
+    Pipe iopipe(iocontext);
+
+    char message[] = "Hello there!";
+    auto messageBuffer = ByteReader(wrapMemory(message));
+    ASSERT_TRUE(iopipe.write(messageBuffer).isOk());
+
+    char rcv_buffer[5];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+
+    auto result = iopipe.readSome(readBuffer, 4);
+    ASSERT_TRUE(result.isOk());
+    ASSERT_EQ(4U, result.unwrap());
+    ASSERT_EQ(4U, readBuffer.position());
+}
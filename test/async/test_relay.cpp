@@ -0,0 +1,209 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/async/test_relay.cpp
+ *******************************************************************************/
+#include <cadence/async/relay.hpp>  // Class being tested
+#include <cadence/async/acceptor.hpp>
+#include <cadence/async/pipe.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <memory>
+#include <sys/socket.h>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+void writeMessage(Channel& channel, char const* message) {
+    auto src = ByteReader(wrapMemory(message, strlen(message)));
+    ASSERT_TRUE(channel.write(src).isOk());
+}
+
+void shutdownWrite(Channel& channel) {
+    ::shutdown(channel.getNativeHandles().writeHandle, SHUT_WR);
+}
+
+}  // namespace
+
+
+TEST(TestRelay, testTcpRelayForwardsBothWaysAndPropagatesHalfClose) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(IPEndpoint{IPAddress::any(), 0}).isOk());
+
+    // client -> [proxyIn | relay | proxyOut] -> upstream
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+    auto maybeProxyIn = acceptor.accept();
+    ASSERT_TRUE(maybeProxyIn.isOk());
+    auto proxyIn = maybeProxyIn.moveResult();
+
+    auto proxyOut = createTCPSocket(iocontext);
+    ASSERT_TRUE(proxyOut.connect(acceptor.getLocalEndpoint()).isOk());
+    auto maybeUpstream = acceptor.accept();
+    ASSERT_TRUE(maybeUpstream.isOk());
+    auto upstream = maybeUpstream.moveResult();
+
+    Relay relay(iocontext, proxyIn, proxyOut, 4096);
+
+    bool relayComplete = false;
+    relay.asyncRun()
+            .then([&relayComplete]() {
+                relayComplete = true;
+            });
+
+    writeMessage(client, "request");
+    shutdownWrite(client);
+    writeMessage(upstream, "response!");
+    shutdownWrite(upstream);
+
+    iocontext.runFor(500);
+
+    ASSERT_TRUE(relayComplete);
+    ASSERT_EQ(7U, relay.getCounters().aToB);
+    ASSERT_EQ(9U, relay.getCounters().bToA);
+
+    char buffer[32];
+    auto upstreamBuffer = ByteWriter(wrapMemory(buffer));
+    auto received = upstream.readSome(upstreamBuffer, sizeof(buffer));
+    ASSERT_TRUE(received.isOk());
+    ASSERT_EQ(7U, received.unwrap());
+    ASSERT_EQ(0, memcmp(buffer, "request", 7));
+    ASSERT_TRUE(upstream.readSome(upstreamBuffer, sizeof(buffer)).isError());  // Half-close reached upstream
+
+    auto clientBuffer = ByteWriter(wrapMemory(buffer));
+    received = client.readSome(clientBuffer, sizeof(buffer));
+    ASSERT_TRUE(received.isOk());
+    ASSERT_EQ(9U, received.unwrap());
+    ASSERT_EQ(0, memcmp(buffer, "response!", 9));
+}
+
+
+TEST(TestRelay, testRelayBetweenSocketAndPipe) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(IPEndpoint{IPAddress::any(), 0}).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    // Data written to the socket loops back through the pipe
+    Pipe loopback(iocontext);
+    Relay relay(iocontext, server, loopback);
+    relay.asyncRun()
+            .onError([](Error&&) {});
+
+    writeMessage(client, "echo");
+
+    char buffer[4];
+    auto reader = ByteWriter(wrapMemory(buffer));
+    bool readComplete = false;
+    client.asyncRead(reader)
+            .then([&readComplete]() {
+                readComplete = true;
+            });
+
+    iocontext.runFor(300);
+    relay.cancel();
+
+    ASSERT_TRUE(readComplete);
+    ASSERT_EQ(0, memcmp(buffer, "echo", 4));
+    ASSERT_EQ(4U, relay.getCounters().aToB);
+    ASSERT_EQ(4U, relay.getCounters().bToA);
+}
+
+
+TEST(TestRelay, testHalfClosePropagatesThroughPipe) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(IPEndpoint{IPAddress::any(), 0}).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    // End of stream written into the pipe must reach its reader to be forwarded back to the client
+    Pipe loopback(iocontext);
+    Relay relay(iocontext, server, loopback);
+
+    bool relayComplete = false;
+    relay.asyncRun()
+            .then([&relayComplete]() {
+                relayComplete = true;
+            });
+
+    writeMessage(client, "echo");
+    shutdownWrite(client);
+
+    iocontext.runFor(500);
+
+    ASSERT_TRUE(relayComplete);
+    ASSERT_EQ(4U, relay.getCounters().aToB);
+    ASSERT_EQ(4U, relay.getCounters().bToA);
+
+    char buffer[8];
+    auto clientBuffer = ByteWriter(wrapMemory(buffer));
+    auto received = client.readSome(clientBuffer, sizeof(buffer));
+    ASSERT_TRUE(received.isOk());
+    ASSERT_EQ(4U, received.unwrap());
+    ASSERT_EQ(0, memcmp(buffer, "echo", 4));
+    ASSERT_TRUE(client.readSome(clientBuffer, sizeof(buffer)).isError());  // Half-close came back through the pipe
+}
+
+
+TEST(TestRelay, testDestroyRunningRelay) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(IPEndpoint{IPAddress::any(), 0}).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    Pipe loopback(iocontext);
+    auto relay = std::make_unique<Relay>(iocontext, server, loopback);
+    relay->asyncRun()
+            .onError([](Error&&) {});
+
+    // Relay waits for data in both directions
+    iocontext.runFor(50);
+    relay.reset();
+
+    // Waits aborted by destruction of the relay complete without it
+    iocontext.runFor(50);
+
+    ASSERT_TRUE(server.isOpen());
+    writeMessage(client, "ping");
+
+    char buffer[4];
+    auto reader = ByteWriter(wrapMemory(buffer));
+    ASSERT_TRUE(server.read(reader).isOk());
+    ASSERT_EQ(0, memcmp(buffer, "ping", 4));
+}
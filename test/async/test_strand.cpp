@@ -0,0 +1,105 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/async/test_strand.cpp
+ *******************************************************************************/
+#include <cadence/async/strand.hpp>  // Class being tested
+#include <cadence/async/pipe.hpp>
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+
+using namespace Solace;
+using namespace cadence::async;
+using namespace std::chrono_literals;
+
+
+TEST(TestStrand, testPostedTasksDoNotRunConcurrently) {
+    EventLoop iocontext;
+    Strand strand(iocontext);
+
+    constexpr int kNbTasks = 200;
+    std::atomic<int> nbConcurrent{0};
+    std::atomic<bool> overlapDetected{false};
+    int nbTimesCalled = 0;  // Intentionally not atomic: guarded by the strand
+
+    for (int i = 0; i < kNbTasks; ++i) {
+        strand.post([&]() {
+            if (nbConcurrent.fetch_add(1) != 0) {
+                overlapDetected = true;
+            }
+
+            ASSERT_TRUE(strand.isRunningInThisThread());
+            std::this_thread::sleep_for(50us);
+            nbTimesCalled += 1;
+
+            nbConcurrent.fetch_sub(1);
+        });
+    }
+
+    iocontext.run(4);
+
+    ASSERT_FALSE(overlapDetected.load());
+    ASSERT_EQ(kNbTasks, nbTimesCalled);
+}
+
+
+TEST(TestStrand, testDispatchRunsInlineInsideStrand) {
+    EventLoop iocontext;
+    Strand strand(iocontext);
+
+    std::vector<int> order;
+    strand.post([&]() {
+        strand.dispatch([&order]() { order.push_back(1); });
+        order.push_back(2);
+    });
+
+    ASSERT_FALSE(strand.isRunningInThisThread());
+    iocontext.run();
+
+    ASSERT_EQ((std::vector<int>{1, 2}), order);
+}
+
+
+TEST(TestStrand, testChannelCompletionsRunInStrand) {
+    EventLoop iocontext;
+    Strand strand(iocontext);
+    Pipe iopipe(iocontext);
+    iopipe.bindTo(strand);
+
+    char message[] = "Hello there!";
+    auto messageBuffer = ByteReader(wrapMemory(message));
+
+    char rcv_buffer[128];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+
+    bool writeCompletedInStrand = false;
+    bool readCompletedInStrand = false;
+
+    iopipe.asyncWrite(messageBuffer).then([&]() {
+        writeCompletedInStrand = strand.isRunningInThisThread();
+    });
+
+    iopipe.asyncRead(readBuffer, messageBuffer.limit()).then([&]() {
+        readCompletedInStrand = strand.isRunningInThisThread();
+    });
+
+    iocontext.runFor(2, 300);
+
+    ASSERT_TRUE(writeCompletedInStrand);
+    ASSERT_TRUE(readCompletedInStrand);
+    ASSERT_EQ(messageBuffer.limit(), readBuffer.position());
+}
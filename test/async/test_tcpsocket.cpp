@@ -15,13 +15,19 @@
  *******************************************************************************/
 #include <cadence/async/streamsocket.hpp>  // Class being tested
 #include <cadence/async/acceptor.hpp>
+#include <cadence/io/file.hpp>
 
 
 #include <solace/output_utils.hpp>
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
 #include <thread>
+#include <vector>
 #include <unistd.h>
 #include <fcntl.h>
 
@@ -33,6 +39,21 @@ IPEndpoint anyIPEndpoint() {
     return IPEndpoint{IPAddress::any(), 0};
 }
 
+struct RecordingCompletion : public AcceptCompletion {
+    RecordingCompletion()
+        : AcceptCompletion(&RecordingCompletion::onComplete)
+    {}
+
+    static void onComplete(AsyncCompletion& self) {
+        auto& record = static_cast<RecordingCompletion&>(self);
+        record.timesCalled += 1;
+        record.errorCode = record.getErrorCode();
+    }
+
+    int timesCalled{0};
+    int errorCode{0};
+};
+
 TEST(TestTcpSocket, testAsyncConnect) {
     EventLoop iocontext;
 
@@ -176,3 +197,565 @@ TEST(TestTcpSocket, testAsyncReadWrite) {
     ASSERT_EQ(messageLen, messageBuffer.position());
     ASSERT_EQ(messageLen, readBuffer.position());
 }
+
+
+TEST(TestTcpSocket, testAsyncWritevReadv) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    char header[] = "HDR";
+    char body[] = "payload";
+    char trailer[] = "!";
+    ByteReader srcs[] = {
+        ByteReader(wrapMemory(header, 3)),
+        ByteReader(wrapMemory(body, 7)),
+        ByteReader(wrapMemory(trailer, 1))
+    };
+
+    char frameHeader[3];
+    char frameBody[8];
+    ByteWriter dests[] = {
+        ByteWriter(wrapMemory(frameHeader)),
+        ByteWriter(wrapMemory(frameBody))
+    };
+
+    bool readComplete = false;
+    bool writeComplete = false;
+
+    client.asyncWritev(arrayView(srcs))
+            .then([&writeComplete]() {
+                writeComplete = true;
+            });
+
+    server.asyncReadv(arrayView(dests))
+            .then([&readComplete]() {
+                readComplete = true;
+            });
+
+    iocontext.runFor(600);
+
+    ASSERT_TRUE(writeComplete);
+    ASSERT_TRUE(readComplete);
+
+    ASSERT_FALSE(dests[0].hasRemaining());
+    ASSERT_FALSE(dests[1].hasRemaining());
+    ASSERT_EQ(0, memcmp(frameHeader, "HDR", 3));
+    ASSERT_EQ(0, memcmp(frameBody, "payload!", 8));
+}
+
+
+TEST(TestTcpSocket, testAsyncReadSome) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    char message[] = "Hello there!";
+    auto const messageLen = strlen(message) + 1;
+    auto messageBuffer = ByteReader(wrapMemory(message));
+
+    char rcv_buffer[128];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+
+    StreamSocket::size_type bytesRead = 0;
+    server.asyncReadSome(readBuffer)
+            .then([&bytesRead](StreamSocket::size_type n) {
+                bytesRead = n;
+            });
+
+    ASSERT_TRUE(client.write(messageBuffer).isOk());
+    iocontext.runFor(600);
+
+    // Unlike asyncRead, the read completes without waiting for the whole buffer to fill up
+    ASSERT_EQ(messageLen, bytesRead);
+    ASSERT_EQ(messageLen, readBuffer.position());
+}
+
+
+TEST(TestTcpSocket, testConcurrentAsyncWritesAreQueued) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    char first[] = "one,";
+    char second[] = "two,";
+    char third[] = "three";
+    ByteReader srcs[] = {
+        ByteReader(wrapMemory(first, 4)),
+        ByteReader(wrapMemory(second, 4)),
+        ByteReader(wrapMemory(third, 5))
+    };
+
+    // All writes are posted before any of them had a chance to complete
+    int writesComplete = 0;
+    for (auto& src : srcs) {
+        client.asyncWrite(src)
+                .then([&writesComplete]() {
+                    writesComplete += 1;
+                });
+    }
+
+    // A write posted from a completion is queued behind the ones in flight
+    char last[] = "!";
+    auto lastSrc = ByteReader(wrapMemory(last, 1));
+    client.asyncWrite(srcs[0], 0, [&client, &lastSrc, &writesComplete](Result<void, Error>&& result) {
+        ASSERT_TRUE(result.isOk());
+        client.asyncWrite(lastSrc)
+                .then([&writesComplete]() {
+                    writesComplete += 1;
+                });
+    });
+
+    char rcv_buffer[14];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+    bool readComplete = false;
+    server.asyncRead(readBuffer)
+            .then([&readComplete]() {
+                readComplete = true;
+            });
+
+    iocontext.runFor(600);
+
+    ASSERT_EQ(4, writesComplete);
+    ASSERT_TRUE(readComplete);
+    ASSERT_EQ(0, memcmp(rcv_buffer, "one,two,three!", 14));
+    for (auto const& src : srcs) {
+        ASSERT_FALSE(src.hasRemaining());
+    }
+}
+
+
+TEST(TestTcpSocket, testDestroyWithWritesInFlight) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+
+    // Far more than socket buffers hold: the peer never reads, so the flush stays in flight
+    std::vector<char> payload(32 * 1024 * 1024, 'x');
+    auto bigSrc = ByteReader(wrapMemory(payload.data(), payload.size()));
+    char last[] = "!";
+    auto lastSrc = ByteReader(wrapMemory(last, 1));
+
+    int errors = 0;
+    auto onWrite = [&errors](Result<void, Error>&& result) {
+        errors += result.isError() ? 1 : 0;
+    };
+
+    {
+        auto client = createTCPSocket(iocontext);
+        ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+        auto maybeServer = acceptor.accept();
+        ASSERT_TRUE(maybeServer.isOk());
+
+        client.asyncWrite(bigSrc, bigSrc.remaining(), onWrite);
+        client.asyncWrite(lastSrc, lastSrc.remaining(), onWrite);
+
+        iocontext.runFor(50);
+        iocontext.reset();
+        ASSERT_EQ(0, errors);
+    }
+
+    // Both writes are failed by the destroyed socket and its aborted flush is ignored
+    ASSERT_EQ(2, errors);
+    iocontext.runFor(50);
+    ASSERT_EQ(2, errors);
+}
+
+
+TEST(TestTcpSocket, testCloseFailsWritesWithDeadline) {
+    using namespace std::chrono_literals;
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+
+    // Peer never reads: the big write stays in flight and the one with deadline stays queued
+    std::vector<char> payload(32 * 1024 * 1024, 'x');
+    auto bigSrc = ByteReader(wrapMemory(payload.data(), payload.size()));
+    char last[] = "!";
+    auto lastSrc = ByteReader(wrapMemory(last, 1));
+
+    RecordingCompletion bigDone;
+    RecordingCompletion lastDone;
+    {
+        auto client = createTCPSocket(iocontext);
+        ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+        auto maybeServer = acceptor.accept();
+        ASSERT_TRUE(maybeServer.isOk());
+
+        client.asyncWrite(bigSrc, bigSrc.remaining(), bigDone);
+        client.asyncWrite(lastSrc, lastSrc.remaining(), deadlineAfter(100ms), lastDone);
+
+        iocontext.runFor(20);
+        iocontext.reset();
+        ASSERT_EQ(0, bigDone.timesCalled);
+        ASSERT_EQ(0, lastDone.timesCalled);
+
+        client.close();
+        ASSERT_EQ(1, bigDone.timesCalled);
+        ASSERT_EQ(ECANCELED, bigDone.errorCode);
+        ASSERT_EQ(1, lastDone.timesCalled);
+        ASSERT_EQ(ECANCELED, lastDone.errorCode);
+    }
+
+    // Deadline passes once the socket is gone: the disarmed guard does not call into it
+    iocontext.runFor(200);
+    ASSERT_EQ(1, bigDone.timesCalled);
+    ASSERT_EQ(1, lastDone.timesCalled);
+}
+
+
+TEST(TestTcpSocket, testSocketOptions) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.setOption(KeepAlive{}, true).isError());  // Not open yet
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+    ASSERT_TRUE(acceptor.setOption(ReceiveBufferSize{}, 64 * 1024).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+    ASSERT_TRUE(client.setOption(NoDelay{}, true).isOk());
+    auto noDelay = client.getOption(NoDelay{});
+    ASSERT_TRUE(noDelay.isOk());
+    ASSERT_TRUE(noDelay.unwrap());
+
+    ASSERT_TRUE(client.setOption(KeepAlive{}, true).isOk());
+    ASSERT_TRUE(client.setOption(SendBufferSize{}, 256 * 1024).isOk());
+
+    // Kernel may adjust buffer size, but not below the one requested
+    auto sendBufferSize = client.getOption(SendBufferSize{});
+    ASSERT_TRUE(sendBufferSize.isOk());
+    ASSERT_LE(256 * 1024, sendBufferSize.unwrap());
+}
+
+
+TEST(TestTcpSocket, testZeroCopyWrite) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    if (!client.setZeroCopyThreshold(64 * 1024)) {
+        return;  // Zero-copy sends are not supported by the platform
+    }
+
+    std::vector<byte> payload(1024 * 1024);
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<byte>(i);
+    }
+
+    std::vector<byte> received(payload.size());
+    auto src = ByteReader(wrapMemory(payload.data(), payload.size()));
+    auto dest = ByteWriter(wrapMemory(received.data(), received.size()));
+
+    bool writeComplete = false;
+    client.asyncWrite(src)
+            .then([&writeComplete]() {
+                writeComplete = true;
+            });
+
+    bool readComplete = false;
+    server.asyncRead(dest)
+            .then([&readComplete]() {
+                readComplete = true;
+            });
+
+    iocontext.runFor(2000);
+
+    ASSERT_TRUE(writeComplete);
+    ASSERT_TRUE(readComplete);
+    ASSERT_FALSE(src.hasRemaining());
+    ASSERT_EQ(payload, received);
+
+    // Data went out via zero-copy sends and the write completed only once all of them have been released
+    auto const stats = client.getZeroCopyStats();
+    EXPECT_LT(0U, stats.sends);
+    EXPECT_EQ(stats.sends, stats.released);
+    EXPECT_LE(stats.copied, stats.released);
+}
+
+
+TEST(TestTcpSocket, testZeroCopyWritesArePipelined) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    if (!client.setZeroCopyThreshold(64 * 1024)) {
+        return;  // Zero-copy sends are not supported by the platform
+    }
+
+    std::vector<byte> payload(3 * 256 * 1024);
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<byte>(i * 3);
+    }
+
+    // Each write is posted before the previous one has been released by the kernel
+    std::vector<int> completed;
+    ByteReader srcs[] = {
+        ByteReader(wrapMemory(payload.data(), 256 * 1024)),
+        ByteReader(wrapMemory(payload.data() + 256 * 1024, 256 * 1024)),
+        ByteReader(wrapMemory(payload.data() + 512 * 1024, 256 * 1024))
+    };
+    for (int i = 0; i < 3; ++i) {
+        client.asyncWrite(srcs[i])
+                .then([&completed, i]() {
+                    completed.push_back(i);
+                });
+    }
+
+    std::vector<byte> received(payload.size());
+    auto dest = ByteWriter(wrapMemory(received.data(), received.size()));
+    bool readComplete = false;
+    server.asyncRead(dest)
+            .then([&readComplete]() {
+                readComplete = true;
+            });
+
+    iocontext.runFor(2000);
+
+    ASSERT_TRUE(readComplete);
+    ASSERT_EQ(payload, received);
+    ASSERT_EQ((std::vector<int>{0, 1, 2}), completed);
+
+    auto const stats = client.getZeroCopyStats();
+    EXPECT_LT(0U, stats.sends);
+    EXPECT_EQ(stats.sends, stats.released);
+}
+
+
+TEST(TestTcpSocket, testAsyncSendFile) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    // Large enough for the transfer to wait for the socket to become writable
+    std::vector<byte> content(4 * 1024 * 1024);
+    for (std::size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<byte>(i * 7);
+    }
+
+    char filename[] = "/tmp/cadence-sendfile-XXXXXX";
+    auto file = File::fromFd(mkstemp(filename));
+    unlink(filename);
+    ASSERT_EQ(static_cast<ssize_t>(content.size()), ::write(file.getSelectId(), content.data(), content.size()));
+
+    uint64 const offset = 100;
+    uint64 const length = content.size() - offset;
+
+    uint64 lastProgress = 0;
+    uint64 bytesSent = 0;
+    client.asyncSendFile(file, offset, length, [&lastProgress](uint64 sent) {
+                ASSERT_LT(lastProgress, sent);
+                lastProgress = sent;
+            })
+            .then([&bytesSent](uint64 sent) {
+                bytesSent = sent;
+            });
+
+    std::vector<byte> received(length);
+    auto dest = ByteWriter(wrapMemory(received.data(), received.size()));
+    bool readComplete = false;
+    server.asyncRead(dest)
+            .then([&readComplete]() {
+                readComplete = true;
+            });
+
+    iocontext.runFor(2000);
+
+    ASSERT_TRUE(readComplete);
+    ASSERT_EQ(length, bytesSent);
+    ASSERT_EQ(length, lastProgress);
+    ASSERT_TRUE(std::equal(received.begin(), received.end(), content.begin() + offset));
+}
+
+
+TEST(TestTcpSocket, testReadDeadlineCancelsOnlyThatRead) {
+    using namespace std::chrono_literals;
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+
+    auto maybeServer = acceptor.accept();
+    ASSERT_TRUE(maybeServer.isOk());
+    auto server = maybeServer.moveResult();
+
+    char rcv_buffer[16];
+    auto readBuffer = ByteWriter(wrapMemory(rcv_buffer));
+
+    char message[] = "Hello there!";
+    auto messageBuffer = ByteReader(wrapMemory(message));
+
+    // Client never sends anything, so the read expires. A write without deadline in flight is not affected.
+    RecordingCompletion readDone;
+    RecordingCompletion writeDone;
+    server.asyncRead(readBuffer, 4, deadlineAfter(50ms), readDone);
+    server.asyncWrite(messageBuffer, messageBuffer.remaining(), writeDone);
+
+    iocontext.runFor(300);
+
+    ASSERT_EQ(1, readDone.timesCalled);
+    ASSERT_EQ(ETIMEDOUT, readDone.errorCode);
+    ASSERT_EQ(0U, readBuffer.position());
+    ASSERT_EQ(1, writeDone.timesCalled);
+    ASSERT_EQ(0, writeDone.errorCode);
+
+    // Socket is still usable after the deadline expired
+    auto pingBuffer = ByteReader(wrapMemory(message, 4));
+    ASSERT_TRUE(client.write(pingBuffer).isOk());
+
+    bool readComplete = false;
+    server.asyncRead(readBuffer, 4, deadlineAfter(1s))
+            .then([&readComplete]() {
+                readComplete = true;
+            });
+
+    iocontext.runFor(300);
+    ASSERT_TRUE(readComplete);
+    ASSERT_EQ(4U, readBuffer.position());
+}
+
+
+TEST(TestTcpSocket, testAcceptDeadline) {
+    using namespace std::chrono_literals;
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+
+    RecordingCompletion acceptDone;
+    acceptor.asyncAccept(deadlineAfter(50ms), acceptDone);
+
+    iocontext.runFor(300);
+    ASSERT_EQ(1, acceptDone.timesCalled);
+    ASSERT_EQ(ETIMEDOUT, acceptDone.errorCode);
+    ASSERT_FALSE(acceptDone.socket.has_value());
+
+    // Acceptor keeps accepting connections that arrive in time
+    bool accepted = false;
+    acceptor.asyncAccept(deadlineAfter(1s))
+            .then([&accepted](StreamSocket&&) {
+                accepted = true;
+            });
+
+    auto client = createTCPSocket(iocontext);
+    bool connected = false;
+    client.asyncConnect(acceptor.getLocalEndpoint(), deadlineAfter(1s))
+            .then([&connected]() {
+                connected = true;
+            });
+
+    iocontext.runFor(300);
+    ASSERT_TRUE(accepted);
+    ASSERT_TRUE(connected);
+}
+
+
+TEST(TestTcpSocket, testReusePortAcceptors) {
+    EventLoop iocontext;
+
+    ListenOptions options;
+    options.backlog = 512;
+    options.reusePort = true;
+
+    Acceptor first(iocontext);
+    ASSERT_TRUE(first.open(IPEndpoint{IPAddress::loopback(), 0}, options).isOk());
+
+    // Second acceptor shares the port only if both opt in
+    Acceptor second(iocontext);
+    ASSERT_TRUE(second.open(first.getLocalEndpoint(), options).isOk());
+
+    Acceptor exclusive(iocontext);
+    ASSERT_TRUE(exclusive.open(first.getLocalEndpoint()).isError());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(first.getLocalEndpoint()).isOk());
+}
+
+
+TEST(TestTcpSocket, testAcceptBatchDrainsPendingConnections) {
+    EventLoop iocontext;
+
+    Acceptor acceptor(iocontext);
+    ASSERT_TRUE(acceptor.open(anyIPEndpoint()).isOk());
+
+    // Connections complete the handshake and wait in the listen queue until accepted
+    std::vector<StreamSocket> clients;
+    for (int i = 0; i < 3; ++i) {
+        auto& client = clients.emplace_back(createTCPSocket(iocontext));
+        ASSERT_TRUE(client.connect(acceptor.getLocalEndpoint()).isOk());
+    }
+
+    std::vector<StreamSocket> accepted;
+    acceptor.asyncAcceptBatch(2)
+            .then([&accepted](std::vector<StreamSocket>&& sockets) {
+                accepted = std::move(sockets);
+            });
+
+    iocontext.runFor(300);
+    ASSERT_EQ(2U, accepted.size());
+
+    // Connection left over from the first batch is accepted by the next one
+    AcceptBatchCompletion batchDone{[](AsyncCompletion&) {}};
+    acceptor.asyncAcceptBatch(16, batchDone);
+
+    iocontext.runFor(300);
+    ASSERT_EQ(0, batchDone.getErrorCode());
+    ASSERT_EQ(1U, batchDone.getValue());
+    ASSERT_EQ(1U, batchDone.sockets.size());
+}
@@ -0,0 +1,371 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/test_asyncServer.cpp
+ *******************************************************************************/
+#include <cadence/asyncServer.hpp>  // Class being tested
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+/**
+ * Lowers the limit of open descriptors of the process and uses them up, restoring both once destroyed.
+ */
+class DescriptorLimit {
+public:
+
+    ~DescriptorLimit() {
+        restore();
+    }
+
+    DescriptorLimit() {
+        ::getrlimit(RLIMIT_NOFILE, &_saved);
+    }
+
+    /**
+     * Open descriptors until the process runs out of them under a lowered limit.
+     * @return True if the process is out of descriptors.
+     */
+    bool exhaust() {
+        auto const lowest = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (lowest < 0) {
+            return false;
+        }
+        _fillers.push_back(lowest);
+
+        rlimit lowered = _saved;
+        lowered.rlim_cur = std::min<rlim_t>(_saved.rlim_cur, static_cast<rlim_t>(lowest) + 64);
+        if (::setrlimit(RLIMIT_NOFILE, &lowered) != 0) {
+            return false;
+        }
+        _lowered = true;
+
+        for (;;) {
+            auto const handle = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+            if (handle < 0) {
+                return (errno == EMFILE);
+            }
+
+            _fillers.push_back(handle);
+        }
+    }
+
+    /** Close the given number of descriptors opened by `exhaust()`. */
+    void release(std::size_t count) {
+        for (; count > 0 && !_fillers.empty(); --count) {
+            ::close(_fillers.back());
+            _fillers.pop_back();
+        }
+    }
+
+    void restore() {
+        release(_fillers.size());
+
+        if (_lowered) {
+            ::setrlimit(RLIMIT_NOFILE, &_saved);
+            _lowered = false;
+        }
+    }
+
+private:
+    rlimit              _saved{};
+    bool                _lowered{false};
+    std::vector<int>    _fillers;
+};
+
+}  // namespace
+
+
+TEST(TestAsyncServer, testPlainHandlerIsCalledForEachConnection) {
+    EventLoop iocontext;
+
+    std::vector<StreamSocket> sessions;
+    AsyncServer server(iocontext, [&sessions](StreamSocket&& socket) {
+        sessions.emplace_back(std::move(socket));
+    });
+    ASSERT_TRUE(server.startListen(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+
+    std::vector<StreamSocket> clients;
+    for (int i = 0; i < 3; ++i) {
+        auto& client = clients.emplace_back(createTCPSocket(iocontext));
+        ASSERT_TRUE(client.connect(server.getLocalEndpoint()).isOk());
+    }
+
+    iocontext.runFor(300);
+    ASSERT_EQ(3U, sessions.size());
+
+    // Sessions of a plain handler are not tracked once it returns
+    ASSERT_EQ(0U, server.getActiveSessions());
+    server.stop();
+}
+
+
+TEST(TestAsyncServer, testServerThatNeverListenedCanBeDestroyed) {
+    EventLoop iocontext;
+
+    {
+        AsyncServer server(iocontext, [](StreamSocket&&) {});
+        server.stop();
+    }
+
+    AsyncServer server(iocontext, [](StreamSocket&&) {});
+    ASSERT_EQ(0U, server.getActiveSessions());
+}
+
+
+TEST(TestAsyncServer, testMovedServerKeepsAccepting) {
+    EventLoop iocontext;
+
+    std::vector<StreamSocket> sessions;
+    AsyncServer server(iocontext, [&sessions](StreamSocket&& socket) {
+        sessions.emplace_back(std::move(socket));
+    });
+    ASSERT_TRUE(server.startListen(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+
+    auto movedServer = std::move(server);
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(movedServer.getLocalEndpoint()).isOk());
+
+    iocontext.runFor(300);
+    ASSERT_EQ(1U, sessions.size());
+
+    // Server moved into stops accepting on its own
+    AsyncServer otherServer(iocontext, [](StreamSocket&&) {});
+    ASSERT_TRUE(otherServer.startListen(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+    auto const endpoint = otherServer.getLocalEndpoint();
+
+    otherServer = std::move(movedServer);
+    iocontext.runFor(50);
+
+    auto lateClient = createTCPSocket(iocontext);
+    ASSERT_TRUE(lateClient.connect(endpoint).isError());
+}
+
+
+TEST(TestAsyncServer, testAcceptingPausesAtSessionLimit) {
+    EventLoop iocontext;
+
+    std::vector<AsyncServer::SessionTicket> tickets;
+    AsyncServer server(iocontext, [&tickets](StreamSocket&&, AsyncServer::SessionTicket&& ticket) {
+        tickets.emplace_back(std::move(ticket));
+    });
+    server.setMaxSessions(2);
+    ASSERT_TRUE(server.startListen(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+
+    std::vector<StreamSocket> clients;
+    for (int i = 0; i < 3; ++i) {
+        auto& client = clients.emplace_back(createTCPSocket(iocontext));
+        ASSERT_TRUE(client.connect(server.getLocalEndpoint()).isOk());
+    }
+
+    iocontext.runFor(300);
+    ASSERT_EQ(2U, tickets.size());
+    ASSERT_EQ(2U, server.getActiveSessions());
+
+    // Closing a session resumes accepting
+    tickets.front().release();
+    ASSERT_EQ(1U, server.getActiveSessions());
+
+    iocontext.runFor(300);
+    ASSERT_EQ(3U, tickets.size());
+    ASSERT_EQ(2U, server.getActiveSessions());
+
+    server.stop();
+}
+
+
+TEST(TestAsyncServer, testDrainCancelsSessionsStillOpenByDeadline) {
+    using namespace std::chrono_literals;
+    EventLoop iocontext;
+
+    struct Session {
+        StreamSocket                socket;
+        AsyncServer::SessionTicket  ticket;
+    };
+
+    std::vector<Session> sessions;
+    AsyncServer server(iocontext, [&sessions](StreamSocket&& socket, AsyncServer::SessionTicket&& ticket) {
+        sessions.push_back({std::move(socket), std::move(ticket)});
+    });
+    ASSERT_TRUE(server.startListen(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+
+    std::vector<StreamSocket> clients;
+    for (int i = 0; i < 2; ++i) {
+        auto& client = clients.emplace_back(createTCPSocket(iocontext));
+        ASSERT_TRUE(client.connect(server.getLocalEndpoint()).isOk());
+    }
+
+    iocontext.runFor(300);
+    ASSERT_EQ(2U, sessions.size());
+    ASSERT_EQ(2U, server.getSessionCounters().accepted);
+    ASSERT_EQ(2U, server.getSessionCounters().active);
+
+    // Second session waits for a request that never comes
+    byte buffer[1];
+    auto writer = ByteWriter(wrapMemory(buffer));
+    sessions[1].socket.asyncRead(writer)
+            .onError([&sessions](Error&&) {
+                sessions[1].ticket.release();
+            });
+
+    bool drained = false;
+    server.drain(deadlineAfter(100ms))
+            .then([&drained]() {
+                drained = true;
+            });
+
+    ASSERT_TRUE(sessions[0].ticket.isDraining());
+    ASSERT_FALSE(drained);
+
+    // Server drains once
+    bool drainRejected = false;
+    server.drain(deadlineAfter(100ms))
+            .onError([&drainRejected](Error&&) {
+                drainRejected = true;
+            });
+    ASSERT_TRUE(drainRejected);
+
+    // Idle session closes on its own
+    sessions[0].ticket.release();
+    ASSERT_EQ(1U, server.getActiveSessions());
+    ASSERT_FALSE(drained);
+
+    // The other one is cancelled at the deadline
+    iocontext.runFor(500);
+    ASSERT_TRUE(drained);
+
+    auto const counters = server.getSessionCounters();
+    ASSERT_EQ(2U, counters.accepted);
+    ASSERT_EQ(2U, counters.closed);
+    ASSERT_EQ(0U, counters.active);
+}
+
+
+TEST(TestAsyncServer, testDrainLeavesClosedSessionSocketsAlone) {
+    using namespace std::chrono_literals;
+    EventLoop iocontext;
+
+    // Session closes its socket but holds on to the ticket
+    std::vector<AsyncServer::SessionTicket> tickets;
+    AsyncServer server(iocontext, [&tickets](StreamSocket&& socket, AsyncServer::SessionTicket&& ticket) {
+        socket.close();
+        tickets.emplace_back(std::move(ticket));
+    });
+    ASSERT_TRUE(server.startListen(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+
+    auto client = createTCPSocket(iocontext);
+    ASSERT_TRUE(client.connect(server.getLocalEndpoint()).isOk());
+    iocontext.runFor(300);
+    ASSERT_EQ(1U, tickets.size());
+
+    // Descriptor of the closed session socket is likely to be reused by this connection
+    Acceptor otherAcceptor(iocontext);
+    ASSERT_TRUE(otherAcceptor.open(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+    auto otherClient = createTCPSocket(iocontext);
+    ASSERT_TRUE(otherClient.connect(otherAcceptor.getLocalEndpoint()).isOk());
+    auto maybeOtherServer = otherAcceptor.accept();
+    ASSERT_TRUE(maybeOtherServer.isOk());
+    auto otherServer = maybeOtherServer.moveResult();
+
+    server.drain(deadlineAfter(50ms))
+            .onError([](Error&&) {});
+    iocontext.runFor(200);
+
+    // Cancelling the session did not shut down whatever reused its descriptor
+    char message[] = "ok";
+    auto src = ByteReader(wrapMemory(message, 2));
+    ASSERT_TRUE(otherClient.write(src).isOk());
+
+    char buffer[2];
+    auto dest = ByteWriter(wrapMemory(buffer));
+    ASSERT_TRUE(otherServer.read(dest).isOk());
+    ASSERT_EQ(0, memcmp(buffer, "ok", 2));
+
+    tickets.clear();
+}
+
+
+TEST(TestAsyncServer, testConnectionsAreRejectedWhenOutOfDescriptors) {
+    EventLoop iocontext;
+
+    struct Session {
+        StreamSocket                socket;
+        AsyncServer::SessionTicket  ticket;
+    };
+
+    std::vector<Session> sessions;
+    AsyncServer server(iocontext, [&sessions](StreamSocket&& socket, AsyncServer::SessionTicket&& ticket) {
+        sessions.push_back({std::move(socket), std::move(ticket)});
+    });
+    ASSERT_TRUE(server.startListen(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+
+    // Connections wait in the listen queue until the server gets to run
+    std::vector<StreamSocket> clients;
+    clients.reserve(5);
+    for (int i = 0; i < 4; ++i) {
+        auto& client = clients.emplace_back(createTCPSocket(iocontext));
+        ASSERT_TRUE(client.connect(server.getLocalEndpoint()).isOk());
+    }
+
+    byte buffers[2][1];
+    auto firstReader = ByteWriter(wrapMemory(buffers[0]));
+    auto secondReader = ByteWriter(wrapMemory(buffers[1]));
+    int rejected = 0;
+    clients[2].asyncRead(firstReader)
+            .onError([&rejected](Error&&) {
+                rejected += 1;
+            });
+    clients[3].asyncRead(secondReader)
+            .onError([&rejected](Error&&) {
+                rejected += 1;
+            });
+
+    // Only two more connections fit
+    DescriptorLimit limit;
+    ASSERT_TRUE(limit.exhaust());
+    limit.release(2);
+
+    iocontext.runFor(300);
+    ASSERT_EQ(2U, sessions.size());
+
+    // The rest are turned away rather than left to wake the acceptor up over and over
+    ASSERT_EQ(2, rejected);
+
+    // Accepting resumes once descriptors are available again
+    sessions.clear();
+    limit.restore();
+
+    auto& lateClient = clients.emplace_back(createTCPSocket(iocontext));
+    ASSERT_TRUE(lateClient.connect(server.getLocalEndpoint()).isOk());
+
+    iocontext.runFor(300);
+    ASSERT_EQ(1U, sessions.size());
+    ASSERT_EQ(3U, server.getSessionCounters().accepted);
+}
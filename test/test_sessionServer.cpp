@@ -0,0 +1,164 @@
+/*
+*  Copyright (C) Ivan Ryabov - All Rights Reserved
+*
+*  Unauthorized copying of this file, via any medium is strictly prohibited.
+*  Proprietary and confidential.
+*
+*  Written by Ivan Ryabov <abbyssoul@gmail.com>
+*/
+/*******************************************************************************
+ * libcadence Unit Test Suit
+ * @file: test/test_sessionServer.cpp
+ *******************************************************************************/
+#include <cadence/sessionServer.hpp>  // Class being tested
+
+#include <solace/output_utils.hpp>
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+
+using namespace Solace;
+using namespace cadence;
+using namespace cadence::async;
+
+
+namespace {
+
+/**
+ * Session that closes once it has received a byte from the client.
+ */
+class ClosingSession {
+public:
+
+    static int nbAlive;
+
+    ~ClosingSession() {
+        nbAlive -= 1;
+    }
+
+    ClosingSession(StreamSocket&& socket, SessionServer<ClosingSession>::Handle handle)
+        : _socket(std::move(socket))
+        , _handle(handle)
+    {
+        nbAlive += 1;
+    }
+
+    void start() {
+        _socket.asyncRead(_writer)
+                .then([this]() {
+                    _handle.close();
+                });
+    }
+
+private:
+    StreamSocket                            _socket;
+    SessionServer<ClosingSession>::Handle   _handle;
+    byte                                    _buffer[1];
+    ByteWriter                              _writer{wrapMemory(_buffer)};
+};
+
+int ClosingSession::nbAlive = 0;
+
+
+void connectClients(std::vector<StreamSocket>& clients, EventLoop& iocontext, NetworkEndpoint const& endpoint,
+                    int nbClients) {
+    for (int i = 0; i < nbClients; ++i) {
+        auto& client = clients.emplace_back(createTCPSocket(iocontext));
+        ASSERT_TRUE(client.connect(endpoint).isOk());
+    }
+}
+
+void closeSessions(std::vector<StreamSocket>& clients) {
+    char const message[] = "x";
+    for (auto& client : clients) {
+        auto src = ByteReader(wrapMemory(message, 1));
+        ASSERT_TRUE(client.write(src).isOk());
+    }
+}
+
+}  // namespace
+
+
+TEST(TestSessionServer, testSessionsAreRecycled) {
+    EventLoop iocontext;
+
+    SessionServer<ClosingSession> server(iocontext);
+    ASSERT_TRUE(server.startListen(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+
+    std::vector<StreamSocket> clients;
+    connectClients(clients, iocontext, server.getLocalEndpoint(), 3);
+
+    iocontext.runFor(300);
+    ASSERT_EQ(3, ClosingSession::nbAlive);
+    ASSERT_EQ(3U, server.getActiveSessions());
+
+    int nbVisited = 0;
+    server.forEachSession([&nbVisited](ClosingSession&) { nbVisited += 1; });
+    ASSERT_EQ(3, nbVisited);
+
+    closeSessions(clients);
+    iocontext.runFor(300);
+    ASSERT_EQ(0, ClosingSession::nbAlive);
+    ASSERT_EQ(0U, server.getActiveSessions());
+
+    // New sessions reuse nodes of the closed ones
+    auto const capacity = server.getCapacity();
+    clients.clear();
+    connectClients(clients, iocontext, server.getLocalEndpoint(), 3);
+
+    iocontext.runFor(300);
+    ASSERT_EQ(3U, server.getActiveSessions());
+    ASSERT_EQ(capacity, server.getCapacity());
+
+    server.stop();
+    closeSessions(clients);
+    iocontext.runFor(300);
+    ASSERT_EQ(0, ClosingSession::nbAlive);
+}
+
+
+TEST(TestSessionServer, testAcceptingPausesAtSessionLimit) {
+    EventLoop iocontext;
+
+    SessionServer<ClosingSession> server(iocontext);
+    server.setMaxSessions(1);
+    ASSERT_TRUE(server.startListen(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+
+    std::vector<StreamSocket> clients;
+    connectClients(clients, iocontext, server.getLocalEndpoint(), 2);
+
+    iocontext.runFor(300);
+    ASSERT_EQ(1U, server.getActiveSessions());
+
+    // Both clients send: the first session closes, making room for the second one
+    closeSessions(clients);
+    iocontext.runFor(300);
+    ASSERT_EQ(0U, server.getActiveSessions());
+    ASSERT_EQ(0, ClosingSession::nbAlive);
+
+    server.stop();
+}
+
+
+TEST(TestSessionServer, testSessionsOutliveServer) {
+    EventLoop iocontext;
+
+    std::vector<StreamSocket> clients;
+    {
+        SessionServer<ClosingSession> server(iocontext);
+        ASSERT_TRUE(server.startListen(IPEndpoint{IPAddress::loopback(), 0}).isOk());
+
+        connectClients(clients, iocontext, server.getLocalEndpoint(), 2);
+        iocontext.runFor(300);
+        ASSERT_EQ(2U, server.getActiveSessions());
+    }
+
+    // Sessions with reads in flight are not destroyed with the server: they close on their own
+    ASSERT_EQ(2, ClosingSession::nbAlive);
+
+    closeSessions(clients);
+    iocontext.runFor(300);
+    ASSERT_EQ(0, ClosingSession::nbAlive);
+}